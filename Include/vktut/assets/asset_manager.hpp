@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <vktut/assets/mesh.hpp>
+#include <vktut/geometry/mesh.hpp>
+#include <vktut/utilities/sha256.hpp>
+#include <vktut/utilities/thread_pool.hpp>
+#include <vktut/vulkan/buffer_and_memory.hpp>
+#include <vktut/vulkan/device_context.hpp>
+#include <vktut/vulkan/texture.hpp>
+
+namespace vktut::assets
+{
+// hands out shared, gpu resident meshes and textures. assets are keyed by the
+// size and SHA-256 of their file's bytes, so the same file under two paths, or
+// two copies of it, is uploaded once. the manager only keeps weak references:
+// the last handle to go releases the gpu resources, and it must not go while
+// the gpu may still read them.
+struct asset_manager
+{
+public:
+  struct content_hash
+  {
+    std::uint64_t size;
+    utilities::sha256::digest digest;
+
+    bool operator==(const content_hash& other) const = default;
+  };
+  using mesh_handle = std::shared_ptr<const mesh>;
+  using texture_handle = std::shared_ptr<const vulkan::texture>;
+
+  // how the owner of the device creates and destroys the gpu side
+  struct backend
+  {
+    std::function<vulkan::texture(std::span<const std::byte> file_bytes)>
+        create_texture;
+    std::function<void(const vulkan::texture&)> destroy_texture;
+    std::function<vulkan::buffer_and_memory(std::span<const std::byte> data,
+                                            VkBufferUsageFlags usage)>
+        upload_buffer;
+    std::function<void(const vulkan::buffer_and_memory&)> destroy_buffer;
+  };
+
+private:
+  struct content_hash_hash
+  {
+    std::size_t operator()(const content_hash& hash) const;
+  };
+
+  std::shared_ptr<const backend> m_backend;
+  std::size_t m_max_lod_levels;
+  utilities::thread_pool* m_pool;
+
+  // held through loads, so two threads asking for the same asset never load
+  // it twice
+  std::mutex m_mutex;
+  // what each path held when it was loaded, saves reading it again
+  std::unordered_map<std::string, content_hash> m_path_hashes;
+  // expired entries are swept out by prune()
+  std::unordered_map<content_hash,
+                     std::weak_ptr<const mesh>,
+                     content_hash_hash>
+      m_meshes;
+  std::unordered_map<content_hash,
+                     std::weak_ptr<const vulkan::texture>,
+                     content_hash_hash>
+      m_textures;
+
+public:
+  // `pool` parses large meshes in parallel when there is one
+  asset_manager(backend backend,
+                std::size_t max_lod_levels,
+                utilities::thread_pool* pool = nullptr);
+
+  // obj or glb files, split into meshlets and simplified into levels of
+  // detail. a glb file that is already in the vertex layout is uploaded
+  // straight from its bytes instead, and drawn whole
+  mesh_handle load_mesh(const std::string& path);
+  mesh_handle load_mesh(std::span<const std::byte> file_bytes);
+  texture_handle load_texture(const std::string& path);
+  texture_handle load_texture(std::span<const std::byte> file_bytes);
+
+  // null unless an asset with these bytes is alive
+  mesh_handle find_mesh(const content_hash& hash);
+  texture_handle find_texture(const content_hash& hash);
+
+  static content_hash hash(std::span<const std::byte> bytes);
+  // creates everything through a shared device context, which it keeps alive
+  // as long as any of its assets
+  static backend context_backend(
+      std::shared_ptr<vulkan::device_context> context);
+
+private:
+  // drops the entries of released assets, and the paths that led to them
+  void prune();
+  mesh_handle load_mesh(const content_hash& hash,
+                        std::span<const std::byte> file_bytes);
+  texture_handle load_texture(const content_hash& hash,
+                              std::span<const std::byte> file_bytes);
+  [[nodiscard]] mesh load_glb(std::span<const std::byte> file_bytes) const;
+  [[nodiscard]] mesh build_mesh(geometry::mesh parsed) const;
+};
+}  // namespace vktut::assets
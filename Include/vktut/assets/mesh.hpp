@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vktut/geometry/lod_chain.hpp>
+#include <vktut/shaders/meshlet.hpp>
+#include <vktut/shaders/vertex.hpp>
+#include <vktut/vulkan/buffer_and_memory.hpp>
+
+namespace vktut::assets
+{
+// a mesh ready to draw, with the cpu copy its gpu buffers were filled from.
+// meshes uploaded straight from their file keep no copy and have no meshlets
+struct mesh
+{
+  std::vector<shaders::vertex> vertices;
+  // the full detail level in meshlet order, the coarser levels behind it
+  std::vector<std::uint32_t> indices;
+  std::vector<shaders::meshlet> meshlets;
+  geometry::lod_chain lod_chain;
+  vulkan::buffer_and_memory vertex_buffer;
+  vulkan::buffer_and_memory index_buffer;
+};
+}  // namespace vktut::assets
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+#include <glm/glm.hpp>
+#include <vktut/geometry/mesh.hpp>
+#include <vktut/utilities/json.hpp>
+
+namespace vktut::geometry
+{
+// a binary glTF 2.0 file. the binary chunk is never copied, everything read
+// from it points into the bytes the file was opened from, which have to stay
+// alive as long as the glb_file. buffers in other files, sparse accessors,
+// node transforms and materials are not supported
+struct glb_file
+{
+public:
+  // a primitive stored exactly as the renderer draws it
+  struct packed_primitive
+  {
+    // interleaved shaders::vertex
+    std::span<const std::byte> vertices;
+    // 32 bit indices of a triangle list
+    std::span<const std::byte> indices;
+    std::uint32_t vertex_count;
+    std::uint32_t index_count;
+    glm::vec3 min;
+    glm::vec3 max;
+  };
+
+private:
+  struct accessor_view
+  {
+    std::span<const std::byte> bytes;
+    std::size_t count;
+    std::size_t stride;
+    std::uint32_t component_type;
+    std::size_t component_count;
+  };
+
+  utilities::json m_document;
+  std::span<const std::byte> m_binary;
+
+public:
+  explicit glb_file(std::span<const std::byte> bytes);
+
+  static bool is_glb(std::span<const std::byte> bytes);
+
+  // set when the file is a single triangle list whose POSITION, COLOR_0 and
+  // TEXCOORD_0 share one buffer view in the shaders::vertex layout, indexed
+  // with 32 bit indices that all lie within the vertices
+  [[nodiscard]] std::optional<packed_primitive> packed() const;
+
+  // every triangle list of every mesh, converted and appended into one mesh
+  [[nodiscard]] mesh to_mesh() const;
+
+private:
+  [[nodiscard]] accessor_view accessor(std::uint32_t index) const;
+  static std::size_t component_size(std::uint32_t component_type);
+  static std::size_t component_count(const std::string& type);
+  static float read_float(const accessor_view& view,
+                          std::size_t element,
+                          std::size_t component);
+  static std::uint32_t read_index(const accessor_view& view,
+                                  std::size_t element);
+  static glm::vec3 to_vec3(const utilities::json& array);
+  static std::uint32_t read_u32(std::span<const std::byte> bytes,
+                                std::size_t offset);
+};
+}  // namespace vktut::geometry
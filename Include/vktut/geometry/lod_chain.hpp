@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vktut/shaders/vertex.hpp>
+
+namespace vktut::geometry
+{
+struct lod_level
+{
+  std::uint32_t first_index;
+  std::uint32_t index_count;
+  // how far, in model units, this level may deviate from the full mesh
+  float error;
+};
+
+// levels of detail of one mesh, all living in the same index buffer and
+// sharing its vertices. level 0 is the full mesh.
+struct lod_chain
+{
+  std::vector<lod_level> levels;
+  glm::vec3 center;
+  float radius;
+
+  // simplifies the mesh in `indices` over and over, appending every new level
+  // to `indices` after the ones before it
+  static lod_chain build(std::span<const shaders::vertex> vertices,
+                         std::vector<std::uint32_t>& indices,
+                         std::size_t max_levels);
+
+  // pixels_per_unit is how large one model unit appears on screen at the
+  // mesh's distance. picks the coarsest level whose error stays below
+  // pixel_threshold pixels.
+  [[nodiscard]] const lod_level& select(float pixels_per_unit,
+                                        float pixel_threshold) const;
+};
+}  // namespace vktut::geometry
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <vktut/shaders/vertex.hpp>
+#include <vktut/utilities/thread_pool.hpp>
+
+namespace vktut::geometry
+{
+// an indexed triangle list with deduplicated vertices
+struct mesh
+{
+  std::vector<shaders::vertex> vertices;
+  std::vector<std::uint32_t> indices;
+
+  // every shape in the file ends up in one mesh, vertex colors are white.
+  // large files are parsed in parallel on `pool` when there is one
+  static mesh load_obj(std::string_view path,
+                       utilities::thread_pool* pool = nullptr);
+  static mesh load_obj(std::span<const std::byte> bytes,
+                       utilities::thread_pool* pool = nullptr);
+};
+}  // namespace vktut::geometry
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vktut/shaders/vertex.hpp>
+
+namespace vktut::geometry
+{
+// quadric error metric edge collapse over an index buffer. vertices are never
+// moved or created, a collapse just redirects one endpoint onto the other, so
+// every level of detail can share the original vertex buffer.
+struct mesh_simplifier
+{
+private:
+  // symmetric 4x4 matrix summing squared distances to a set of planes
+  struct quadric
+  {
+    double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+    // total area of the planes, turns the sum into a mean squared distance
+    double weight;
+
+    static quadric from_plane(const glm::dvec3& normal,
+                              double distance,
+                              double weight);
+    quadric& operator+=(const quadric& other);
+    [[nodiscard]] double evaluate(const glm::dvec3& point) const;
+  };
+
+  struct collapse
+  {
+    std::uint32_t from;
+    std::uint32_t to;
+    double error;
+  };
+
+  std::vector<glm::vec3> m_positions;
+  // vertices split along a uv or color seam share a position. moving one
+  // copy would tear the seam open, so they are never collapsed.
+  std::vector<bool> m_seam;
+
+public:
+  explicit mesh_simplifier(std::span<const shaders::vertex> vertices);
+
+  // collapses edges until at most target_index_count indices are left or the
+  // next collapse would move the surface by more than max_error, in model
+  // units. the largest error actually introduced is written to result_error.
+  [[nodiscard]] std::vector<std::uint32_t> simplify(
+      std::span<const std::uint32_t> indices,
+      std::size_t target_index_count,
+      float max_error,
+      float& result_error) const;
+
+private:
+  [[nodiscard]] bool flips_triangle(
+      const std::vector<std::uint32_t>& indices,
+      std::span<const std::uint32_t> adjacent_triangles,
+      std::uint32_t from,
+      std::uint32_t to) const;
+};
+}  // namespace vktut::geometry
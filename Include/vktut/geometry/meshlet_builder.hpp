@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <vktut/shaders/meshlet.hpp>
+#include <vktut/shaders/vertex.hpp>
+
+namespace vktut::geometry
+{
+// splits a triangle list into small spatially coherent clusters that can be
+// culled as a whole. there are no mesh shaders here, so a meshlet is a
+// contiguous range of the index buffer drawn with one indirect command.
+struct meshlet_builder
+{
+  static constexpr std::size_t max_vertices = 64;
+  static constexpr std::size_t max_triangles = 124;
+
+  // reorders the triangles in `indices` so every meshlet's triangles are
+  // adjacent, and returns the meshlets with their bounds
+  static std::vector<shaders::meshlet> build(
+      std::span<const shaders::vertex> vertices,
+      std::span<std::uint32_t> indices);
+
+private:
+  static shaders::meshlet bounds(std::span<const shaders::vertex> vertices,
+                                 std::span<const std::uint32_t> indices);
+};
+}  // namespace vktut::geometry
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <vktut/utilities/thread_pool.hpp>
+
+namespace vktut::geometry
+{
+// reads the positions, texture coordinates and faces of a Wavefront OBJ file
+// straight out of its bytes. normals, groups and materials are skipped. large
+// files are cut at line breaks into chunks that are parsed in parallel
+struct obj_parser
+{
+public:
+  static constexpr std::size_t chunk_size = std::size_t {4} << 20;
+  static constexpr std::uint32_t no_tex_coord = ~std::uint32_t {0};
+
+  // one triangle corner, indices are zero based into the arrays below
+  struct corner
+  {
+    std::uint32_t position;
+    std::uint32_t tex_coord;
+  };
+
+  // polygons are fanned into triangles, three corners each
+  struct result
+  {
+    std::vector<float> positions;
+    std::vector<float> tex_coords;
+    std::vector<corner> corners;
+  };
+
+private:
+  // chunk bytes per element the chunk vectors reserve for. a scan with as
+  // many v as vt lines and two faces per vertex takes about 45, 70 and 23,
+  // the generous ratios leave room for files with fewer faces
+  static constexpr std::size_t bytes_per_position_float = 16;
+  static constexpr std::size_t bytes_per_tex_coord_float = 32;
+  static constexpr std::size_t bytes_per_corner = 24;
+
+  // indices are kept as written, negative ones count back from the element
+  // count at their face, which is only known once the chunks before are
+  struct face
+  {
+    std::uint32_t corner_count;
+    std::uint32_t positions_before;
+    std::uint32_t tex_coords_before;
+  };
+
+  struct written_corner
+  {
+    std::int64_t position;
+    // 0 where the corner has no texture coordinate
+    std::int64_t tex_coord;
+  };
+
+  struct chunk
+  {
+    std::vector<float> positions;
+    std::vector<float> tex_coords;
+    std::vector<written_corner> corners;
+    std::vector<face> faces;
+    std::size_t triangulated_corner_count = 0;
+    // filled in once every chunk is parsed
+    std::uint32_t positions_offset = 0;
+    std::uint32_t tex_coords_offset = 0;
+    std::size_t corners_offset = 0;
+  };
+
+public:
+  static result parse(std::span<const std::byte> bytes,
+                      utilities::thread_pool* pool = nullptr);
+
+private:
+  template<typename Job>
+  static void for_each_chunk(std::size_t chunk_count,
+                             utilities::thread_pool* pool,
+                             const Job& job);
+  static void parse_chunk(const char* first, const char* last, chunk& out);
+  static void resolve_chunk(const chunk& part,
+                            std::uint32_t position_count,
+                            std::uint32_t tex_coord_count,
+                            corner* out);
+  static const char* find_line_end(const char* first, const char* last);
+  static bool is_blank(char c);
+  static const char* skip_blanks(const char* first, const char* last);
+  static const char* parse_float(const char* first,
+                                 const char* last,
+                                 float& value);
+  static const char* parse_index(const char* first,
+                                 const char* last,
+                                 std::int64_t& value);
+  static std::uint32_t resolve(std::int64_t index,
+                               std::uint32_t before,
+                               std::uint32_t offset,
+                               std::uint32_t count);
+};
+}  // namespace vktut::geometry
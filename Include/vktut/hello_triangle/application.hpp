@@ -1,24 +1,67 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <config.hpp>
+#include <glm/glm.hpp>
+#include <vktut/assets/asset_manager.hpp>
+#include <vktut/geometry/lod_chain.hpp>
+#include <vktut/rendering/frame_capture.hpp>
+#include <vktut/rendering/quality_governor.hpp>
+#include <vktut/rendering/resolution_scaler.hpp>
+#include <vktut/rendering/video_stream.hpp>
+#include <vktut/scene/frustum_culler.hpp>
+#include <vktut/scene/scene_graph.hpp>
+#include <vktut/shaders/material.hpp>
+#include <vktut/shaders/meshlet.hpp>
+#include <vktut/shaders/uniform_buffer_object.hpp>
 #include <vktut/shaders/vertex.hpp>
+#include <vktut/utilities/spsc_queue.hpp>
+#include <vktut/utilities/thread_pool.hpp>
+#include <vktut/utilities/triple_buffer.hpp>
+#include <vktut/vulkan/async_compute.hpp>
 #include <vktut/vulkan/buffer_and_memory.hpp>
+#include <vktut/vulkan/deletion_queue.hpp>
+#include <vktut/vulkan/descriptor_allocator.hpp>
+#include <vktut/vulkan/descriptor_layout_cache.hpp>
 #include <vktut/vulkan/image_and_memory.hpp>
 #include <vktut/vulkan/instance.hpp>
 #include <vktut/vulkan/swap_chain_support_details.hpp>
+#include <vktut/vulkan/texture.hpp>
 
 namespace vktut::hello_triangle
 {
 struct application
 {
 private:
+  // what the main thread hands the render thread every step
+  struct simulation_state
+  {
+    float time;
+    glm::vec3 camera_position;
+    // when the input behind this state was read
+    std::chrono::high_resolution_clock::time_point sampled_at;
+  };
+
+  // glfw callbacks run on the main thread, the render thread acts on them
+  struct window_event
+  {
+    int key;
+  };
+
   GLFWwindow* m_window;
   std::unique_ptr<vktut::vulkan::instance> m_instance;
   VkDebugUtilsMessengerEXT m_debug_messenger;
@@ -28,48 +71,162 @@ private:
   VkSurfaceKHR m_surface;
   VkQueue m_present_queue;
   VkQueue m_transfer_queue;
+  // only when the device has a second queue that can run compute work
+  std::unique_ptr<vulkan::async_compute> m_async_compute;
   VkSwapchainKHR m_swap_chain;
   std::vector<VkImage> m_swap_chain_images;
   VkFormat m_swap_chain_image_format;
   VkExtent2D m_swap_chain_extent;
   std::vector<VkImageView> m_swap_chain_image_views;
   VkRenderPass m_render_pass;
+  std::unique_ptr<vulkan::descriptor_layout_cache> m_descriptor_layout_cache;
   VkDescriptorSetLayout m_descriptor_set_layout;
+  VkDescriptorUpdateTemplate m_descriptor_update_template;
   VkPipelineLayout m_pipeline_layout;
   VkPipeline m_graphics_pipeline;
-  std::vector<VkFramebuffer> m_swap_chain_framebuffers;
   VkCommandPool m_command_pool;
   VkCommandPool m_transfer_command_pool;
   std::vector<VkCommandBuffer> m_command_buffers;
   std::vector<VkCommandBuffer> m_transfer_command_buffers;
+  // with async compute the pre-pass is submitted on its own, so culling can
+  // start while the graphics queue waits for it
+  std::vector<VkCommandBuffer> m_prepass_command_buffers;
   std::vector<VkSemaphore> m_image_available_semaphores;
   std::vector<VkSemaphore> m_render_finished_semaphores;
   std::vector<VkFence> m_in_flight_fences;
   std::vector<VkFence> m_images_in_flight;
   std::size_t m_current_frame = 0;
+  // objects replaced while frames are in flight, destroyed once those are done
+  vulkan::deletion_queue m_deletion_queue;
+  // which compute passes of the frame being recorded went to m_async_compute
+  bool m_async_culling = false;
+  bool m_async_post_processing = false;
+  // signaled by the last frame's yuv conversion, which still reads the scene
+  // image the next main pass renders into
+  VkSemaphore m_post_processing_done = nullptr;
   bool m_framebuffer_resized = false;
-  std::vector<shaders::vertex> m_vertices;
-  std::vector<std::uint32_t> m_indices;
-  VkBuffer m_vertex_buffer;
-  VkDeviceMemory m_vertex_buffer_memory;
-  VkBuffer m_index_buffer;
-  VkDeviceMemory m_index_buffer_memory;
+  // render thread only, copied from m_latest_framebuffer_size since the main
+  // thread owns the window
+  int m_framebuffer_width = 0;
+  int m_framebuffer_height = 0;
+  // the last size glfw reported, width in the high half; resizes only need
+  // the newest one, so they skip m_window_events and can never be dropped
+  std::atomic<std::uint64_t> m_latest_framebuffer_size = 0;
+  utilities::triple_buffer<simulation_state> m_simulation;
+  utilities::spsc_queue<window_event, 256> m_window_events;
+  std::atomic<bool> m_rendering = false;
+  std::exception_ptr m_render_error;
+  std::unique_ptr<assets::asset_manager> m_assets;
+  // its meshlets are culled on the gpu every frame
+  assets::asset_manager::mesh_handle m_model;
+  VkBuffer m_meshlet_buffer;
+  VkDeviceMemory m_meshlet_buffer_memory;
+  // one draw list per frame in flight, rewritten by the culling pass
+  std::vector<vulkan::buffer_and_memory> m_draw_command_buffers;
+  std::vector<vulkan::buffer_and_memory> m_draw_count_buffers;
+  VkDescriptorSetLayout m_cull_set_layout;
+  VkDescriptorUpdateTemplate m_cull_update_template;
+  VkPipelineLayout m_cull_pipeline_layout;
+  VkPipeline m_cull_pipeline;
+  bool m_meshlet_culling_supported = false;
+  std::uint32_t m_max_draw_indirect_count = 0;
   std::vector<VkBuffer> m_uniform_buffers;
   std::vector<VkDeviceMemory> m_uniform_buffers_memory;
-  VkDescriptorPool m_descriptor_pool;
-  std::vector<VkDescriptorSet> m_descriptor_sets;
-  std::uint32_t m_mip_levels;
-  VkImage m_texture_image;
-  VkDeviceMemory m_texture_image_memory;
-  VkImageView m_texture_image_view;
+  // persistently mapped, the camera is latched into them right before submit
+  std::vector<shaders::uniform_buffer_object*> m_uniform_data;
+  // when the state the frame was prepared from was sampled, and the input age
+  // at submit with and without the late latch, summed until the next report
+  std::chrono::high_resolution_clock::time_point m_frame_sampled_at;
+  // how much newer the latched camera was than m_frame_sampled_at last frame
+  std::chrono::high_resolution_clock::duration m_latch_lag {};
+  // how far the camera can move before the latch, the cpu cull and level
+  // selection grow the bounds by it
+  float m_camera_drift = 0.0F;
+  double m_early_latency_ms = 0.0;
+  double m_latched_latency_ms = 0.0;
+  std::size_t m_latched_frames = 0;
+  // one per frame in flight, reset once that frame's fence has signaled
+  std::vector<vulkan::descriptor_allocator> m_frame_descriptor_allocators;
+  scene::scene_graph m_scene;
+  // instance 0 of every draw, meshlet draws included
+  scene::scene_graph::node m_model_node = 0;
+  // world matrices of the scene for the vertex shader, one persistently mapped
+  // copy per frame in flight that only receives the nodes that changed
+  std::vector<vulkan::buffer_and_memory> m_instance_buffers;
+  std::vector<std::span<std::byte>> m_instance_data;
+  std::vector<std::uint64_t> m_instance_generations;
+  // bounding spheres of the scene nodes, objects share the nodes' indices
+  scene::frustum_culler m_frustum_culler;
+  // this frame's draws, as instance indices
+  std::vector<scene::frustum_culler::object> m_visible_objects;
+  std::unique_ptr<utilities::thread_pool> m_jobs;
+  glm::mat4 m_model_transform;
+  glm::mat4 m_view_projection;
+  glm::vec3 m_camera_position;
+  std::vector<assets::asset_manager::texture_handle> m_textures;
   VkSampler m_texture_sampler;
-  VkImage m_depth_image;
-  VkDeviceMemory m_depth_image_memory;
+  VkDescriptorSetLayout m_bindless_set_layout;
+  VkDescriptorPool m_bindless_descriptor_pool;
+  VkDescriptorSet m_bindless_descriptor_set;
+  std::uint32_t m_bindless_capacity = 0;
+  vulkan::image_and_memory m_depth_image;
   VkImageView m_depth_image_view;
-  VkImage m_color_image;
-  VkDeviceMemory m_color_image_memory;
+  // depth-only pass that settles visibility before anything is shaded, the
+  // main pass then only runs its fragment shader for the surviving samples
+  bool m_depth_prepass = depth_prepass_enabled;
+  VkRenderPass m_depth_prepass_render_pass;
+  VkFramebuffer m_depth_prepass_framebuffer;
+  VkPipeline m_depth_prepass_pipeline;
+  // farthest pre-pass depth per block of pixels, doubling in size every mip.
+  // only built when the depth buffer can be sampled
+  bool m_depth_pyramid_supported = false;
+  vulkan::image_and_memory m_depth_pyramid;
+  VkImageView m_depth_pyramid_view;
+  std::vector<VkImageView> m_depth_pyramid_level_views;
+  // still UNDEFINED, the next build moves it to GENERAL. resizes recreate the
+  // pyramid without a submission of their own that would have to be waited on
+  bool m_depth_pyramid_undefined = false;
+  VkSampler m_depth_pyramid_sampler;
+  VkDescriptorSetLayout m_depth_pyramid_set_layout;
+  VkDescriptorUpdateTemplate m_depth_pyramid_update_template;
+  VkPipelineLayout m_depth_pyramid_pipeline_layout;
+  VkPipeline m_depth_pyramid_pipeline;
+  // reads every sample of a multisampled depth buffer into the first level
+  VkPipeline m_depth_pyramid_multisampled_pipeline;
+  vulkan::image_and_memory m_color_image;
   VkImageView m_color_image_view;
+  bool m_attachment_report_pending = false;
   VkSampleCountFlagBits m_msaa_samples = VK_SAMPLE_COUNT_1_BIT;
+  bool m_sample_rate_shading_supported = false;
+  std::unique_ptr<rendering::quality_governor> m_quality_governor;
+  // the scene renders into the top left m_render_extent of this image, which
+  // is then scaled up onto the swap chain image
+  vulkan::image_and_memory m_scene_image;
+  VkImageView m_scene_image_view;
+  VkFramebuffer m_scene_framebuffer;
+  VkExtent2D m_render_extent;
+  bool m_scene_blit_supported = false;
+  // set when the surface can't be a transfer destination. the scene then
+  // renders straight into the swap chain images at full resolution, and
+  // capture and streaming are unavailable
+  bool m_render_to_swap_chain = false;
+  std::vector<VkFramebuffer> m_swap_chain_framebuffers;
+  std::unique_ptr<rendering::resolution_scaler> m_resolution_scaler;
+  VkQueryPool m_timestamp_query_pool;
+  std::vector<bool> m_timestamps_written;
+  float m_timestamp_period_ns = 1;
+  std::uint64_t m_timestamp_mask = 0;
+  // null when the swap chain format can't be captured
+  std::unique_ptr<rendering::frame_capture> m_frame_capture;
+  bool m_capturing = false;
+  // null unless stream_to() was called
+  std::unique_ptr<rendering::video_stream> m_video_stream;
+  VkSampler m_yuv_sampler;
+  VkDescriptorSetLayout m_yuv_set_layout;
+  VkDescriptorUpdateTemplate m_yuv_update_template;
+  VkPipelineLayout m_yuv_pipeline_layout;
+  VkPipeline m_yuv_pipeline;
+  shaders::material m_material;
 
   static constexpr std::uint32_t width = 800;
   static constexpr std::uint32_t height = 600;
@@ -86,6 +243,36 @@ private:
       VK_KHR_SWAPCHAIN_EXTENSION_NAME,
   };
   static constexpr int max_frames_in_flight = 2;
+  static constexpr float field_of_view_degrees = 45.0F;
+  static constexpr std::size_t max_lod_levels = 5;
+  // a level is used once its error covers less than this many pixels
+  static constexpr float lod_pixel_threshold = 1.0F;
+  static constexpr bool depth_prepass_enabled = true;
+  // a little slack over 60 Hz, so waiting on vsync alone never trips it
+  static constexpr float frame_budget_ms = 20.0F;
+  // the gpu's share of the budget that dynamic resolution aims for
+  static constexpr float gpu_budget_ms = 14.0F;
+  static constexpr float min_render_scale = 0.5F;
+  static constexpr float max_render_scale = 1.0F;
+  static constexpr std::uint32_t max_bindless_textures = 4096;
+  // capturing every frame is toggled with the C key, files land in the
+  // working directory
+  static constexpr auto capture_format = rendering::capture_format::png;
+  // frames in flight plus a few waiting on the encoders
+  static constexpr std::size_t capture_slots = 6;
+  static constexpr std::size_t capture_encoders = 2;
+  // only written into the y4m header, frames go out as fast as they render
+  static constexpr std::uint32_t stream_frame_rate = 60;
+  static constexpr std::size_t stream_slots = 4;
+  // the passes of m_async_compute
+  static constexpr std::size_t culling_pass = 0;
+  static constexpr std::size_t post_processing_pass = 1;
+  static constexpr std::size_t compute_pass_count = 2;
+  // how often the main thread publishes simulation state, independent of how
+  // fast frames render
+  static constexpr double simulation_step_seconds = 1.0 / 240.0;
+  // how fast the arrow keys orbit the camera around the model
+  static constexpr float camera_turn_degrees_per_second = 90.0F;
 
 #ifdef NDEBUG
   static constexpr bool validation_layers_enabled = false;
@@ -98,9 +285,12 @@ public:
   ~application();
   application(const application&) = delete;
   application& operator=(const application&) = delete;
-  application(application&&) = default;
-  application& operator=(application&&) = default;
+  application(application&&) = delete;
+  application& operator=(application&&) = delete;
 
+  // streams every frame converted to yuv to `path`, "-" being stdout. the
+  // stream keeps the size the window has when it starts.
+  void stream_to(const std::string& path, rendering::video_format format);
   void run();
 
 private:
@@ -111,24 +301,49 @@ private:
   void create_render_pass();
   bool check_validation_layers_support();
   void main_loop();
+  void render_loop();
+  void process_window_events();
   void cleanup();
   void load_model();
   void create_descriptor_set_layout();
   void create_graphics_pipeline();
-  void create_vertex_buffer();
-  void create_index_buffer();
+  void create_asset_manager();
+  void create_meshlet_buffers();
+  void create_cull_pipeline();
+  void record_meshlet_culling(VkCommandBuffer command_buffer,
+                              std::uint32_t image_index,
+                              bool occlusion);
+  void create_depth_prepass_render_pass();
+  void create_depth_prepass_pipeline();
+  void record_depth_prepass(VkCommandBuffer command_buffer,
+                            const geometry::lod_level& lod,
+                            VkDescriptorSet frame_descriptor_set);
+  void create_depth_pyramid();
+  void create_depth_pyramid_pipelines();
+  void record_depth_pyramid(VkCommandBuffer command_buffer);
+  void record_async_culling(VkCommandBuffer prepass_command_buffer,
+                            VkCommandBuffer command_buffer,
+                            std::uint32_t image_index);
+  void set_render_viewport(VkCommandBuffer command_buffer);
+  VkPipeline create_compute_pipeline(std::span<const std::uint32_t> code,
+                                     VkPipelineLayout layout);
   void create_uniform_buffers();
-  void create_descriptor_pool();
-  void create_descriptor_sets();
-  void create_texture_image();
-  void create_texture_image_view();
+  void create_instance_buffers();
+  void create_descriptor_update_template();
+  void create_descriptor_allocators();
+  VkDescriptorSet allocate_frame_descriptor_set(std::uint32_t image_index);
+  void create_texture_images();
+  vulkan::texture load_texture(std::span<const std::byte> file_bytes);
   void create_texture_sampler();
+  void create_bindless_descriptors();
   void create_depth_resources();
   void create_color_resources();
+  void report_attachment_memory();
   VkImageView create_image_view(VkImage image,
                                 VkFormat format,
                                 VkImageAspectFlags aspect_flags,
-                                std::uint32_t mip_levels);
+                                std::uint32_t mip_levels,
+                                std::uint32_t base_mip_level = 0);
   vulkan::image_and_memory create_image(std::uint32_t width,
                                         std::uint32_t height,
                                         std::uint32_t mip_levels,
@@ -140,7 +355,9 @@ private:
   vulkan::buffer_and_memory create_buffer(VkDeviceSize size,
                                           VkBufferUsageFlags usage,
                                           VkMemoryPropertyFlags properties);
-  VkShaderModule create_shader_module(const std::vector<char>& code);
+  vulkan::buffer_and_memory upload_buffer(std::span<const std::byte> data,
+                                          VkBufferUsageFlags usage);
+  VkShaderModule create_shader_module(std::span<const std::uint32_t> code);
   VkCommandBuffer begin_single_time_commands(VkCommandPool command_pool);
   void copy_buffer(VkBuffer src_buffer,
                    VkBuffer dst_buffer,
@@ -171,19 +388,39 @@ private:
   void create_logical_device();
   void create_surface();
   void create_framebuffers();
+  void create_scene_target();
+  void create_timestamp_queries();
+  void create_frame_capture();
+  void create_yuv_pipeline();
+  void record_yuv_conversion(VkCommandBuffer command_buffer);
+  std::optional<float> read_gpu_frame_time();
+  void blit_scene_to_swap_chain(VkCommandBuffer command_buffer,
+                                std::uint32_t image_index);
   void create_command_pools();
+  void create_async_compute();
   void create_command_buffers();
+  void record_command_buffer(std::uint32_t image_index);
+  static void begin_frame_commands(VkCommandBuffer command_buffer);
   void create_sync_objects();
   void draw_frame();
+  void submit_frame(std::uint32_t image_index);
   void recreate_swap_chain();
+  void apply_quality_level();
   void cleanup_swap_chain();
-  void update_uniform_buffer(std::uint32_t current_image);
+  void retire_sample_count_resources();
+  void update_scene();
+  void latch_uniform_buffer(std::uint32_t current_image);
+  shaders::uniform_buffer_object camera_uniforms(
+      const simulation_state& state) const;
+  const geometry::lod_level& select_lod();
   vulkan::swap_chain_support_details query_swap_chain_support(
       VkPhysicalDevice device);
   int rate_device_suitability(VkPhysicalDevice device);
   VkExtent2D choose_swap_extent(const VkSurfaceCapabilitiesKHR& capabilities);
   std::uint32_t find_memory_type(std::uint32_t type_filter,
                                  VkMemoryPropertyFlags properties);
+  bool has_memory_type(std::uint32_t type_filter,
+                       VkMemoryPropertyFlags properties);
   VkFormat find_supported_format(const std::vector<VkFormat>& candidates,
                                  VkImageTiling tiling,
                                  VkFormatFeatureFlags features);
@@ -195,12 +432,16 @@ private:
   static VkSurfaceFormatKHR choose_swap_surface_format(
       const std::vector<VkSurfaceFormatKHR>& available_formats);
   static bool check_device_extensions_support(VkPhysicalDevice device);
+  bool check_bindless_support();
   static bool check_validation_layer_support(
       const char* layer,
       const std::vector<VkLayerProperties>& available_layers);
   static void framebuffer_resize_callback(GLFWwindow* window,
                                           int width,
                                           int height);
+  static std::uint64_t pack_framebuffer_size(int width, int height);
+  static void key_callback(
+      GLFWwindow* window, int key, int scancode, int action, int mods);
   static VKAPI_ATTR VkBool32 VKAPI_CALL
   debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
                  VkDebugUtilsMessageTypeFlagsEXT message_type,
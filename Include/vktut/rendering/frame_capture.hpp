@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <vktut/utilities/thread_pool.hpp>
+#include <vktut/vulkan/readback_ring.hpp>
+
+namespace vktut::rendering
+{
+enum class capture_format
+{
+  // tightly packed rgba8 rows, no header
+  raw,
+  ppm,
+  png,
+};
+
+// copies rendered frames into a readback ring and writes them to files on
+// worker threads. when every slot is still waiting on the gpu or an encoder
+// the frame is dropped instead of stalling the render loop.
+struct frame_capture
+{
+private:
+  struct capture
+  {
+    VkFormat format;
+    VkExtent2D extent;
+    std::uint64_t frame_number;
+  };
+
+  capture_format m_format;
+  std::string m_directory;
+  vulkan::readback_ring m_ring;
+  // indexed like the ring's slots
+  std::vector<capture> m_captures;
+  std::uint64_t m_frame_number = 0;
+  std::uint64_t m_dropped_frames = 0;
+  std::unique_ptr<utilities::thread_pool> m_encoders;
+
+public:
+  frame_capture(VkDevice device,
+                VkPhysicalDevice physical_device,
+                capture_format format,
+                std::string directory,
+                std::size_t slot_count,
+                std::size_t encoder_count);
+  ~frame_capture();
+  frame_capture(const frame_capture&) = delete;
+  frame_capture& operator=(const frame_capture&) = delete;
+  frame_capture(frame_capture&&) = delete;
+  frame_capture& operator=(frame_capture&&) = delete;
+
+  // 8 bit rgba or bgra, the channel order is fixed up while encoding
+  static bool supports(VkFormat format);
+
+  // records a copy of the top left `extent` of `image`, which has to be in
+  // TRANSFER_SRC_OPTIMAL and stay there until the command buffer is done.
+  // returns false when the frame had to be dropped.
+  bool record(VkCommandBuffer command_buffer,
+              std::size_t frame_index,
+              VkImage image,
+              VkFormat format,
+              VkExtent2D extent);
+  // called once the fence of `frame_index` has signaled, hands the copies it
+  // covered to the encoders
+  void frame_completed(std::size_t frame_index);
+  // the device has to be idle, encodes everything still pending
+  void flush();
+
+  [[nodiscard]] std::uint64_t dropped_frames() const;
+
+private:
+  void encode(std::size_t slot_index);
+};
+}  // namespace vktut::rendering
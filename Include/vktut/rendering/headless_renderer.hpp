@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <vktut/assets/asset_manager.hpp>
+#include <vktut/vulkan/buffer_and_memory.hpp>
+#include <vktut/vulkan/descriptor_allocator.hpp>
+#include <vktut/vulkan/device_context.hpp>
+#include <vktut/vulkan/image_and_memory.hpp>
+
+namespace vktut::rendering
+{
+// renders one textured mesh into an offscreen image and reads it back. every
+// renderer owns its command buffer, targets and pipeline, so any number of
+// them can render on their own threads against one shared device_context.
+struct headless_renderer
+{
+private:
+  static constexpr VkFormat color_format = VK_FORMAT_R8G8B8A8_SRGB;
+  static constexpr VkFormat depth_format = VK_FORMAT_D32_SFLOAT;
+
+  std::shared_ptr<vulkan::device_context> m_context;
+  VkDevice m_device;
+  VkExtent2D m_extent;
+
+  VkCommandPool m_command_pool;
+  VkCommandBuffer m_command_buffer;
+  VkFence m_fence;
+
+  vulkan::image_and_memory m_color_image;
+  VkImageView m_color_view;
+  vulkan::image_and_memory m_depth_image;
+  VkImageView m_depth_view;
+  // host visible, the color image is copied here at the end of every render
+  vulkan::buffer_and_memory m_readback_buffer;
+  // the model matrix of the one instance drawn, rewritten by every render
+  vulkan::buffer_and_memory m_instance_buffer;
+  // the camera the vertex shader reads, rewritten by every render
+  vulkan::buffer_and_memory m_uniform_buffer;
+
+  VkRenderPass m_render_pass;
+  VkFramebuffer m_framebuffer;
+  VkDescriptorSetLayout m_descriptor_set_layout;
+  VkPipelineLayout m_pipeline_layout;
+  VkPipeline m_pipeline;
+
+  vulkan::descriptor_allocator m_descriptor_allocator;
+  VkDescriptorSet m_descriptor_set;
+
+  // shared with every other renderer drawing the same files, kept alive
+  // while this one may still render them
+  assets::asset_manager::texture_handle m_texture;
+  assets::asset_manager::mesh_handle m_mesh;
+
+public:
+  headless_renderer(std::shared_ptr<vulkan::device_context> context,
+                    VkExtent2D extent,
+                    assets::asset_manager::texture_handle texture);
+  ~headless_renderer();
+  headless_renderer(const headless_renderer&) = delete;
+  headless_renderer& operator=(const headless_renderer&) = delete;
+  headless_renderer(headless_renderer&&) = delete;
+  headless_renderer& operator=(headless_renderer&&) = delete;
+
+  [[nodiscard]] VkExtent2D extent() const;
+
+  // drawn at its full detail level
+  void set_mesh(assets::asset_manager::mesh_handle mesh);
+  // tightly packed rgba8 rows, top row first
+  std::vector<std::byte> render(const glm::mat4& view_projection,
+                                const glm::mat4& model);
+
+private:
+  void create_targets();
+  void create_render_pass();
+  void create_pipeline();
+  void create_descriptor_set();
+};
+}  // namespace vktut::rendering
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::rendering
+{
+struct quality_level
+{
+  VkSampleCountFlagBits samples;
+  bool sample_shading;
+  float min_sample_shading;
+};
+
+// walks a ladder of multisampling settings based on measured frame times.
+// it steps down quickly when frames blow the budget and climbs back up only
+// after a long stretch with plenty of headroom, so it doesn't oscillate.
+struct quality_governor
+{
+private:
+  // ordered from most to least expensive
+  std::vector<quality_level> m_levels;
+  std::size_t m_current;
+  float m_budget_ms;
+  float m_average_ms;
+  std::size_t m_frames_measured;
+  std::size_t m_frames_over_budget;
+  std::size_t m_frames_with_headroom;
+  // doubles on every step down so a level that keeps failing is retried less
+  std::size_t m_step_up_frames;
+
+  static constexpr float smoothing = 0.1F;
+  // frames the average needs after a change before it means anything
+  static constexpr std::size_t settle_frames = 30;
+  static constexpr std::size_t step_down_frames = 30;
+  static constexpr std::size_t initial_step_up_frames = 300;
+  static constexpr std::size_t max_step_up_frames = 300 * 16;
+  static constexpr float step_up_headroom = 0.6F;
+
+public:
+  quality_governor(VkSampleCountFlagBits max_samples,
+                   bool sample_shading_supported,
+                   float budget_ms);
+
+  [[nodiscard]] const quality_level& current() const;
+  [[nodiscard]] float average_frame_time_ms() const;
+  // returns true when the level changed and the caller has to rebuild
+  bool record_frame(float frame_time_ms);
+
+private:
+  void change_level(std::size_t level);
+};
+}  // namespace vktut::rendering
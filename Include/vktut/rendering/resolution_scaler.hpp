@@ -0,0 +1,32 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::rendering
+{
+// picks the fraction of the output resolution to render at so measured gpu
+// frame time settles on a target. the scale applies to both axes, so the
+// shaded pixel count moves with its square.
+struct resolution_scaler
+{
+private:
+  float m_min_scale;
+  float m_max_scale;
+  float m_target_ms;
+  float m_scale;
+
+  // largest relative change in one frame, keeps a single hitch from
+  // visibly popping the resolution
+  static constexpr float max_step = 0.05F;
+  // within this fraction of the target the scale is left alone
+  static constexpr float dead_band = 0.05F;
+
+public:
+  resolution_scaler(float min_scale, float max_scale, float target_ms);
+
+  [[nodiscard]] float scale() const;
+  [[nodiscard]] VkExtent2D apply(VkExtent2D full_extent) const;
+  void update(float gpu_frame_time_ms);
+};
+}  // namespace vktut::rendering
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <vktut/utilities/thread_pool.hpp>
+#include <vktut/vulkan/readback_ring.hpp>
+
+namespace vktut::rendering
+{
+enum class video_format
+{
+  // yuv4mpeg2 with i420 frames, ffmpeg and most encoders read it from a pipe
+  y4m,
+  // headerless nv12 frames, the layout hardware encoders want
+  nv12,
+};
+
+// streams frames that rgb_to_yuv.comp converted on the gpu to a file, stdout
+// or a named pipe. the converted frames land in a readback ring and a single
+// writer thread writes them straight from the mapped memory in order. frames
+// are dropped while the reader falls behind instead of stalling rendering.
+struct video_stream
+{
+private:
+  video_format m_format;
+  VkExtent2D m_extent;
+  VkDeviceSize m_frame_size;
+  std::FILE* m_output;
+  vulkan::readback_ring m_ring;
+  std::uint64_t m_dropped_frames = 0;
+  std::unique_ptr<utilities::thread_pool> m_writer;
+
+public:
+  // "-" streams to stdout. opening a named pipe blocks until a reader opens
+  // the other end.
+  video_stream(VkDevice device,
+               VkPhysicalDevice physical_device,
+               video_format format,
+               VkExtent2D extent,
+               const std::string& path,
+               std::uint32_t frame_rate,
+               std::size_t slot_count);
+  ~video_stream();
+  video_stream(const video_stream&) = delete;
+  video_stream& operator=(const video_stream&) = delete;
+  video_stream(video_stream&&) = delete;
+  video_stream& operator=(video_stream&&) = delete;
+
+  // the largest extent within `extent` rgb_to_yuv.comp can convert to
+  static VkExtent2D stream_extent(VkExtent2D extent);
+
+  [[nodiscard]] VkExtent2D extent() const;
+  [[nodiscard]] bool interleaved_chroma() const;
+  // where the frame `frame_index` converts into, nothing when it is dropped
+  std::optional<VkDescriptorBufferInfo> acquire(std::size_t frame_index);
+  // called once the fence of `frame_index` has signaled
+  void frame_completed(std::size_t frame_index);
+  // the device has to be idle, writes everything still pending
+  void flush();
+
+  [[nodiscard]] std::uint64_t dropped_frames() const;
+
+private:
+  void write(std::size_t slot_index);
+};
+}  // namespace vktut::rendering
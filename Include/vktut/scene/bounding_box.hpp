@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace vktut::scene
+{
+// axis aligned, an empty box has min above max on every axis
+struct bounding_box
+{
+  glm::vec3 min;
+  glm::vec3 max;
+
+  static bounding_box empty();
+  static bounding_box sphere(const glm::vec3& center, float radius);
+
+  void expand(const bounding_box& other);
+  void expand(const glm::vec3& point);
+  [[nodiscard]] glm::vec3 center() const;
+  // half the surface area, all the surface area heuristic needs
+  [[nodiscard]] float half_area() const;
+  // the box around this one after an affine transform
+  [[nodiscard]] bounding_box transformed(const glm::mat4& transform) const;
+};
+}  // namespace vktut::scene
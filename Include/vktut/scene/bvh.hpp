@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vktut/scene/bounding_box.hpp>
+#include <vktut/utilities/thread_pool.hpp>
+
+namespace vktut::scene
+{
+struct ray
+{
+  glm::vec3 origin;
+  glm::vec3 direction;
+  float max_distance;
+};
+
+// bounding volume hierarchy over the bounds of objects 0 to n - 1, built
+// top down with binned surface area heuristic splits. moving objects only
+// refit the boxes above them, which lets the tree drift away from the best
+// split. degraded() says when a rebuild, usually build_async(), pays off.
+struct bvh
+{
+public:
+  using object = std::uint32_t;
+
+  static constexpr std::size_t bin_count = 16;
+  static constexpr std::size_t max_leaf_size = 4;
+  // how much worse than the freshly built tree refitting may get
+  static constexpr float rebuild_threshold = 1.5F;
+
+private:
+  // an inner node has count 0 and its children at first and first + 1,
+  // always behind it in m_nodes. a leaf owns m_objects[first, first + count)
+  struct node
+  {
+    bounding_box bounds;
+    std::uint32_t first;
+    std::uint32_t count;
+  };
+
+  std::vector<node> m_nodes;
+  std::vector<object> m_objects;
+  std::vector<bounding_box> m_bounds;
+  std::vector<std::uint32_t> m_leaves;
+  std::vector<std::uint8_t> m_dirty;
+  bool m_any_dirty = false;
+  float m_build_cost = 0.0F;
+  float m_cost = 0.0F;
+
+public:
+  static bvh build(std::vector<bounding_box> bounds);
+  // builds on one of the pool's threads from a copy of the bounds. objects
+  // moved in the meantime have to be set again on the result
+  static std::future<bvh> build_async(utilities::thread_pool& pool,
+                                      std::vector<bounding_box> bounds);
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] const bounding_box& bounds(object target) const;
+  // takes effect on the next refit()
+  void set_bounds(object target, const bounding_box& bounds);
+  // recomputes every box above an object that moved, bottom up
+  void refit();
+  // expected traversal cost relative to the root, lower is better
+  [[nodiscard]] float cost() const;
+  [[nodiscard]] bool degraded() const;
+
+  // the queries append every object whose bounds pass to `objects`
+  // planes as from frustum_culler::planes(), normals pointing inwards
+  void query_frustum(std::span<const glm::vec4, 6> planes,
+                     std::vector<object>& objects) const;
+  void query_sphere(const glm::vec3& center,
+                    float radius,
+                    std::vector<object>& objects) const;
+  // nearer subtrees are visited first, but the result is not sorted
+  void query_ray(const ray& query, std::vector<object>& objects) const;
+
+private:
+  enum class containment
+  {
+    outside,
+    intersecting,
+    inside,
+  };
+
+  void split(std::uint32_t node_index, std::span<const glm::vec3> centers);
+  void collect(std::uint32_t node_index, std::vector<object>& objects) const;
+  [[nodiscard]] float compute_cost() const;
+
+  static containment classify(const bounding_box& box,
+                              std::span<const glm::vec4, 6> planes);
+  static bool overlaps(const bounding_box& box,
+                       const glm::vec3& center,
+                       float radius);
+  // distance along the ray to where it enters the box, infinity on a miss
+  static float entry_distance(const bounding_box& box,
+                              const ray& query,
+                              const glm::vec3& inverse_direction);
+};
+}  // namespace vktut::scene
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vktut/utilities/thread_pool.hpp>
+
+namespace vktut::scene
+{
+// tests bounding spheres against the view frustum on the cpu, batch_size
+// objects at a time. built with AVX2 (VKTUT_ENABLE_AVX2) a batch is one
+// register per component, otherwise it is plain loops over the same layout
+struct frustum_culler
+{
+public:
+  using object = std::uint32_t;
+
+  static constexpr std::size_t batch_size = 8;
+  // objects per job when culling on a thread pool, a multiple of batch_size
+  static constexpr std::size_t job_size = 16384;
+
+private:
+  // padded to whole batches, with spheres that can never be visible
+  std::vector<float> m_center_x;
+  std::vector<float> m_center_y;
+  std::vector<float> m_center_z;
+  std::vector<float> m_radius;
+  std::size_t m_count = 0;
+  std::vector<std::vector<object>> m_job_results;
+
+public:
+  object add(const glm::vec3& center, float radius);
+  // a negative radius hides the object
+  void set(object target, const glm::vec3& center, float radius);
+  [[nodiscard]] std::size_t size() const;
+
+  // replaces `visible` with every object inside the frustum of
+  // `view_projection`, in ascending order. larger sets are split into jobs on
+  // `pool` when there is one
+  void cull(const glm::mat4& view_projection,
+            std::vector<object>& visible,
+            utilities::thread_pool* pool = nullptr);
+
+  // left, right, bottom, top, near, far, normalized and pointing inwards.
+  // planes of a model to clip matrix come out in model space
+  static std::array<glm::vec4, 6> planes(const glm::mat4& clip);
+
+private:
+  void cull_range(const std::array<glm::vec4, 6>& frustum,
+                  std::size_t first,
+                  std::size_t last,
+                  std::vector<object>& visible) const;
+};
+}  // namespace vktut::scene
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace vktut::scene
+{
+// node transforms as a structure of arrays, one array per component, so
+// updates stream through memory and batches map onto simd lanes. a node is its
+// index and parents have to exist before their children, which keeps the
+// arrays in topological order without ever sorting them
+struct scene_graph
+{
+public:
+  using node = std::uint32_t;
+
+  static constexpr node no_parent = std::numeric_limits<node>::max();
+  // nodes whose world transforms are computed side by side, one avx register
+  // of floats
+  static constexpr std::size_t batch_size = 8;
+  // one row major 3x4 matrix per node, matches `layout(row_major) mat4x3`
+  static constexpr std::size_t instance_stride = 12 * sizeof(float);
+
+private:
+  std::vector<node> m_parents;
+  std::vector<std::uint32_t> m_depths;
+  std::uint32_t m_max_depth = 0;
+  std::vector<float> m_translation_x;
+  std::vector<float> m_translation_y;
+  std::vector<float> m_translation_z;
+  std::vector<float> m_rotation_x;
+  std::vector<float> m_rotation_y;
+  std::vector<float> m_rotation_z;
+  std::vector<float> m_rotation_w;
+  std::vector<float> m_scale_x;
+  std::vector<float> m_scale_y;
+  std::vector<float> m_scale_z;
+  // the three rows of every world matrix, one array per element
+  std::array<std::vector<float>, 12> m_world;
+  std::vector<std::uint8_t> m_dirty;
+  bool m_any_dirty = false;
+  // the update() that last recomputed each node
+  std::vector<std::uint64_t> m_changed;
+  std::uint64_t m_generation = 0;
+  // dirty nodes bucketed by depth, reused between updates
+  std::vector<node> m_update_order;
+  std::vector<std::uint32_t> m_depth_offsets;
+  std::vector<std::uint32_t> m_depth_cursors;
+
+public:
+  node add_node(node parent,
+                glm::vec3 translation = glm::vec3 {0.0F},
+                glm::quat rotation = glm::quat {1.0F, 0.0F, 0.0F, 0.0F},
+                glm::vec3 scale = glm::vec3 {1.0F});
+
+  void set_translation(node target, glm::vec3 translation);
+  void set_rotation(node target, glm::quat rotation);
+  void set_scale(node target, glm::vec3 scale);
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] node parent(node target) const;
+  // as of the last update()
+  [[nodiscard]] glm::mat4 world(node target) const;
+
+  // recomputes every node that changed and everything below it, returns how
+  // many were recomputed
+  std::size_t update();
+  // copies out every world matrix recomputed since `written_generation`, at
+  // the node's index, and advances it. a fresh buffer starts from zero
+  void write_instances(std::span<std::byte> instances,
+                       std::uint64_t& written_generation) const;
+
+private:
+  void mark_dirty(node target);
+  void update_batch(std::span<const node> nodes);
+};
+}  // namespace vktut::scene
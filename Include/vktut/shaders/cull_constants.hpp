@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace vktut::shaders
+{
+// push constants of cull_meshlets.comp. the frustum and the camera come from
+// the uniform buffer, so culling sees the same latched camera as the draws
+struct cull_constants
+{
+  std::uint32_t meshlet_count;
+  // size of the depth pyramid's source, zero disables the occlusion test
+  alignas(8) glm::uvec2 render_extent;
+
+  static cull_constants from(std::uint32_t meshlet_count,
+                             glm::uvec2 render_extent);
+};
+}  // namespace vktut::shaders
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::shaders
+{
+// the resources cull_meshlets.comp binds, in template order
+struct cull_descriptors
+{
+  VkDescriptorBufferInfo meshlets;
+  VkDescriptorBufferInfo draw_commands;
+  VkDescriptorBufferInfo draw_count;
+  VkDescriptorBufferInfo uniform_buffer;
+  VkDescriptorImageInfo depth_pyramid;
+
+  static std::array<VkDescriptorSetLayoutBinding, 5> layout_bindings();
+  static std::array<VkDescriptorUpdateTemplateEntry, 5> template_entries();
+};
+}  // namespace vktut::shaders
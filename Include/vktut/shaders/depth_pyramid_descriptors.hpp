@@ -0,0 +1,20 @@
+#pragma once
+
+#include <array>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::shaders
+{
+// the two images one depth_pyramid.comp dispatch reduces between
+struct depth_pyramid_descriptors
+{
+  // the depth buffer for the first level, the previous level after that
+  VkDescriptorImageInfo source;
+  VkDescriptorImageInfo destination;
+
+  static std::array<VkDescriptorSetLayoutBinding, 2> layout_bindings();
+  static std::array<VkDescriptorUpdateTemplateEntry, 2> template_entries();
+};
+}  // namespace vktut::shaders
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <array>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::shaders
+{
+// everything set 0 points at, laid out so a descriptor update template can
+// read it in a single vkUpdateDescriptorSetWithTemplate() call
+struct frame_descriptors
+{
+  VkDescriptorBufferInfo uniform_buffer;
+  VkDescriptorImageInfo texture_sampler;
+  // world matrices of the scene graph, one per instance
+  VkDescriptorBufferInfo instances;
+
+  static std::array<VkDescriptorUpdateTemplateEntry, 3> template_entries();
+};
+}  // namespace vktut::shaders
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::shaders
+{
+// matches the specialization constants declared in basic.frag
+struct fragment_constants
+{
+  float base_color_r;
+  float base_color_g;
+  float base_color_b;
+
+  static std::array<VkSpecializationMapEntry, 3> map_entries();
+};
+
+// selects the basic.vert/basic.frag permutation compiled at build time
+// (see VKTUT_SHADER_VARIANTS) and the constants it gets specialized with
+struct material
+{
+  bool textured;
+  bool vertex_colors;
+  // sample from the descriptor indexing array instead of binding 1
+  bool bindless_textures;
+  glm::vec3 base_color;
+  std::uint32_t texture_index;
+
+  [[nodiscard]] std::span<const std::uint32_t> vertex_spirv() const;
+  [[nodiscard]] std::span<const std::uint32_t> fragment_spirv() const;
+  [[nodiscard]] fragment_constants specialization() const;
+  // only the attributes the selected permutation actually consumes
+  [[nodiscard]] std::vector<VkVertexInputAttributeDescription>
+  attribute_descriptions() const;
+};
+}  // namespace vktut::shaders
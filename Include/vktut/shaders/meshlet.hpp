@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace vktut::shaders
+{
+// one cluster of triangles as cull_meshlets.comp reads it (std430)
+struct meshlet
+{
+  // xyz center, w radius, in model space
+  alignas(16) glm::vec4 sphere;
+  // xyz axis, w cosine of the widest angle between the axis and any triangle
+  // normal. w <= 0 means the normals spread too far to ever cull by facing.
+  alignas(16) glm::vec4 cone;
+  std::uint32_t first_index;
+  std::uint32_t index_count;
+  std::uint32_t padding[2];
+};
+}  // namespace vktut::shaders
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vktut::shaders
+{
+// per-draw data, kept within the 128 bytes every device guarantees. model
+// matrices live in the instance buffer, indexed by gl_InstanceIndex, and the
+// camera in the late latched uniform buffer
+struct push_constants
+{
+  // slot in the bindless texture array, read by the fragment stage
+  std::uint32_t texture_index;
+
+  static push_constants from(std::uint32_t texture_index);
+};
+}  // namespace vktut::shaders
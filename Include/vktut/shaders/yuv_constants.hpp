@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace vktut::shaders
+{
+// push constants of rgb_to_yuv.comp
+struct yuv_constants
+{
+  glm::uvec2 output_extent;
+  glm::vec2 texel_to_uv;
+  std::uint32_t interleaved_chroma;
+  std::uint32_t srgb_source;
+
+  // the top left render_extent of a source_extent image is scaled to
+  // output_extent
+  static yuv_constants from(glm::uvec2 output_extent,
+                            glm::uvec2 render_extent,
+                            glm::uvec2 source_extent,
+                            bool interleaved_chroma,
+                            bool srgb_source);
+};
+}  // namespace vktut::shaders
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <array>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::shaders
+{
+// what one rgb_to_yuv.comp dispatch reads and writes
+struct yuv_descriptors
+{
+  VkDescriptorImageInfo source;
+  // the readback slot the converted frame lands in
+  VkDescriptorBufferInfo frame;
+
+  static std::array<VkDescriptorSetLayoutBinding, 2> layout_bindings();
+  static std::array<VkDescriptorUpdateTemplateEntry, 2> template_entries();
+};
+}  // namespace vktut::shaders
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace vktut::utilities
+{
+// a parsed JSON document, enough to read the small descriptions that come
+// with binary assets. objects keep their members in file order
+struct json
+{
+public:
+  using array = std::vector<json>;
+  using object = std::vector<std::pair<std::string, json>>;
+
+  std::variant<std::nullptr_t, bool, double, std::string, array, object> value;
+
+  static json parse(std::string_view text);
+
+  // null when this is not an object or has no such member
+  [[nodiscard]] const json* find(std::string_view key) const;
+  // these throw when the value is missing or of another type
+  [[nodiscard]] const json& at(std::string_view key) const;
+  [[nodiscard]] const json& at(std::size_t index) const;
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] double number() const;
+  [[nodiscard]] std::uint32_t index() const;
+  [[nodiscard]] const std::string& string() const;
+
+  // the member's value, or `fallback` when there is no such member
+  [[nodiscard]] double number_or(std::string_view key, double fallback) const;
+  [[nodiscard]] std::uint32_t index_or(std::string_view key,
+                                       std::uint32_t fallback) const;
+
+private:
+  // arrays and objects are parsed recursively, deeper documents are rejected
+  // before they can exhaust the stack
+  static constexpr std::size_t max_depth = 256;
+
+  static json parse_value(const char*& first,
+                          const char* last,
+                          std::size_t depth);
+  static std::string parse_string(const char*& first, const char* last);
+  static void append_utf8(std::string& out, std::uint32_t code_point);
+  static std::uint32_t parse_hex(const char*& first, const char* last);
+  static void skip_whitespace(const char*& first, const char* last);
+  static void expect(const char*& first, const char* last, char c);
+};
+}  // namespace vktut::utilities
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace vktut::utilities
+{
+enum class access_pattern
+{
+  normal,
+  sequential,
+  random,
+};
+
+// read-only view of a whole file, backed by the page cache instead of a heap
+// copy. the bytes stay valid for as long as the mapping is alive.
+struct mapped_file
+{
+private:
+  const std::byte* m_data;
+  std::size_t m_size;
+#ifdef _WIN32
+  void* m_file_handle;
+  void* m_mapping_handle;
+#endif
+
+public:
+  explicit mapped_file(std::string_view file_name,
+                       access_pattern pattern = access_pattern::sequential);
+  ~mapped_file();
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+  mapped_file(mapped_file&& other) noexcept;
+  mapped_file& operator=(mapped_file&& other) noexcept;
+
+  [[nodiscard]] std::span<const std::byte> bytes() const;
+  [[nodiscard]] std::size_t size() const;
+  void advise(access_pattern pattern);
+
+private:
+  void unmap();
+};
+}  // namespace vktut::utilities
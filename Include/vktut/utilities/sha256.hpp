@@ -0,0 +1,23 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace vktut::utilities
+{
+// SHA-256 as in FIPS 180-4, for telling contents apart where a collision
+// would silently swap one for the other
+struct sha256
+{
+public:
+  using digest = std::array<std::uint8_t, 32>;
+
+  static digest hash(std::span<const std::byte> bytes);
+
+private:
+  static void compress(std::array<std::uint32_t, 8>& state,
+                       const std::byte* block);
+};
+}  // namespace vktut::utilities
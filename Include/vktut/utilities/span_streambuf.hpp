@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <streambuf>
+
+namespace vktut::utilities
+{
+// lets stream-based parsers read straight out of a memory mapping
+struct span_streambuf : std::streambuf
+{
+  explicit span_streambuf(std::span<const std::byte> bytes);
+
+protected:
+  pos_type seekoff(off_type offset,
+                   std::ios_base::seekdir direction,
+                   std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type position, std::ios_base::openmode which) override;
+};
+}  // namespace vktut::utilities
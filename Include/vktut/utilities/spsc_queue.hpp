@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+
+namespace vktut::utilities
+{
+// a bounded queue between exactly one producer thread and one consumer
+// thread, neither of which ever blocks
+template<typename T, std::size_t Capacity>
+struct spsc_queue
+{
+  static_assert(std::has_single_bit(Capacity),
+                "the capacity has to be a power of two");
+
+private:
+  std::array<T, Capacity> m_items {};
+  // on their own cache lines, so the two sides don't contend for one
+  alignas(64) std::atomic<std::size_t> m_head {0};
+  alignas(64) std::atomic<std::size_t> m_tail {0};
+
+public:
+  // producer only, false when the queue is full and `item` was dropped
+  bool push(const T& item)
+  {
+    auto tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    m_items[tail & (Capacity - 1)] = item;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // consumer only
+  std::optional<T> pop()
+  {
+    auto head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    T item = m_items[head & (Capacity - 1)];
+    m_head.store(head + 1, std::memory_order_release);
+    return item;
+  }
+};
+}  // namespace vktut::utilities
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vktut::utilities
+{
+// a fixed set of worker threads draining one queue of jobs. jobs still queued
+// when the pool is destroyed are run before the workers exit.
+struct thread_pool
+{
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_job_available;
+  std::deque<std::function<void()>> m_jobs;
+  bool m_stopping = false;
+  std::vector<std::thread> m_workers;
+
+public:
+  explicit thread_pool(std::size_t thread_count);
+  ~thread_pool();
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+  thread_pool(thread_pool&&) = delete;
+  thread_pool& operator=(thread_pool&&) = delete;
+
+  void submit(std::function<void()> job);
+
+private:
+  void work();
+};
+}  // namespace vktut::utilities
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace vktut::utilities
+{
+// hands the latest snapshot of a value from one writer thread to one reader
+// thread without either waiting. each side owns a slot, the third is swapped
+// through an atomic index, so a write never lands in what the reader holds
+template<typename T>
+struct triple_buffer
+{
+private:
+  static constexpr std::uint8_t index_mask = 0b011;
+  // set while the shared slot holds a snapshot the reader has not taken yet
+  static constexpr std::uint8_t fresh = 0b100;
+
+  std::array<T, 3> m_slots;
+  std::atomic<std::uint8_t> m_shared {1};
+  std::uint8_t m_write = 0;
+  std::uint8_t m_read = 2;
+
+public:
+  explicit triple_buffer(const T& initial)
+      : m_slots {initial, initial, initial}
+  {
+  }
+
+  // writer only, the slot to fill before publish()
+  T& write_slot() { return m_slots[m_write]; }
+
+  // writer only
+  void publish()
+  {
+    auto previous = m_shared.exchange(
+        static_cast<std::uint8_t>(m_write | fresh), std::memory_order_acq_rel);
+    m_write = previous & index_mask;
+  }
+
+  // reader only, the latest published snapshot. it stays valid and
+  // unchanged until the next call
+  const T& read()
+  {
+    if ((m_shared.load(std::memory_order_relaxed) & fresh) != 0) {
+      auto previous = m_shared.exchange(m_read, std::memory_order_acq_rel);
+      m_read = previous & index_mask;
+    }
+    return m_slots[m_read];
+  }
+};
+}  // namespace vktut::utilities
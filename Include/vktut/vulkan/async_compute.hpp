@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::vulkan
+{
+// records and submits compute passes on a queue of their own, so they run
+// next to the graphics queue instead of in between its draws. every pass has
+// a command buffer and two semaphores per frame in flight: `ready` is
+// signaled by the graphics submission the pass depends on, `done` by the pass
+// for the graphics submission that depends on it.
+struct async_compute
+{
+private:
+  struct pass_slot
+  {
+    VkCommandBuffer command_buffer;
+    VkSemaphore ready;
+    VkSemaphore done;
+  };
+
+  VkDevice m_device;
+  VkQueue m_queue;
+  std::uint32_t m_family;
+  std::uint32_t m_graphics_family;
+  VkCommandPool m_command_pool;
+  std::size_t m_pass_count;
+  // frame major
+  std::vector<pass_slot> m_slots;
+
+public:
+  async_compute(VkDevice device,
+                std::uint32_t family,
+                std::uint32_t queue_index,
+                std::uint32_t graphics_family,
+                std::size_t frames_in_flight,
+                std::size_t pass_count);
+  ~async_compute();
+  async_compute(const async_compute&) = delete;
+  async_compute& operator=(const async_compute&) = delete;
+  async_compute(async_compute&&) = delete;
+  async_compute& operator=(async_compute&&) = delete;
+
+  [[nodiscard]] std::uint32_t family() const;
+
+  // the previous submission of the pass for this frame in flight has to be
+  // done, which the frame's fence guarantees
+  VkCommandBuffer begin(std::size_t frame_index, std::size_t pass);
+  [[nodiscard]] VkSemaphore ready(std::size_t frame_index,
+                                  std::size_t pass) const;
+  [[nodiscard]] VkSemaphore done(std::size_t frame_index,
+                                 std::size_t pass) const;
+  // ends recording and submits the pass once `ready` has been signaled. a
+  // binary semaphore can't be signaled again before it is waited on, so
+  // `done` is only signaled when something is going to wait for it
+  void submit(std::size_t frame_index,
+              std::size_t pass,
+              VkPipelineStageFlags wait_stage,
+              bool signal_done,
+              VkFence fence);
+
+  // the two halves of handing a single level image between the graphics and
+  // the compute family, recorded on the giving and the taking queue with the
+  // same layouts. the semaphore between the submissions orders them
+  [[nodiscard]] VkImageMemoryBarrier release(VkImage image,
+                                             VkImageAspectFlags aspect,
+                                             VkImageLayout old_layout,
+                                             VkImageLayout new_layout,
+                                             VkAccessFlags src_access,
+                                             bool to_compute) const;
+  [[nodiscard]] VkImageMemoryBarrier acquire(VkImage image,
+                                             VkImageAspectFlags aspect,
+                                             VkImageLayout old_layout,
+                                             VkImageLayout new_layout,
+                                             VkAccessFlags dst_access,
+                                             bool to_compute) const;
+
+private:
+  [[nodiscard]] VkImageMemoryBarrier transfer(VkImage image,
+                                              VkImageAspectFlags aspect,
+                                              VkImageLayout old_layout,
+                                              VkImageLayout new_layout,
+                                              bool to_compute) const;
+  [[nodiscard]] const pass_slot& slot(std::size_t frame_index,
+                                      std::size_t pass) const;
+};
+}  // namespace vktut::vulkan
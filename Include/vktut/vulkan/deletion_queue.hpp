@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace vktut::vulkan
+{
+// destroys objects the gpu may still be using once it no longer can, instead
+// of waiting for the device to go idle. every destruction is tagged with the
+// frame it was pushed in and runs after that frame's fence has been waited on,
+// which is `frames_in_flight` frames later.
+struct deletion_queue
+{
+private:
+  struct entry
+  {
+    std::uint64_t frame;
+    std::function<void()> destroy;
+  };
+
+  std::uint64_t m_frames_in_flight;
+  // frames submitted so far, the one being recorded has this number
+  std::uint64_t m_frame = 0;
+  // oldest first, so the frames only ever grow towards the back
+  std::deque<entry> m_entries;
+
+public:
+  explicit deletion_queue(std::uint64_t frames_in_flight);
+  ~deletion_queue();
+  deletion_queue(const deletion_queue&) = delete;
+  deletion_queue& operator=(const deletion_queue&) = delete;
+  deletion_queue(deletion_queue&&) = delete;
+  deletion_queue& operator=(deletion_queue&&) = delete;
+
+  void push(std::function<void()> destroy);
+  // once the fence of the frame being started has been waited on, runs
+  // everything pushed by frames that are now complete, in the order pushed
+  void collect();
+  // after the frame has been submitted
+  void next_frame();
+  // runs everything, the device has to be idle
+  void flush();
+};
+}  // namespace vktut::vulkan
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::vulkan
+{
+// hands out descriptor sets from a chain of pools, adding a pool whenever the
+// current one runs dry. reset() recycles every pool at once, so one allocator
+// per frame in flight makes per-frame descriptor churn nearly free.
+struct descriptor_allocator
+{
+private:
+  struct pool_size_ratio
+  {
+    VkDescriptorType type;
+    float descriptors_per_set;
+  };
+
+  VkDevice m_device;
+  VkDescriptorPool m_current_pool;
+  std::vector<VkDescriptorPool> m_used_pools;
+  std::vector<VkDescriptorPool> m_free_pools;
+
+  static constexpr std::uint32_t sets_per_pool = 64;
+  static constexpr std::array pool_size_ratios = {
+      pool_size_ratio {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0F},
+      pool_size_ratio {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0F},
+      pool_size_ratio {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0F},
+      pool_size_ratio {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0.5F},
+  };
+
+public:
+  explicit descriptor_allocator(VkDevice device);
+  ~descriptor_allocator();
+  descriptor_allocator(const descriptor_allocator&) = delete;
+  descriptor_allocator& operator=(const descriptor_allocator&) = delete;
+  descriptor_allocator(descriptor_allocator&& other) noexcept;
+  descriptor_allocator& operator=(descriptor_allocator&& other) noexcept;
+
+  VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+  // every set handed out since the last reset becomes invalid
+  void reset();
+
+private:
+  VkDescriptorPool grab_pool();
+  VkDescriptorPool create_pool();
+  void destroy();
+};
+}  // namespace vktut::vulkan
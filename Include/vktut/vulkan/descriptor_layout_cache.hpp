@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::vulkan
+{
+// deduplicates descriptor set layouts by their flags and bindings. the cache
+// owns every layout it hands out and destroys them along with itself.
+struct descriptor_layout_cache
+{
+private:
+  struct layout_key
+  {
+    VkDescriptorSetLayoutCreateFlags flags;
+    // pImmutableSamplers only stays valid during get(), the samplers it
+    // pointed to are copied into `immutable_samplers` in binding order
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<VkSampler> immutable_samplers;
+
+    bool operator==(const layout_key& other) const;
+  };
+
+  struct layout_key_hash
+  {
+    std::size_t operator()(const layout_key& key) const;
+
+  private:
+    static void combine(std::size_t& seed, std::uint64_t value);
+  };
+
+  VkDevice m_device;
+  std::unordered_map<layout_key, VkDescriptorSetLayout, layout_key_hash>
+      m_layouts;
+
+public:
+  explicit descriptor_layout_cache(VkDevice device);
+  ~descriptor_layout_cache();
+  descriptor_layout_cache(const descriptor_layout_cache&) = delete;
+  descriptor_layout_cache& operator=(const descriptor_layout_cache&) = delete;
+  descriptor_layout_cache(descriptor_layout_cache&&) = delete;
+  descriptor_layout_cache& operator=(descriptor_layout_cache&&) = delete;
+
+  VkDescriptorSetLayout get(std::vector<VkDescriptorSetLayoutBinding> bindings,
+                            VkDescriptorSetLayoutCreateFlags flags = 0);
+};
+}  // namespace vktut::vulkan
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <vktut/vulkan/buffer_and_memory.hpp>
+#include <vktut/vulkan/descriptor_layout_cache.hpp>
+#include <vktut/vulkan/image_and_memory.hpp>
+#include <vktut/vulkan/instance.hpp>
+#include <vktut/vulkan/queue_pool.hpp>
+#include <vktut/vulkan/texture.hpp>
+
+namespace vktut::vulkan
+{
+// one logical device without any surface, shared by every renderer in the
+// process. everything it hands out may be used from several threads at once:
+// queues are leased from a pool, the pipeline cache is internally
+// synchronized and the other caches sit behind a mutex.
+struct device_context
+{
+private:
+  std::shared_ptr<instance> m_instance;
+  VkPhysicalDevice m_physical_device;
+  VkDevice m_device;
+  std::uint32_t m_graphics_family;
+  std::unique_ptr<queue_pool> m_graphics_queues;
+  VkPipelineCache m_pipeline_cache;
+
+  std::mutex m_cache_mutex;
+  std::unique_ptr<descriptor_layout_cache> m_layout_cache;
+  std::map<std::pair<VkFilter, VkSamplerAddressMode>, VkSampler> m_samplers;
+  // only records uploads, which hold m_cache_mutex
+  VkCommandPool m_upload_command_pool;
+
+public:
+  explicit device_context(std::shared_ptr<instance> instance);
+  ~device_context();
+  device_context(const device_context&) = delete;
+  device_context& operator=(const device_context&) = delete;
+  device_context(device_context&&) = delete;
+  device_context& operator=(device_context&&) = delete;
+
+  [[nodiscard]] VkPhysicalDevice physical_device() const;
+  [[nodiscard]] VkDevice device() const;
+  [[nodiscard]] std::uint32_t graphics_family() const;
+  [[nodiscard]] VkPipelineCache pipeline_cache() const;
+  queue_pool& graphics_queues();
+
+  VkDescriptorSetLayout descriptor_set_layout(
+      std::vector<VkDescriptorSetLayoutBinding> bindings);
+  VkSampler sampler(VkFilter filter, VkSamplerAddressMode address_mode);
+  // decoded and uploaded with a full mip chain. nothing is cached here, the
+  // caller owns the result, assets::asset_manager shares it
+  texture create_texture(std::span<const std::byte> file_bytes);
+  // a device local copy of `data`, also usable as `usage`
+  buffer_and_memory upload_buffer(std::span<const std::byte> data,
+                                  VkBufferUsageFlags usage);
+  void destroy_texture(const texture& texture) const;
+  void destroy_buffer(const buffer_and_memory& buffer) const;
+
+  // submits on a leased queue and waits for the work to finish
+  void submit_and_wait(VkCommandBuffer command_buffer, VkFence fence);
+
+  [[nodiscard]] std::uint32_t find_memory_type(
+      std::uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+  [[nodiscard]] buffer_and_memory create_buffer(
+      VkDeviceSize size,
+      VkBufferUsageFlags usage,
+      VkMemoryPropertyFlags properties) const;
+  [[nodiscard]] image_and_memory create_image(
+      VkExtent2D extent,
+      VkFormat format,
+      VkImageUsageFlags usage,
+      VkMemoryPropertyFlags properties,
+      std::uint32_t mip_levels = 1) const;
+  [[nodiscard]] VkImageView create_image_view(
+      VkImage image,
+      VkFormat format,
+      VkImageAspectFlags aspect_flags,
+      std::uint32_t mip_levels = 1) const;
+
+private:
+  void pick_physical_device();
+  void create_logical_device();
+  // on m_upload_command_pool, the caller holds m_cache_mutex until
+  // end_upload() has waited for the commands
+  VkCommandBuffer begin_upload();
+  void end_upload(VkCommandBuffer command_buffer);
+  // blits every level down from the one above, then leaves them all shader
+  // read only. level 0 has to be in TRANSFER_DST_OPTIMAL
+  void record_mipmaps(VkCommandBuffer command_buffer,
+                      VkImage image,
+                      VkFormat format,
+                      VkExtent2D extent,
+                      std::uint32_t mip_levels) const;
+};
+}  // namespace vktut::vulkan
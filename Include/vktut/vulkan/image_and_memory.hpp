@@ -9,5 +9,8 @@ struct image_and_memory
 {
   VkImage image;
   VkDeviceMemory memory;
+  // what the image asked for, a lazily allocated image may commit far less
+  VkDeviceSize size;
+  bool lazily_allocated;
 };
 }  // namespace vktut::vulkan
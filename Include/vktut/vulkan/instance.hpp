@@ -47,7 +47,7 @@ inline instance::instance(const std::string& application_name,
       .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
       .pEngineName = "No Engine",
       .engineVersion = VK_MAKE_VERSION(1, 0, 0),
-      .apiVersion = VK_API_VERSION_1_0,
+      .apiVersion = VK_API_VERSION_1_1,
   };
 
   VkInstanceCreateInfo create_info = {
@@ -13,6 +13,11 @@ struct queue_family_indices
   std::optional<std::uint32_t> graphics_family;
   std::optional<std::uint32_t> present_family;
   std::optional<std::uint32_t> transfer_family;
+  // a queue for compute work next to the graphics queue, in a family without
+  // graphics apart from the transfer family if there is one, else a second
+  // queue of the transfer family, else a second queue of the graphics family
+  std::optional<std::uint32_t> compute_family;
+  std::uint32_t compute_queue_index = 0;
 
   static vktut::vulkan::queue_family_indices find(VkPhysicalDevice device,
                                                   VkSurfaceKHR surface);
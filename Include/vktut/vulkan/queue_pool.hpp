@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::vulkan
+{
+// the queues of one family, shared between threads. a queue has to be
+// externally synchronized, so each one is leased to a single thread at a time
+// and threads only wait when every queue is busy submitting.
+struct queue_pool
+{
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_released;
+  std::vector<VkQueue> m_free_queues;
+
+public:
+  // gives the queue back when it goes out of scope
+  struct lease
+  {
+  private:
+    queue_pool* m_pool;
+    VkQueue m_queue;
+
+  public:
+    lease(queue_pool& pool, VkQueue queue);
+    ~lease();
+    lease(const lease&) = delete;
+    lease& operator=(const lease&) = delete;
+    lease(lease&& other) noexcept;
+    lease& operator=(lease&& other) noexcept;
+
+    [[nodiscard]] VkQueue get() const;
+  };
+
+  queue_pool(VkDevice device,
+             std::uint32_t family_index,
+             std::uint32_t queue_count);
+  queue_pool(const queue_pool&) = delete;
+  queue_pool& operator=(const queue_pool&) = delete;
+  queue_pool(queue_pool&&) = delete;
+  queue_pool& operator=(queue_pool&&) = delete;
+  ~queue_pool() = default;
+
+  // blocks until a queue is free
+  lease acquire();
+
+private:
+  void release(VkQueue queue);
+};
+}  // namespace vktut::vulkan
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::vulkan
+{
+// persistently mapped host visible buffers the gpu writes frames into. a slot
+// is tagged with the frame in flight that writes it and is done once that
+// frame's fence has signaled. consumers on other threads hand slots back with
+// release(), until then the slot is never written again.
+struct readback_ring
+{
+private:
+  struct slot
+  {
+    VkBuffer buffer;
+    VkDeviceMemory memory;
+    VkDeviceSize capacity;
+    const std::byte* mapped;
+    bool coherent;
+    std::size_t frame_index;
+  };
+
+  VkDevice m_device;
+  VkPhysicalDevice m_physical_device;
+  VkBufferUsageFlags m_usage;
+  std::vector<slot> m_slots;
+  std::mutex m_mutex;
+  std::vector<std::size_t> m_free_slots;
+  // acquired and not yet known to be complete, oldest first
+  std::deque<std::size_t> m_pending_slots;
+
+public:
+  readback_ring(VkDevice device,
+                VkPhysicalDevice physical_device,
+                VkBufferUsageFlags usage,
+                std::size_t slot_count);
+  ~readback_ring();
+  readback_ring(const readback_ring&) = delete;
+  readback_ring& operator=(const readback_ring&) = delete;
+  readback_ring(readback_ring&&) = delete;
+  readback_ring& operator=(readback_ring&&) = delete;
+
+  // a free slot of at least `size` bytes, or nothing when every slot is busy
+  std::optional<std::size_t> acquire(std::size_t frame_index,
+                                     VkDeviceSize size);
+  [[nodiscard]] VkBuffer buffer(std::size_t slot_index) const;
+  [[nodiscard]] const std::byte* data(std::size_t slot_index) const;
+  // the slots written by `frame_index`, whose fence has signaled, in the
+  // order they were acquired. their contents are visible to the host.
+  std::vector<std::size_t> complete(std::size_t frame_index);
+  // the device has to be idle
+  std::vector<std::size_t> complete_all();
+  // may be called from any thread
+  void release(std::size_t slot_index);
+
+private:
+  void reserve(slot& slot, VkDeviceSize size);
+  void destroy(slot& slot);
+  void invalidate(const slot& slot);
+  [[nodiscard]] std::optional<std::uint32_t> find_memory_type(
+      std::uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+};
+}  // namespace vktut::vulkan
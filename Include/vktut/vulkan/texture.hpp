@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace vktut::vulkan
+{
+struct texture
+{
+  VkImage image;
+  VkDeviceMemory memory;
+  VkImageView view;
+  std::uint32_t mip_levels;
+};
+}  // namespace vktut::vulkan
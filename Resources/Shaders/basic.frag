@@ -1,13 +1,45 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#ifdef BINDLESS
+#  extension GL_EXT_nonuniform_qualifier : require
+#endif
+
+// material parameters, fixed per pipeline so the driver can fold them
+layout(constant_id = 0) const float baseColorR = 1.0;
+layout(constant_id = 1) const float baseColorG = 1.0;
+layout(constant_id = 2) const float baseColorB = 1.0;
 
 layout(location = 0) out vec4 outColor;
 
+#ifdef HAS_VERTEX_COLOR
 layout(location = 0) in vec3 fragColor;
+#endif
+#ifdef HAS_TEXTURE
 layout(location = 1) in vec2 fragTexCoord;
 
+#  ifdef BINDLESS
+// every loaded texture, draws pick theirs by index
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform PushConstants {
+  uint textureIndex;
+} pc;
+#  else
 layout(binding = 1) uniform sampler2D texSampler;
+#  endif
+#endif
 
 void main() {
-  outColor = vec4(fragColor * texture(texSampler, fragTexCoord).rgb, 1.0);
+  vec3 color = vec3(baseColorR, baseColorG, baseColorB);
+#ifdef HAS_VERTEX_COLOR
+  color *= fragColor;
+#endif
+#ifdef HAS_TEXTURE
+#  ifdef BINDLESS
+  color *= texture(textures[nonuniformEXT(pc.textureIndex)], fragTexCoord).rgb;
+#  else
+  color *= texture(texSampler, fragTexCoord).rgb;
+#  endif
+#endif
+  outColor = vec4(color, 1.0);
 }
@@ -1,21 +1,45 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(binding = 0) uniform UniformBufferObject {
+// the camera, written by the host right before the frame is submitted so it
+// is as fresh as possible
+layout(set = 0, binding = 0) uniform UniformBufferObject {
   mat4 model;
   mat4 view;
   mat4 proj;
 } ubo;
 
+// world matrices from the scene graph, one per instance
+layout(set = 0, binding = 2) readonly buffer Instances {
+  layout(row_major) mat4x3 models[];
+} instances;
+
 layout(location = 0) in vec3 inPosition;
+#ifdef HAS_VERTEX_COLOR
 layout(location = 1) in vec3 inColor;
+#endif
+#ifdef HAS_TEXTURE
 layout(location = 2) in vec2 inTexCoord;
+#endif
 
+#ifdef HAS_VERTEX_COLOR
 layout(location = 0) out vec3 fragColor;
+#endif
+#ifdef HAS_TEXTURE
 layout(location = 1) out vec2 fragTexCoord;
+#endif
+
+// the depth pre-pass uses the plain permutation, every permutation has to
+// produce bit-identical depth for the main pass to pass its depth test
+invariant gl_Position;
 
 void main() {
-  gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+  vec3 position = instances.models[gl_InstanceIndex] * vec4(inPosition, 1.0);
+  gl_Position = ubo.proj * ubo.view * vec4(position, 1.0);
+#ifdef HAS_VERTEX_COLOR
   fragColor = inColor;
+#endif
+#ifdef HAS_TEXTURE
   fragTexCoord = inTexCoord;
+#endif
 }
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+
+#include <vktut/geometry/obj_parser.hpp>
+#include <vktut/utilities/thread_pool.hpp>
+
+namespace
+{
+// a textured grid written the way scanners write them, six decimals per
+// coordinate and a v/vt pair per corner, until it is `bytes` long
+std::string make_obj(std::size_t bytes)
+{
+  constexpr std::size_t columns = 1024;
+  std::string obj;
+  obj.reserve(bytes + 256 * columns);
+  std::array<char, 128> line {};
+  auto append = [&](int length)
+  { obj.append(line.data(), static_cast<std::size_t>(length)); };
+
+  for (std::size_t row = 0; obj.size() < bytes; ++row) {
+    for (std::size_t column = 0; column < columns; ++column) {
+      double x = static_cast<double>(column) * 0.001234567;
+      double y = static_cast<double>(row) * 0.001234567;
+      append(std::snprintf(line.data(),
+                           line.size(),
+                           "v %.6f %.6f %.6f\nvt %.6f %.6f\n",
+                           x,
+                           y,
+                           x * y - 0.5,
+                           x / 1.3,
+                           y / 1.3));
+    }
+    if (row == 0) {
+      continue;
+    }
+    // two triangles per quad between this row and the one before
+    for (std::size_t column = 1; column < columns; ++column) {
+      std::size_t a = (row - 1) * columns + column;
+      std::size_t b = a + columns;
+      append(std::snprintf(line.data(),
+                           line.size(),
+                           "f %zu/%zu %zu/%zu %zu/%zu\n",
+                           a,
+                           a,
+                           a + 1,
+                           a + 1,
+                           b,
+                           b));
+      append(std::snprintf(line.data(),
+                           line.size(),
+                           "f %zu/%zu %zu/%zu %zu/%zu\n",
+                           a + 1,
+                           a + 1,
+                           b + 1,
+                           b + 1,
+                           b,
+                           b));
+    }
+  }
+  return obj;
+}
+
+// the best of a few runs in MB/s, the others mostly measure page faults
+double measure(std::span<const std::byte> bytes,
+               vktut::utilities::thread_pool* pool)
+{
+  constexpr int runs = 5;
+  double best = 0.0;
+  for (int run = 0; run < runs; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    auto parsed = vktut::geometry::obj_parser::parse(bytes, pool);
+    auto seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    if (parsed.corners.empty()) {
+      std::cerr << "parsed no faces\n";
+      std::exit(1);
+    }
+    best = std::max(best, static_cast<double>(bytes.size()) / 1e6 / seconds);
+  }
+  return best;
+}
+}  // namespace
+
+// obj_parser_benchmark [megabytes]: parses a synthetic obj of that size, 256
+// MB by default, on the calling thread and then on pools of 1, 2, 4, ... up
+// to every hardware thread
+int main(int argc, char** argv)
+{
+  std::size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 256;
+  auto obj = make_obj(megabytes * 1000 * 1000);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  std::span bytes {reinterpret_cast<const std::byte*>(obj.data()), obj.size()};
+  std::cout << obj.size() / 1000 / 1000 << " MB in "
+            << (obj.size() + vktut::geometry::obj_parser::chunk_size - 1)
+               / vktut::geometry::obj_parser::chunk_size
+            << " chunks\n";
+
+  double single = measure(bytes, nullptr);
+  std::cout << "no pool: " << single << " MB/s\n";
+  std::size_t hardware =
+      std::max(std::size_t {1},
+               static_cast<std::size_t>(std::thread::hardware_concurrency()));
+  for (std::size_t threads = 1;; threads = std::min(2 * threads, hardware)) {
+    vktut::utilities::thread_pool pool {threads};
+    double pooled = measure(bytes, &pool);
+    std::cout << threads << " threads: " << pooled << " MB/s, "
+              << pooled / single << "x\n";
+    if (threads == hardware) {
+      break;
+    }
+  }
+}
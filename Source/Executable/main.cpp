@@ -1,8 +1,133 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <config.hpp>
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vktut/assets/asset_manager.hpp>
 #include <vktut/hello_triangle/application.hpp>
+#include <vktut/rendering/headless_renderer.hpp>
+#include <vktut/vulkan/device_context.hpp>
+#include <vktut/vulkan/instance.hpp>
 
-int main()
+int main(int argc, char** argv)
 {
-  vktut::hello_triangle::application application;
-  application.run();
+  std::vector<std::string_view> args {argv, argv + argc};
+  if (args.size() < 3 || args[1] != "--headless") {
+    // vktut --stream <path> [y4m|nv12]: also writes every frame as yuv to
+    // path, "-" being stdout
+    bool stream = args.size() >= 3 && args[1] == "--stream";
+    if (stream && args[2] == "-") {
+      // the log would end up in the middle of the video
+      std::cout.rdbuf(std::cerr.rdbuf());
+    }
+
+    vktut::hello_triangle::application application;
+    if (stream) {
+      application.stream_to(std::string {args[2]},
+                            args.size() > 3 && args[3] == "nv12"
+                                ? vktut::rendering::video_format::nv12
+                                : vktut::rendering::video_format::y4m);
+    }
+    application.run();
+    return 0;
+  }
+
+  // vktut --headless <threads> [frames]: renders the model from a different
+  // angle on every thread, all of them sharing one instance and device
+  auto thread_count = std::stoul(std::string {args[2]});
+  auto frame_count = args.size() > 3 ? std::stoul(std::string {args[3]}) : 64;
+  constexpr VkExtent2D extent = {.width = 512, .height = 512};
+
+  auto instance = std::make_shared<vktut::vulkan::instance>(
+      "vktut headless", false, std::array<const char*, 0> {});
+  auto context = std::make_shared<vktut::vulkan::device_context>(instance);
+  // every renderer asks for the same files, only the first request loads
+  // them. the renderers only draw the full detail level
+  vktut::assets::asset_manager assets {
+      vktut::assets::asset_manager::context_backend(context), 1};
+
+  auto start_time = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  // a failed renderer is reported once every thread is done
+  std::vector<std::exception_ptr> errors(thread_count);
+  threads.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back(
+        [&, i]
+        {
+          try {
+            vktut::rendering::headless_renderer renderer {
+                context,
+                extent,
+                assets.load_texture(PROJECT_SOURCE_DIR
+                                    "/Resources/Textures/tex_0.jpg")};
+            renderer.set_mesh(assets.load_mesh(PROJECT_SOURCE_DIR
+                                               "/Resources/Models/sculpt.obj"));
+
+            // as far out as the windowed camera at (30, 30, 30), orbited
+            // around the z axis
+            float angle = glm::two_pi<float>() * static_cast<float>(i)
+                / static_cast<float>(thread_count);
+            float orbit_radius = glm::length(glm::vec2 {30.0F, 30.0F});
+            auto view = glm::lookAt(glm::vec3 {orbit_radius * std::cos(angle),
+                                               orbit_radius * std::sin(angle),
+                                               30.0F},
+                                    glm::vec3 {0.0F, 0.0F, 0.0F},
+                                    glm::vec3 {0.0F, 0.0F, 1.0F});
+            auto projection =
+                glm::perspective(glm::radians(45.0F), 1.0F, 0.1F, 1000.0F);
+            projection[1][1] *= -1;
+            for (std::size_t frame = 0; frame < frame_count; ++frame) {
+              auto model = glm::rotate(glm::mat4 {1.0F},
+                                       static_cast<float>(frame) * 0.05F,
+                                       glm::vec3 {0.0F, 0.0F, 1.0F});
+              renderer.render(projection * view, model);
+            }
+          } catch (...) {
+            errors[i] = std::current_exception();
+          }
+        });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  bool failed = false;
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    if (!errors[i]) {
+      continue;
+    }
+    failed = true;
+    try {
+      std::rethrow_exception(errors[i]);
+    } catch (const std::exception& exception) {
+      std::cerr << "renderer " << i << " failed: " << exception.what()
+                << "\n";
+    } catch (...) {
+      std::cerr << "renderer " << i << " failed\n";
+    }
+  }
+  if (failed) {
+    return 1;
+  }
+
+  auto seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start_time)
+                     .count();
+  auto frames = static_cast<double>(thread_count * frame_count);
+  std::cout << thread_count << " renderers, " << frames << " frames in "
+            << seconds << "s, " << frames / seconds << " frames/s\n";
   return 0;
 }
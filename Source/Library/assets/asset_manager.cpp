@@ -0,0 +1,237 @@
+#include <cstring>
+#include <utility>
+
+#include "vktut/assets/asset_manager.hpp"
+
+#include <vktut/geometry/glb_file.hpp>
+#include <vktut/geometry/mesh.hpp>
+#include <vktut/geometry/meshlet_builder.hpp>
+#include <vktut/utilities/mapped_file.hpp>
+
+vktut::assets::asset_manager::asset_manager(backend backend,
+                                            std::size_t max_lod_levels,
+                                            utilities::thread_pool* pool)
+    : m_backend(std::make_shared<const asset_manager::backend>(
+        std::move(backend)))
+    , m_max_lod_levels(max_lod_levels)
+    , m_pool(pool)
+{
+}
+
+vktut::assets::asset_manager::mesh_handle
+vktut::assets::asset_manager::load_mesh(const std::string& path)
+{
+  std::lock_guard lock {m_mutex};
+  prune();
+  if (auto found = m_path_hashes.find(path); found != m_path_hashes.end()) {
+    auto entry = m_meshes.find(found->second);
+    if (auto loaded = entry != m_meshes.end() ? entry->second.lock()
+                                              : nullptr)
+    {
+      return loaded;
+    }
+  }
+  utilities::mapped_file file {path};
+  auto file_hash = hash(file.bytes());
+  m_path_hashes[path] = file_hash;
+  return load_mesh(file_hash, file.bytes());
+}
+
+vktut::assets::asset_manager::mesh_handle
+vktut::assets::asset_manager::load_mesh(std::span<const std::byte> file_bytes)
+{
+  std::lock_guard lock {m_mutex};
+  prune();
+  return load_mesh(hash(file_bytes), file_bytes);
+}
+
+vktut::assets::asset_manager::texture_handle
+vktut::assets::asset_manager::load_texture(const std::string& path)
+{
+  std::lock_guard lock {m_mutex};
+  prune();
+  if (auto found = m_path_hashes.find(path); found != m_path_hashes.end()) {
+    auto entry = m_textures.find(found->second);
+    if (auto loaded = entry != m_textures.end() ? entry->second.lock()
+                                                : nullptr)
+    {
+      return loaded;
+    }
+  }
+  utilities::mapped_file file {path};
+  auto file_hash = hash(file.bytes());
+  m_path_hashes[path] = file_hash;
+  return load_texture(file_hash, file.bytes());
+}
+
+vktut::assets::asset_manager::texture_handle
+vktut::assets::asset_manager::load_texture(
+    std::span<const std::byte> file_bytes)
+{
+  std::lock_guard lock {m_mutex};
+  prune();
+  return load_texture(hash(file_bytes), file_bytes);
+}
+
+vktut::assets::asset_manager::mesh_handle
+vktut::assets::asset_manager::find_mesh(const content_hash& hash)
+{
+  std::lock_guard lock {m_mutex};
+  auto found = m_meshes.find(hash);
+  return found != m_meshes.end() ? found->second.lock() : nullptr;
+}
+
+vktut::assets::asset_manager::texture_handle
+vktut::assets::asset_manager::find_texture(const content_hash& hash)
+{
+  std::lock_guard lock {m_mutex};
+  auto found = m_textures.find(hash);
+  return found != m_textures.end() ? found->second.lock() : nullptr;
+}
+
+vktut::assets::asset_manager::content_hash
+vktut::assets::asset_manager::hash(std::span<const std::byte> bytes)
+{
+  return content_hash {
+      .size = bytes.size(),
+      .digest = utilities::sha256::hash(bytes),
+  };
+}
+
+vktut::assets::asset_manager::backend
+vktut::assets::asset_manager::context_backend(
+    std::shared_ptr<vulkan::device_context> context)
+{
+  return backend {
+      .create_texture = [context](std::span<const std::byte> file_bytes)
+      { return context->create_texture(file_bytes); },
+      .destroy_texture = [context](const vulkan::texture& texture)
+      { context->destroy_texture(texture); },
+      .upload_buffer = [context](std::span<const std::byte> data,
+                                 VkBufferUsageFlags usage)
+      { return context->upload_buffer(data, usage); },
+      .destroy_buffer = [context](const vulkan::buffer_and_memory& buffer)
+      { context->destroy_buffer(buffer); },
+  };
+}
+
+std::size_t vktut::assets::asset_manager::content_hash_hash::operator()(
+    const content_hash& hash) const
+{
+  // the digest is already uniformly distributed
+  std::size_t result = 0;
+  std::memcpy(&result, hash.digest.data(), sizeof(result));
+  return result;
+}
+
+void vktut::assets::asset_manager::prune()
+{
+  std::erase_if(m_meshes,
+                [](const auto& entry) { return entry.second.expired(); });
+  std::erase_if(m_textures,
+                [](const auto& entry) { return entry.second.expired(); });
+  std::erase_if(m_path_hashes,
+                [this](const auto& entry)
+                {
+                  return !m_meshes.contains(entry.second)
+                      && !m_textures.contains(entry.second);
+                });
+}
+
+vktut::assets::asset_manager::mesh_handle
+vktut::assets::asset_manager::load_mesh(const content_hash& hash,
+                                        std::span<const std::byte> file_bytes)
+{
+  auto& entry = m_meshes[hash];
+  if (auto loaded = entry.lock()) {
+    return loaded;
+  }
+
+  auto loaded = geometry::glb_file::is_glb(file_bytes)
+      ? load_glb(file_bytes)
+      : build_mesh(geometry::mesh::load_obj(file_bytes, m_pool));
+
+  // the deleter keeps the backend alive, handles may outlive the manager
+  mesh_handle handle {new mesh {std::move(loaded)},
+                      [backend = m_backend](const mesh* released)
+                      {
+                        backend->destroy_buffer(released->index_buffer);
+                        backend->destroy_buffer(released->vertex_buffer);
+                        delete released;
+                      }};
+  entry = handle;
+  return handle;
+}
+
+vktut::assets::asset_manager::texture_handle
+vktut::assets::asset_manager::load_texture(
+    const content_hash& hash, std::span<const std::byte> file_bytes)
+{
+  auto& entry = m_textures[hash];
+  if (auto loaded = entry.lock()) {
+    return loaded;
+  }
+
+  texture_handle handle {
+      new vulkan::texture {m_backend->create_texture(file_bytes)},
+      [backend = m_backend](const vulkan::texture* released)
+      {
+        backend->destroy_texture(*released);
+        delete released;
+      }};
+  entry = handle;
+  return handle;
+}
+
+vktut::assets::mesh vktut::assets::asset_manager::load_glb(
+    std::span<const std::byte> file_bytes) const
+{
+  geometry::glb_file file {file_bytes};
+  auto packed = file.packed();
+  if (!packed) {
+    return build_mesh(file.to_mesh());
+  }
+
+  // already in the vertex layout, so the buffers are filled right from the
+  // file. the mesh is drawn as it is, without meshlets or coarser levels
+  auto center = (packed->min + packed->max) * 0.5F;
+  auto loaded = mesh {
+      .lod_chain =
+          geometry::lod_chain {
+              .levels = {geometry::lod_level {
+                  .first_index = 0,
+                  .index_count = packed->index_count,
+                  .error = 0,
+              }},
+              .center = center,
+              .radius = glm::distance(center, packed->max),
+          },
+  };
+  loaded.vertex_buffer = m_backend->upload_buffer(
+      packed->vertices, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+  loaded.index_buffer = m_backend->upload_buffer(
+      packed->indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+  return loaded;
+}
+
+vktut::assets::mesh vktut::assets::asset_manager::build_mesh(
+    geometry::mesh parsed) const
+{
+  auto loaded = mesh {
+      .vertices = std::move(parsed.vertices),
+      .indices = std::move(parsed.indices),
+  };
+  // meshlets reorder the full detail triangles, so they go before the lods
+  // that are appended behind them
+  loaded.meshlets =
+      geometry::meshlet_builder::build(loaded.vertices, loaded.indices);
+  loaded.lod_chain = geometry::lod_chain::build(
+      loaded.vertices, loaded.indices, m_max_lod_levels);
+  loaded.vertex_buffer = m_backend->upload_buffer(
+      std::as_bytes(std::span {loaded.vertices}),
+      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+  loaded.index_buffer =
+      m_backend->upload_buffer(std::as_bytes(std::span {loaded.indices}),
+                               VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+  return loaded;
+}
@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#include "vktut/geometry/glb_file.hpp"
+
+vktut::geometry::glb_file::glb_file(std::span<const std::byte> bytes)
+{
+  if (!is_glb(bytes) || read_u32(bytes, 4) != 2) {
+    throw std::runtime_error {"failed to open glb file, not glTF 2.0!"};
+  }
+  auto length = std::min<std::size_t>(read_u32(bytes, 8), bytes.size());
+
+  // a JSON chunk, then an optional BIN chunk, chunks are 4 byte aligned
+  std::size_t offset = 12;
+  bool has_document = false;
+  while (offset + 8 <= length) {
+    std::size_t chunk_length = read_u32(bytes, offset);
+    std::uint32_t chunk_type = read_u32(bytes, offset + 4);
+    offset += 8;
+    if (chunk_length > length - offset) {
+      throw std::runtime_error {"failed to open glb file, chunk overflows!"};
+    }
+    auto chunk = bytes.subspan(offset, chunk_length);
+    if (chunk_type == 0x4E4F534A && !has_document) {
+      m_document = utilities::json::parse(std::string_view {
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+          reinterpret_cast<const char*>(chunk.data()),
+          chunk.size()});
+      has_document = true;
+    } else if (chunk_type == 0x004E4942 && m_binary.empty()) {
+      m_binary = chunk;
+    }
+    offset += (chunk_length + 3) & ~std::size_t {3};
+  }
+  if (!has_document) {
+    throw std::runtime_error {"failed to open glb file, no JSON chunk!"};
+  }
+}
+
+bool vktut::geometry::glb_file::is_glb(std::span<const std::byte> bytes)
+{
+  return bytes.size() >= 12 && read_u32(bytes, 0) == 0x46546C67;
+}
+
+std::optional<vktut::geometry::glb_file::packed_primitive>
+vktut::geometry::glb_file::packed() const
+{
+  const auto* meshes = m_document.find("meshes");
+  if (meshes == nullptr || meshes->size() != 1
+      || meshes->at(0).at("primitives").size() != 1)
+  {
+    return std::nullopt;
+  }
+  const auto& primitive = meshes->at(0).at("primitives").at(0);
+  const auto& attributes = primitive.at("attributes");
+  const auto* position_index = attributes.find("POSITION");
+  const auto* color_index = attributes.find("COLOR_0");
+  const auto* tex_coord_index = attributes.find("TEXCOORD_0");
+  const auto* indices_index = primitive.find("indices");
+  if (primitive.index_or("mode", 4) != 4 || position_index == nullptr
+      || color_index == nullptr || tex_coord_index == nullptr
+      || indices_index == nullptr)
+  {
+    return std::nullopt;
+  }
+
+  auto position = accessor(position_index->index());
+  auto color = accessor(color_index->index());
+  auto tex_coord = accessor(tex_coord_index->index());
+  auto indices = accessor(indices_index->index());
+  // every attribute a float vector at its shaders::vertex offset of the same
+  // vertices
+  auto in_place = [&position](const accessor_view& view,
+                              std::size_t components,
+                              std::size_t offset)
+  {
+    return view.component_type == 5126 && view.component_count == components
+        && view.stride == sizeof(shaders::vertex)
+        && view.count == position.count
+        && view.bytes.data() == position.bytes.data() + offset;
+  };
+  const auto& position_accessor =
+      m_document.at("accessors").at(position_index->index());
+  const auto* min = position_accessor.find("min");
+  const auto* max = position_accessor.find("max");
+  if (!in_place(position, 3, 0)
+      || !in_place(color, 3, offsetof(shaders::vertex, color))
+      || !in_place(tex_coord, 2, offsetof(shaders::vertex, tex_coord))
+      || indices.component_type != 5125 || indices.component_count != 1
+      || indices.stride != sizeof(std::uint32_t) || min == nullptr
+      || max == nullptr || position.count == 0)
+  {
+    return std::nullopt;
+  }
+  // the indices go to the gpu as they are, so one past the vertices would be
+  // an out of bounds vertex fetch. to_mesh() rejects those files instead
+  if (indices.count % 3 != 0) {
+    return std::nullopt;
+  }
+  for (std::size_t index = 0; index < indices.count; ++index) {
+    if (read_index(indices, index) >= position.count) {
+      return std::nullopt;
+    }
+  }
+
+  return packed_primitive {
+      // the texture coordinates end the last vertex, so the whole run is
+      // inside the binary chunk
+      .vertices =
+          std::span {position.bytes.data(),
+                     position.count * sizeof(shaders::vertex)},
+      .indices = indices.bytes,
+      .vertex_count = static_cast<std::uint32_t>(position.count),
+      .index_count = static_cast<std::uint32_t>(indices.count),
+      .min = to_vec3(*min),
+      .max = to_vec3(*max),
+  };
+}
+
+vktut::geometry::mesh vktut::geometry::glb_file::to_mesh() const
+{
+  mesh result {};
+  const auto* meshes = m_document.find("meshes");
+  for (std::size_t i = 0; meshes != nullptr && i < meshes->size(); ++i) {
+    const auto& primitives = meshes->at(i).at("primitives");
+    for (std::size_t j = 0; j < primitives.size(); ++j) {
+      const auto& primitive = primitives.at(j);
+      if (primitive.index_or("mode", 4) != 4) {
+        continue;
+      }
+      const auto& attributes = primitive.at("attributes");
+      auto position = accessor(attributes.at("POSITION").index());
+      if (position.component_count != 3) {
+        throw std::runtime_error {"failed to read glb positions!"};
+      }
+      std::optional<accessor_view> color;
+      if (const auto* color_index = attributes.find("COLOR_0")) {
+        color = accessor(color_index->index());
+      }
+      std::optional<accessor_view> tex_coord;
+      if (const auto* tex_coord_index = attributes.find("TEXCOORD_0")) {
+        tex_coord = accessor(tex_coord_index->index());
+      }
+
+      auto first_vertex = static_cast<std::uint32_t>(result.vertices.size());
+      for (std::size_t vertex = 0; vertex < position.count; ++vertex) {
+        auto converted = shaders::vertex {};
+        converted.pos = {
+            read_float(position, vertex, 0),
+            read_float(position, vertex, 1),
+            read_float(position, vertex, 2),
+        };
+        converted.color = {1, 1, 1};
+        if (color && vertex < color->count) {
+          converted.color = {
+              read_float(*color, vertex, 0),
+              read_float(*color, vertex, 1),
+              read_float(*color, vertex, 2),
+          };
+        }
+        // glTF puts the origin top left, like vulkan, so v is not flipped
+        if (tex_coord && vertex < tex_coord->count) {
+          converted.tex_coord = {
+              read_float(*tex_coord, vertex, 0),
+              read_float(*tex_coord, vertex, 1),
+          };
+        }
+        result.vertices.push_back(converted);
+      }
+
+      if (const auto* indices_index = primitive.find("indices")) {
+        auto indices = accessor(indices_index->index());
+        for (std::size_t index = 0; index < indices.count; ++index) {
+          auto vertex = read_index(indices, index);
+          if (vertex >= position.count) {
+            throw std::runtime_error {"failed to read glb indices!"};
+          }
+          result.indices.push_back(first_vertex + vertex);
+        }
+      } else {
+        for (std::size_t vertex = 0; vertex < position.count; ++vertex) {
+          result.indices.push_back(first_vertex
+                                   + static_cast<std::uint32_t>(vertex));
+        }
+      }
+    }
+  }
+  return result;
+}
+
+vktut::geometry::glb_file::accessor_view vktut::geometry::glb_file::accessor(
+    std::uint32_t index) const
+{
+  const auto& description = m_document.at("accessors").at(index);
+  if (description.find("sparse") != nullptr
+      || description.find("bufferView") == nullptr)
+  {
+    throw std::runtime_error {"failed to read glb accessor, unsupported!"};
+  }
+  const auto& buffer_view = m_document.at("bufferViews")
+                                .at(description.at("bufferView").index());
+  const auto& buffer =
+      m_document.at("buffers").at(buffer_view.at("buffer").index());
+  if (buffer_view.at("buffer").index() != 0 || buffer.find("uri") != nullptr) {
+    throw std::runtime_error {"failed to read glb accessor, external buffer!"};
+  }
+
+  auto component_type = description.at("componentType").index();
+  auto components = component_count(description.at("type").string());
+  std::size_t element_size = component_size(component_type) * components;
+  std::size_t count = description.at("count").index();
+  std::size_t stride = buffer_view.index_or("byteStride", 0);
+  if (stride == 0) {
+    stride = element_size;
+  }
+  std::size_t view_offset = buffer_view.index_or("byteOffset", 0);
+  std::size_t view_length = buffer_view.at("byteLength").index();
+  std::size_t offset = description.index_or("byteOffset", 0);
+  std::size_t length = count == 0 ? 0 : stride * (count - 1) + element_size;
+  if (view_offset + view_length > m_binary.size()
+      || offset + length > view_length)
+  {
+    throw std::runtime_error {"failed to read glb accessor, out of bounds!"};
+  }
+
+  return accessor_view {
+      .bytes = m_binary.subspan(view_offset + offset, length),
+      .count = count,
+      .stride = stride,
+      .component_type = component_type,
+      .component_count = components,
+  };
+}
+
+std::size_t vktut::geometry::glb_file::component_size(
+    std::uint32_t component_type)
+{
+  switch (component_type) {
+    case 5120:  // BYTE
+    case 5121:  // UNSIGNED_BYTE
+      return 1;
+    case 5122:  // SHORT
+    case 5123:  // UNSIGNED_SHORT
+      return 2;
+    case 5125:  // UNSIGNED_INT
+    case 5126:  // FLOAT
+      return 4;
+    default:
+      throw std::runtime_error {"failed to read glb accessor component!"};
+  }
+}
+
+std::size_t vktut::geometry::glb_file::component_count(
+    const std::string& type)
+{
+  if (type == "SCALAR") {
+    return 1;
+  }
+  if (type == "VEC2") {
+    return 2;
+  }
+  if (type == "VEC3") {
+    return 3;
+  }
+  if (type == "VEC4") {
+    return 4;
+  }
+  throw std::runtime_error {"failed to read glb accessor type!"};
+}
+
+float vktut::geometry::glb_file::read_float(const accessor_view& view,
+                                            std::size_t element,
+                                            std::size_t component)
+{
+  const auto* source = view.bytes.data() + element * view.stride
+      + component * component_size(view.component_type);
+  // integer components only appear normalized in the attributes read here
+  switch (view.component_type) {
+    case 5126: {
+      float value = 0;
+      std::memcpy(&value, source, sizeof(value));
+      return value;
+    }
+    case 5121:
+      return static_cast<float>(std::to_integer<std::uint8_t>(*source))
+          / 255.0F;
+    case 5123: {
+      std::uint16_t value = 0;
+      std::memcpy(&value, source, sizeof(value));
+      return static_cast<float>(value) / 65535.0F;
+    }
+    case 5120:
+      return std::max(
+          static_cast<float>(std::to_integer<std::int8_t>(*source)) / 127.0F,
+          -1.0F);
+    case 5122: {
+      std::int16_t value = 0;
+      std::memcpy(&value, source, sizeof(value));
+      return std::max(static_cast<float>(value) / 32767.0F, -1.0F);
+    }
+    default:
+      throw std::runtime_error {"failed to read glb attribute!"};
+  }
+}
+
+std::uint32_t vktut::geometry::glb_file::read_index(const accessor_view& view,
+                                                    std::size_t element)
+{
+  const auto* source = view.bytes.data() + element * view.stride;
+  switch (view.component_type) {
+    case 5121:
+      return std::to_integer<std::uint32_t>(*source);
+    case 5123: {
+      std::uint16_t value = 0;
+      std::memcpy(&value, source, sizeof(value));
+      return value;
+    }
+    case 5125: {
+      std::uint32_t value = 0;
+      std::memcpy(&value, source, sizeof(value));
+      return value;
+    }
+    default:
+      throw std::runtime_error {"failed to read glb indices!"};
+  }
+}
+
+glm::vec3 vktut::geometry::glb_file::to_vec3(const utilities::json& array)
+{
+  return glm::vec3 {
+      static_cast<float>(array.at(0).number()),
+      static_cast<float>(array.at(1).number()),
+      static_cast<float>(array.at(2).number()),
+  };
+}
+
+std::uint32_t vktut::geometry::glb_file::read_u32(
+    std::span<const std::byte> bytes, std::size_t offset)
+{
+  // glb is little endian, like every platform this builds for
+  std::uint32_t value = 0;
+  std::memcpy(&value, bytes.data() + offset, sizeof(value));
+  return value;
+}
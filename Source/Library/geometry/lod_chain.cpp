@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <limits>
+
+#include "vktut/geometry/lod_chain.hpp"
+
+#include <vktut/geometry/mesh_simplifier.hpp>
+
+vktut::geometry::lod_chain vktut::geometry::lod_chain::build(
+    std::span<const shaders::vertex> vertices,
+    std::vector<std::uint32_t>& indices,
+    std::size_t max_levels)
+{
+  lod_chain chain {};
+
+  glm::vec3 min {std::numeric_limits<float>::max()};
+  glm::vec3 max {std::numeric_limits<float>::lowest()};
+  for (const auto& vertex : vertices) {
+    min = glm::min(min, vertex.pos);
+    max = glm::max(max, vertex.pos);
+  }
+  chain.center = (min + max) * 0.5F;
+  chain.radius = 0;
+  for (const auto& vertex : vertices) {
+    chain.radius =
+        std::max(chain.radius, glm::distance(chain.center, vertex.pos));
+  }
+
+  chain.levels.push_back(lod_level {
+      .first_index = 0,
+      .index_count = static_cast<std::uint32_t>(indices.size()),
+      .error = 0,
+  });
+
+  // past a few percent of the mesh's size a level looks like a different mesh
+  float max_error = chain.radius * 0.05F;
+  mesh_simplifier simplifier {vertices};
+  while (chain.levels.size() < max_levels) {
+    const auto previous = chain.levels.back();
+    std::span<const std::uint32_t> previous_indices {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        indices.data() + previous.first_index,
+        previous.index_count};
+
+    float error = 0;
+    auto simplified = simplifier.simplify(
+        previous_indices, previous.index_count / 2, max_error, error);
+    // a level that barely got smaller isn't worth its index memory
+    if (simplified.empty() || simplified.size() > previous.index_count * 9 / 10)
+    {
+      break;
+    }
+
+    chain.levels.push_back(lod_level {
+        .first_index = static_cast<std::uint32_t>(indices.size()),
+        .index_count = static_cast<std::uint32_t>(simplified.size()),
+        // each level was simplified from the last, so their errors add up
+        .error = previous.error + error,
+    });
+    indices.insert(indices.end(), simplified.begin(), simplified.end());
+  }
+
+  return chain;
+}
+
+const vktut::geometry::lod_level& vktut::geometry::lod_chain::select(
+    float pixels_per_unit, float pixel_threshold) const
+{
+  auto coarsest = levels.begin();
+  for (auto it = levels.begin(); it != levels.end(); ++it) {
+    if (it->error * pixels_per_unit <= pixel_threshold) {
+      coarsest = it;
+    }
+  }
+  return *coarsest;
+}
@@ -0,0 +1,51 @@
+#include <unordered_map>
+
+#include "vktut/geometry/mesh.hpp"
+
+#include <vktut/geometry/obj_parser.hpp>
+#include <vktut/utilities/mapped_file.hpp>
+
+vktut::geometry::mesh vktut::geometry::mesh::load_obj(
+    std::string_view path, utilities::thread_pool* pool)
+{
+  utilities::mapped_file model_file {path};
+  return load_obj(model_file.bytes(), pool);
+}
+
+vktut::geometry::mesh vktut::geometry::mesh::load_obj(
+    std::span<const std::byte> bytes, utilities::thread_pool* pool)
+{
+  auto parsed = obj_parser::parse(bytes, pool);
+
+  mesh result {};
+  result.indices.reserve(parsed.corners.size());
+  std::unordered_map<shaders::vertex, std::uint32_t> unique_vertices;
+  unique_vertices.reserve(parsed.positions.size() / 3);
+
+  for (const auto& corner : parsed.corners) {
+    auto vert = shaders::vertex {};
+    vert.pos = {
+        parsed.positions[3 * static_cast<std::size_t>(corner.position) + 0],
+        parsed.positions[3 * static_cast<std::size_t>(corner.position) + 1],
+        parsed.positions[3 * static_cast<std::size_t>(corner.position) + 2],
+    };
+    vert.color = {1, 1, 1};
+    if (corner.tex_coord != obj_parser::no_tex_coord) {
+      vert.tex_coord = {
+          parsed.tex_coords[2 * static_cast<std::size_t>(corner.tex_coord)],
+          1.0F
+              - parsed.tex_coords[2 * static_cast<std::size_t>(corner.tex_coord)
+                                  + 1],
+      };
+    }
+
+    auto [found, inserted] = unique_vertices.try_emplace(
+        vert, static_cast<std::uint32_t>(result.vertices.size()));
+    if (inserted) {
+      result.vertices.emplace_back(vert);
+    }
+    result.indices.push_back(found->second);
+  }
+
+  return result;
+}
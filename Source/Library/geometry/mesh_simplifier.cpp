@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+#include "vktut/geometry/mesh_simplifier.hpp"
+
+vktut::geometry::mesh_simplifier::quadric
+vktut::geometry::mesh_simplifier::quadric::from_plane(
+    const glm::dvec3& normal, double distance, double weight)
+{
+  double a = normal.x;
+  double b = normal.y;
+  double c = normal.z;
+  double d = distance;
+  return quadric {
+      .a2 = weight * a * a,
+      .ab = weight * a * b,
+      .ac = weight * a * c,
+      .ad = weight * a * d,
+      .b2 = weight * b * b,
+      .bc = weight * b * c,
+      .bd = weight * b * d,
+      .c2 = weight * c * c,
+      .cd = weight * c * d,
+      .d2 = weight * d * d,
+      .weight = weight,
+  };
+}
+
+vktut::geometry::mesh_simplifier::quadric&
+vktut::geometry::mesh_simplifier::quadric::operator+=(const quadric& other)
+{
+  a2 += other.a2;
+  ab += other.ab;
+  ac += other.ac;
+  ad += other.ad;
+  b2 += other.b2;
+  bc += other.bc;
+  bd += other.bd;
+  c2 += other.c2;
+  cd += other.cd;
+  d2 += other.d2;
+  weight += other.weight;
+  return *this;
+}
+
+double vktut::geometry::mesh_simplifier::quadric::evaluate(
+    const glm::dvec3& point) const
+{
+  double x = point.x;
+  double y = point.y;
+  double z = point.z;
+  double sum = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+      + b2 * y * y + 2 * bc * y * z + 2 * bd * y + c2 * z * z + 2 * cd * z
+      + d2;
+  // rounding can push a zero error slightly negative
+  return weight > 0 ? std::max(sum, 0.0) / weight : 0.0;
+}
+
+vktut::geometry::mesh_simplifier::mesh_simplifier(
+    std::span<const shaders::vertex> vertices)
+    : m_seam(vertices.size(), false)
+{
+  m_positions.reserve(vertices.size());
+  std::unordered_map<glm::vec3, std::uint32_t> first_with_position;
+  for (std::uint32_t i = 0; i < vertices.size(); ++i) {
+    m_positions.push_back(vertices[i].pos);
+    auto [it, inserted] = first_with_position.emplace(vertices[i].pos, i);
+    if (!inserted) {
+      m_seam[it->second] = true;
+      m_seam[i] = true;
+    }
+  }
+}
+
+std::vector<std::uint32_t> vktut::geometry::mesh_simplifier::simplify(
+    std::span<const std::uint32_t> indices,
+    std::size_t target_index_count,
+    float max_error,
+    float& result_error) const
+{
+  std::vector<std::uint32_t> result {indices.begin(), indices.end()};
+  std::size_t vertex_count = m_positions.size();
+  result_error = 0;
+
+  auto position = [this](std::uint32_t vertex)
+  { return glm::dvec3 {m_positions[vertex]}; };
+  auto edge_key = [](std::uint32_t a, std::uint32_t b)
+  {
+    return (static_cast<std::uint64_t>(std::min(a, b)) << 32U)
+        | std::max(a, b);
+  };
+
+  std::vector<quadric> quadrics(vertex_count, quadric {});
+  std::unordered_map<std::uint64_t, std::uint32_t> edge_uses;
+  for (std::size_t i = 0; i + 2 < result.size(); i += 3) {
+    std::array corners = {result[i], result[i + 1], result[i + 2]};
+    auto p0 = position(corners[0]);
+    auto normal = glm::cross(position(corners[1]) - p0,
+                             position(corners[2]) - p0);
+    double double_area = glm::length(normal);
+    if (double_area > 0) {
+      normal /= double_area;
+      auto plane =
+          quadric::from_plane(normal, -glm::dot(normal, p0), double_area / 2);
+      for (auto corner : corners) {
+        quadrics[corner] += plane;
+      }
+    }
+    for (std::size_t j = 0; j < 3; ++j) {
+      ++edge_uses[edge_key(corners[j], corners[(j + 1) % 3])];
+    }
+  }
+
+  // open borders only have one triangle on an edge, collapsing them would
+  // shrink the outline of the mesh
+  std::vector<bool> locked = m_seam;
+  for (const auto& [key, uses] : edge_uses) {
+    if (uses == 1) {
+      locked[key >> 32U] = true;
+      locked[key & 0xffffffffU] = true;
+    }
+  }
+
+  double max_error_squared =
+      static_cast<double>(max_error) * static_cast<double>(max_error);
+  std::vector<collapse> collapses;
+  std::vector<std::uint32_t> adjacency_offsets;
+  std::vector<std::uint32_t> adjacency;
+  std::vector<bool> touched;
+  while (result.size() > target_index_count) {
+    collapses.clear();
+    for (const auto& [key, uses] : edge_uses) {
+      auto a = static_cast<std::uint32_t>(key >> 32U);
+      auto b = static_cast<std::uint32_t>(key & 0xffffffffU);
+      if (locked[a] && locked[b]) {
+        continue;
+      }
+      quadric combined = quadrics[a];
+      combined += quadrics[b];
+      double a_into_b = locked[a] ? std::numeric_limits<double>::infinity()
+                                  : combined.evaluate(position(b));
+      double b_into_a = locked[b] ? std::numeric_limits<double>::infinity()
+                                  : combined.evaluate(position(a));
+      collapses.push_back(a_into_b <= b_into_a
+                              ? collapse {a, b, a_into_b}
+                              : collapse {b, a, b_into_a});
+    }
+    std::sort(collapses.begin(),
+              collapses.end(),
+              [](const auto& lhs, const auto& rhs)
+              { return lhs.error < rhs.error; });
+
+    // vertex to triangle adjacency for this pass
+    adjacency_offsets.assign(vertex_count + 1, 0);
+    for (auto vertex : result) {
+      ++adjacency_offsets[vertex + 1];
+    }
+    std::partial_sum(adjacency_offsets.begin(),
+                     adjacency_offsets.end(),
+                     adjacency_offsets.begin());
+    adjacency.resize(result.size());
+    std::vector<std::uint32_t> fill {adjacency_offsets.begin(),
+                                     adjacency_offsets.end() - 1};
+    for (std::uint32_t i = 0; i < result.size(); ++i) {
+      adjacency[fill[result[i]]++] = i / 3;
+    }
+
+    // every collapse removes about two triangles, stop once enough are queued
+    std::size_t triangles_to_remove = (result.size() - target_index_count) / 3;
+    std::size_t triangles_removed = 0;
+    touched.assign(vertex_count, false);
+    for (const auto& candidate : collapses) {
+      if (candidate.error > max_error_squared
+          || triangles_removed >= std::max<std::size_t>(triangles_to_remove, 1))
+      {
+        break;
+      }
+      if (touched[candidate.from] || touched[candidate.to]) {
+        continue;
+      }
+
+      std::span<const std::uint32_t> adjacent_triangles {
+          adjacency.begin() + adjacency_offsets[candidate.from],
+          adjacency.begin() + adjacency_offsets[candidate.from + 1]};
+      if (flips_triangle(
+              result, adjacent_triangles, candidate.from, candidate.to))
+      {
+        continue;
+      }
+
+      // everything around the collapse changed shape, so its neighbors wait
+      // for the next pass where their adjacency and errors are fresh
+      for (auto triangle : adjacent_triangles) {
+        for (std::size_t corner = 0; corner < 3; ++corner) {
+          auto& vertex = result[3 * triangle + corner];
+          touched[vertex] = true;
+          if (vertex == candidate.from) {
+            vertex = candidate.to;
+          }
+        }
+      }
+      quadrics[candidate.to] += quadrics[candidate.from];
+      result_error = std::max(result_error,
+                              static_cast<float>(std::sqrt(candidate.error)));
+      triangles_removed += 2;
+    }
+
+    if (triangles_removed == 0) {
+      break;
+    }
+
+    // drop triangles that collapsed to a line and rebuild the edge set
+    std::size_t kept = 0;
+    edge_uses.clear();
+    for (std::size_t i = 0; i + 2 < result.size(); i += 3) {
+      std::uint32_t a = result[i];
+      std::uint32_t b = result[i + 1];
+      std::uint32_t c = result[i + 2];
+      if (a == b || b == c || a == c) {
+        continue;
+      }
+      result[kept++] = a;
+      result[kept++] = b;
+      result[kept++] = c;
+      ++edge_uses[edge_key(a, b)];
+      ++edge_uses[edge_key(b, c)];
+      ++edge_uses[edge_key(c, a)];
+    }
+    result.resize(kept);
+  }
+
+  return result;
+}
+
+bool vktut::geometry::mesh_simplifier::flips_triangle(
+    const std::vector<std::uint32_t>& indices,
+    std::span<const std::uint32_t> adjacent_triangles,
+    std::uint32_t from,
+    std::uint32_t to) const
+{
+  for (auto triangle : adjacent_triangles) {
+    std::array corners = {indices[3 * triangle],
+                          indices[3 * triangle + 1],
+                          indices[3 * triangle + 2]};
+    // triangles along the collapsed edge disappear, they can't flip
+    if (std::find(corners.begin(), corners.end(), to) != corners.end()) {
+      continue;
+    }
+
+    auto normal_with = [this, &corners, from](std::uint32_t replacement)
+    {
+      std::array<glm::vec3, 3> points {};
+      for (std::size_t i = 0; i < 3; ++i) {
+        points[i] = m_positions[corners[i] == from ? replacement : corners[i]];
+      }
+      return glm::cross(points[1] - points[0], points[2] - points[0]);
+    };
+    if (glm::dot(normal_with(from), normal_with(to)) <= 0) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+#include "vktut/geometry/meshlet_builder.hpp"
+
+std::vector<vktut::shaders::meshlet> vktut::geometry::meshlet_builder::build(
+    std::span<const shaders::vertex> vertices,
+    std::span<std::uint32_t> indices)
+{
+  std::size_t triangle_count = indices.size() / 3;
+
+  // vertex to triangle adjacency
+  std::vector<std::uint32_t> adjacency_offsets(vertices.size() + 1, 0);
+  for (auto vertex : indices) {
+    ++adjacency_offsets[vertex + 1];
+  }
+  std::partial_sum(adjacency_offsets.begin(),
+                   adjacency_offsets.end(),
+                   adjacency_offsets.begin());
+  std::vector<std::uint32_t> adjacency(indices.size());
+  std::vector<std::uint32_t> fill {adjacency_offsets.begin(),
+                                   adjacency_offsets.end() - 1};
+  for (std::uint32_t i = 0; i < indices.size(); ++i) {
+    adjacency[fill[indices[i]]++] = i / 3;
+  }
+
+  constexpr auto no_meshlet = std::numeric_limits<std::uint32_t>::max();
+  std::vector<std::uint32_t> vertex_meshlet(vertices.size(), no_meshlet);
+  std::vector<bool> emitted(triangle_count, false);
+  std::vector<std::uint32_t> reordered;
+  reordered.reserve(indices.size());
+  std::vector<shaders::meshlet> meshlets;
+
+  auto new_vertices = [&](std::uint32_t triangle, std::uint32_t meshlet)
+  {
+    std::size_t count = 0;
+    for (std::size_t corner = 0; corner < 3; ++corner) {
+      count += vertex_meshlet[indices[3 * triangle + corner]] != meshlet
+          ? 1
+          : 0;
+    }
+    return count;
+  };
+
+  std::size_t next_seed = 0;
+  std::size_t emitted_count = 0;
+  while (emitted_count < triangle_count) {
+    auto meshlet_index = static_cast<std::uint32_t>(meshlets.size());
+    auto first_index = static_cast<std::uint32_t>(reordered.size());
+    std::size_t meshlet_vertices = 0;
+    std::size_t meshlet_triangles = 0;
+    auto last_triangle = no_meshlet;
+
+    while (meshlet_triangles < max_triangles) {
+      // prefer neighbours of the triangle just added, they share the most
+      // vertices with the meshlet and keep it compact
+      auto best = no_meshlet;
+      std::size_t best_cost = 4;
+      if (last_triangle != no_meshlet) {
+        for (std::size_t corner = 0; corner < 3; ++corner) {
+          auto vertex = indices[3 * last_triangle + corner];
+          for (auto i = adjacency_offsets[vertex];
+               i < adjacency_offsets[vertex + 1];
+               ++i)
+          {
+            auto candidate = adjacency[i];
+            if (emitted[candidate]) {
+              continue;
+            }
+            auto cost = new_vertices(candidate, meshlet_index);
+            if (cost < best_cost) {
+              best = candidate;
+              best_cost = cost;
+            }
+          }
+        }
+      }
+      if (best == no_meshlet) {
+        while (next_seed < triangle_count && emitted[next_seed]) {
+          ++next_seed;
+        }
+        if (next_seed == triangle_count) {
+          break;
+        }
+        best = static_cast<std::uint32_t>(next_seed);
+        best_cost = new_vertices(best, meshlet_index);
+      }
+      if (meshlet_vertices + best_cost > max_vertices) {
+        break;
+      }
+
+      for (std::size_t corner = 0; corner < 3; ++corner) {
+        auto vertex = indices[3 * best + corner];
+        vertex_meshlet[vertex] = meshlet_index;
+        reordered.push_back(vertex);
+      }
+      emitted[best] = true;
+      ++emitted_count;
+      meshlet_vertices += best_cost;
+      ++meshlet_triangles;
+      last_triangle = best;
+    }
+
+    auto index_count =
+        static_cast<std::uint32_t>(reordered.size()) - first_index;
+    auto meshlet = bounds(
+        vertices, std::span {reordered}.subspan(first_index, index_count));
+    meshlet.first_index = first_index;
+    meshlet.index_count = index_count;
+    meshlets.push_back(meshlet);
+  }
+
+  std::copy(reordered.begin(), reordered.end(), indices.begin());
+  return meshlets;
+}
+
+vktut::shaders::meshlet vktut::geometry::meshlet_builder::bounds(
+    std::span<const shaders::vertex> vertices,
+    std::span<const std::uint32_t> indices)
+{
+  glm::vec3 min {std::numeric_limits<float>::max()};
+  glm::vec3 max {std::numeric_limits<float>::lowest()};
+  for (auto vertex : indices) {
+    min = glm::min(min, vertices[vertex].pos);
+    max = glm::max(max, vertices[vertex].pos);
+  }
+  glm::vec3 center = (min + max) * 0.5F;
+  float radius = 0;
+  for (auto vertex : indices) {
+    radius = std::max(radius, glm::distance(center, vertices[vertex].pos));
+  }
+
+  std::vector<glm::vec3> normals;
+  normals.reserve(indices.size() / 3);
+  glm::vec3 axis {0.0F};
+  for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const auto& a = vertices[indices[i]].pos;
+    const auto& b = vertices[indices[i + 1]].pos;
+    const auto& c = vertices[indices[i + 2]].pos;
+    auto normal = glm::cross(b - a, c - a);
+    float length = glm::length(normal);
+    // degenerate triangles have no facing, they can't rule anything out
+    if (length > 0) {
+      normals.push_back(normal / length);
+      axis += normals.back();
+    }
+  }
+
+  float cone_cos = -1;
+  float axis_length = glm::length(axis);
+  if (axis_length > 0) {
+    axis /= axis_length;
+    cone_cos = 1;
+    for (const auto& normal : normals) {
+      cone_cos = std::min(cone_cos, glm::dot(normal, axis));
+    }
+  }
+
+  return shaders::meshlet {
+      .sphere = {center, radius},
+      .cone = {axis, cone_cos},
+      .first_index = 0,
+      .index_count = 0,
+      .padding = {0, 0},
+  };
+}
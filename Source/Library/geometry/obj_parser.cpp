@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <latch>
+#include <stdexcept>
+#include <utility>
+
+#include "vktut/geometry/obj_parser.hpp"
+
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
+
+// a template so the chunk loops inline the job, only the pool's own queue
+// goes through std::function
+template<typename Job>
+void vktut::geometry::obj_parser::for_each_chunk(std::size_t chunk_count,
+                                                 utilities::thread_pool* pool,
+                                                 const Job& job)
+{
+  if (pool == nullptr || chunk_count <= 1) {
+    for (std::size_t i = 0; i < chunk_count; ++i) {
+      job(i);
+    }
+    return;
+  }
+
+  // errors can't leave a worker, they are rethrown here instead
+  std::vector<std::exception_ptr> errors(chunk_count);
+  std::latch done {static_cast<std::ptrdiff_t>(chunk_count)};
+  for (std::size_t i = 0; i < chunk_count; ++i) {
+    pool->submit(
+        [&job, &errors, &done, i]
+        {
+          try {
+            job(i);
+          } catch (...) {
+            errors[i] = std::current_exception();
+          }
+          done.count_down();
+        });
+  }
+  done.wait();
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+vktut::geometry::obj_parser::result vktut::geometry::obj_parser::parse(
+    std::span<const std::byte> bytes, utilities::thread_pool* pool)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto* begin = reinterpret_cast<const char*>(bytes.data());
+  const auto* end = begin + bytes.size();
+
+  // every chunk but the last runs up to and including a line break
+  std::vector<std::pair<const char*, const char*>> ranges;
+  for (const auto* first = begin; first < end;) {
+    const auto* last =
+        first + std::min(chunk_size, static_cast<std::size_t>(end - first));
+    if (last < end) {
+      last = std::min(find_line_end(last, end) + 1, end);
+    }
+    ranges.emplace_back(first, last);
+    first = last;
+  }
+
+  std::vector<chunk> chunks(ranges.size());
+  for_each_chunk(
+      chunks.size(),
+      pool,
+      [&](std::size_t i)
+      { parse_chunk(ranges[i].first, ranges[i].second, chunks[i]); });
+
+  // where every chunk's elements land once they are all put together
+  result parsed {};
+  std::size_t position_count = 0;
+  std::size_t tex_coord_count = 0;
+  std::size_t corner_count = 0;
+  for (auto& part : chunks) {
+    part.positions_offset = static_cast<std::uint32_t>(position_count);
+    part.tex_coords_offset = static_cast<std::uint32_t>(tex_coord_count);
+    part.corners_offset = corner_count;
+    position_count += part.positions.size() / 3;
+    tex_coord_count += part.tex_coords.size() / 2;
+    corner_count += part.triangulated_corner_count;
+  }
+  if (position_count > no_tex_coord || tex_coord_count > no_tex_coord) {
+    throw std::runtime_error {"failed to index obj file, too many vertices!"};
+  }
+  parsed.positions.resize(3 * position_count);
+  parsed.tex_coords.resize(2 * tex_coord_count);
+  parsed.corners.resize(corner_count);
+
+  for_each_chunk(
+      chunks.size(),
+      pool,
+      [&](std::size_t i)
+      {
+        const auto& part = chunks[i];
+        std::copy(part.positions.begin(),
+                  part.positions.end(),
+                  parsed.positions.begin()
+                      + std::size_t {3} * part.positions_offset);
+        std::copy(part.tex_coords.begin(),
+                  part.tex_coords.end(),
+                  parsed.tex_coords.begin()
+                      + std::size_t {2} * part.tex_coords_offset);
+        resolve_chunk(part,
+                      static_cast<std::uint32_t>(position_count),
+                      static_cast<std::uint32_t>(tex_coord_count),
+                      parsed.corners.data() + part.corners_offset);
+      });
+  return parsed;
+}
+
+void vktut::geometry::obj_parser::parse_chunk(const char* first,
+                                              const char* last,
+                                              chunk& out)
+{
+  // sized for a typical mix of records, so the vectors rarely grow while the
+  // chunk is parsed and never by more than a doubling or two
+  auto bytes = static_cast<std::size_t>(last - first);
+  out.positions.reserve(bytes / bytes_per_position_float);
+  out.tex_coords.reserve(bytes / bytes_per_tex_coord_float);
+  out.corners.reserve(bytes / bytes_per_corner);
+  out.faces.reserve(bytes / (3 * bytes_per_corner));
+
+  while (first < last) {
+    const auto* line_end = find_line_end(first, last);
+    const auto* cursor = skip_blanks(first, line_end);
+    // v, vt and f followed by a blank, anything else is skipped
+    auto remaining = line_end - cursor;
+    bool vertex = remaining >= 2 && cursor[0] == 'v' && is_blank(cursor[1]);
+    bool tex_coord = remaining >= 3 && cursor[0] == 'v' && cursor[1] == 't'
+        && is_blank(cursor[2]);
+    bool polygon = remaining >= 2 && cursor[0] == 'f' && is_blank(cursor[1]);
+
+    if (vertex) {
+      // an optional w and vertex colors may follow, neither is used
+      std::array<float, 3> position {};
+      cursor = parse_float(cursor + 1, line_end, position[0]);
+      cursor = parse_float(cursor, line_end, position[1]);
+      parse_float(cursor, line_end, position[2]);
+      out.positions.insert(
+          out.positions.end(), position.begin(), position.end());
+    } else if (tex_coord) {
+      std::array<float, 2> uv {};
+      cursor = parse_float(cursor + 2, line_end, uv[0]);
+      if (skip_blanks(cursor, line_end) != line_end) {
+        parse_float(cursor, line_end, uv[1]);
+      }
+      out.tex_coords.insert(out.tex_coords.end(), uv.begin(), uv.end());
+    } else if (polygon) {
+      ++cursor;
+      std::uint32_t corner_count = 0;
+      // v, v/vt, v//vn or v/vt/vn, the normal is skipped
+      while ((cursor = skip_blanks(cursor, line_end)) != line_end) {
+        written_corner written {.position = 0, .tex_coord = 0};
+        cursor = parse_index(cursor, line_end, written.position);
+        if (cursor != line_end && *cursor == '/') {
+          ++cursor;
+          if (cursor != line_end && *cursor != '/') {
+            cursor = parse_index(cursor, line_end, written.tex_coord);
+          }
+          cursor = std::find_if(cursor,
+                                line_end,
+                                [](char c)
+                                { return is_blank(c); });
+        }
+        out.corners.push_back(written);
+        ++corner_count;
+      }
+      if (corner_count < 3) {
+        // points and lines written as faces have nothing to draw
+        out.corners.resize(out.corners.size() - corner_count);
+      } else {
+        out.triangulated_corner_count += 3 * (corner_count - 2);
+        out.faces.push_back(face {
+            .corner_count = corner_count,
+            .positions_before =
+                static_cast<std::uint32_t>(out.positions.size() / 3),
+            .tex_coords_before =
+                static_cast<std::uint32_t>(out.tex_coords.size() / 2),
+        });
+      }
+    }
+
+    first = line_end + (line_end < last ? 1 : 0);
+  }
+}
+
+void vktut::geometry::obj_parser::resolve_chunk(const chunk& part,
+                                                std::uint32_t position_count,
+                                                std::uint32_t tex_coord_count,
+                                                corner* out)
+{
+  std::size_t first_corner = 0;
+  for (const auto& polygon : part.faces) {
+    auto corner_at = [&](std::size_t index)
+    {
+      std::int64_t tex_coord = part.corners[index].tex_coord;
+      return corner {
+          .position = resolve(part.corners[index].position,
+                              polygon.positions_before,
+                              part.positions_offset,
+                              position_count),
+          .tex_coord = tex_coord == 0 ? no_tex_coord
+                                      : resolve(tex_coord,
+                                                polygon.tex_coords_before,
+                                                part.tex_coords_offset,
+                                                tex_coord_count),
+      };
+    };
+    // fanned around the first corner
+    auto pivot = corner_at(first_corner);
+    auto previous = corner_at(first_corner + 1);
+    for (std::size_t i = 2; i < polygon.corner_count; ++i) {
+      auto next = corner_at(first_corner + i);
+      *out++ = pivot;
+      *out++ = previous;
+      *out++ = next;
+      previous = next;
+    }
+    first_corner += polygon.corner_count;
+  }
+}
+
+const char* vktut::geometry::obj_parser::find_line_end(const char* first,
+                                                       const char* last)
+{
+#ifdef __AVX2__
+  __m256i newline = _mm256_set1_epi8('\n');
+  for (; last - first >= 32; first += 32) {
+    __m256i bytes =
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    auto mask = static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline)));
+    if (mask != 0) {
+      return first + std::countr_zero(mask);
+    }
+  }
+#endif
+  // memchr is vectorized by every common C library, and finishes the tail
+  // the loop above leaves over
+  const auto* found = static_cast<const char*>(
+      std::memchr(first, '\n', static_cast<std::size_t>(last - first)));
+  return found != nullptr ? found : last;
+}
+
+bool vktut::geometry::obj_parser::is_blank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* vktut::geometry::obj_parser::skip_blanks(const char* first,
+                                                     const char* last)
+{
+  return std::find_if(first, last, [](char c) { return !is_blank(c); });
+}
+
+const char* vktut::geometry::obj_parser::parse_float(const char* first,
+                                                     const char* last,
+                                                     float& value)
+{
+  first = skip_blanks(first, last);
+  // from_chars takes no leading plus
+  if (first != last && *first == '+') {
+    ++first;
+  }
+  auto [end, error] = std::from_chars(first, last, value);
+  if (error != std::errc {}) {
+    throw std::runtime_error {"failed to parse obj number!"};
+  }
+  return end;
+}
+
+const char* vktut::geometry::obj_parser::parse_index(const char* first,
+                                                     const char* last,
+                                                     std::int64_t& value)
+{
+  auto [end, error] = std::from_chars(first, last, value);
+  if (error != std::errc {} || value == 0) {
+    throw std::runtime_error {"failed to parse obj index!"};
+  }
+  return end;
+}
+
+std::uint32_t vktut::geometry::obj_parser::resolve(std::int64_t index,
+                                                   std::uint32_t before,
+                                                   std::uint32_t offset,
+                                                   std::uint32_t count)
+{
+  // one based, or counting back from the elements read so far
+  std::int64_t resolved = index > 0
+      ? index - 1
+      : std::int64_t {offset} + std::int64_t {before} + index;
+  if (resolved < 0 || resolved >= std::int64_t {count}) {
+    throw std::runtime_error {"failed to resolve obj index!"};
+  }
+  return static_cast<std::uint32_t>(resolved);
+}
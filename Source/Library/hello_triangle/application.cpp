@@ -1,29 +1,72 @@
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <istream>
 #include <limits>
 #include <map>
+#include <optional>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "vktut/hello_triangle/application.hpp"
 
 #include <GLFW/glfw3.h>
 #include <config.hpp>
+#include <embedded_spirv.hpp>
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <stb_image.h>
-#include <tiny_obj_loader.h>
+#include <vktut/shaders/cull_constants.hpp>
+#include <vktut/shaders/cull_descriptors.hpp>
+#include <vktut/shaders/depth_pyramid_descriptors.hpp>
+#include <vktut/shaders/frame_descriptors.hpp>
+#include <vktut/shaders/push_constants.hpp>
 #include <vktut/shaders/uniform_buffer_object.hpp>
-#include <vktut/utilities/files.hpp>
+#include <vktut/shaders/yuv_constants.hpp>
+#include <vktut/shaders/yuv_descriptors.hpp>
+#include <vktut/utilities/span_streambuf.hpp>
 #include <vktut/vulkan/debug.hpp>
 #include <vktut/vulkan/queue_family_indices.hpp>
 
+void vktut::hello_triangle::application::stream_to(
+    const std::string& path, rendering::video_format format)
+{
+  VkFormatProperties format_properties;
+  vkGetPhysicalDeviceFormatProperties(
+      m_physical_device, m_swap_chain_image_format, &format_properties);
+  if (m_render_to_swap_chain
+      || (format_properties.optimalTilingFeatures
+          & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+          == 0U)
+  {
+    throw std::runtime_error {"swap chain format can't be streamed!"};
+  }
+
+  if (m_yuv_pipeline == nullptr) {
+    create_yuv_pipeline();
+  }
+  m_video_stream = std::make_unique<rendering::video_stream>(
+      m_device,
+      m_physical_device,
+      format,
+      rendering::video_stream::stream_extent(m_swap_chain_extent),
+      path,
+      stream_frame_rate,
+      stream_slots);
+}
+
 void vktut::hello_triangle::application::run()
 {
   main_loop();
@@ -39,31 +82,70 @@ vktut::hello_triangle::application::application()
     , m_surface(nullptr)
     , m_present_queue(nullptr)
     , m_transfer_queue(nullptr)
+    , m_async_compute(nullptr)
     , m_swap_chain(nullptr)
     , m_swap_chain_image_format()
     , m_swap_chain_extent()
     , m_render_pass(nullptr)
+    , m_descriptor_layout_cache(nullptr)
     , m_descriptor_set_layout(nullptr)
+    , m_descriptor_update_template(nullptr)
     , m_pipeline_layout(nullptr)
     , m_graphics_pipeline(nullptr)
     , m_command_pool(nullptr)
     , m_transfer_command_pool(nullptr)
-    , m_vertex_buffer(nullptr)
-    , m_vertex_buffer_memory(nullptr)
-    , m_index_buffer(nullptr)
-    , m_index_buffer_memory(nullptr)
-    , m_descriptor_pool(nullptr)
-    , m_mip_levels(0)
-    , m_texture_image(nullptr)
-    , m_texture_image_memory(nullptr)
-    , m_texture_image_view(nullptr)
+    , m_deletion_queue(max_frames_in_flight)
+    , m_simulation(simulation_state {
+          .time = 0.0F,
+          .camera_position = glm::vec3 {30.0F, 30.0F, 30.0F},
+          .sampled_at = std::chrono::high_resolution_clock::now(),
+      })
+    , m_meshlet_buffer(nullptr)
+    , m_meshlet_buffer_memory(nullptr)
+    , m_cull_set_layout(nullptr)
+    , m_cull_update_template(nullptr)
+    , m_cull_pipeline_layout(nullptr)
+    , m_cull_pipeline(nullptr)
+    , m_model_transform(1.0F)
+    , m_view_projection(1.0F)
+    , m_camera_position(30.0F, 30.0F, 30.0F)
     , m_texture_sampler(nullptr)
-    , m_depth_image(nullptr)
-    , m_depth_image_memory(nullptr)
+    , m_bindless_set_layout(nullptr)
+    , m_bindless_descriptor_pool(nullptr)
+    , m_bindless_descriptor_set(nullptr)
+    , m_depth_image()
     , m_depth_image_view(nullptr)
-    , m_color_image(nullptr)
-    , m_color_image_memory(nullptr)
+    , m_depth_prepass_render_pass(nullptr)
+    , m_depth_prepass_framebuffer(nullptr)
+    , m_depth_prepass_pipeline(nullptr)
+    , m_depth_pyramid()
+    , m_depth_pyramid_view(nullptr)
+    , m_depth_pyramid_sampler(nullptr)
+    , m_depth_pyramid_set_layout(nullptr)
+    , m_depth_pyramid_update_template(nullptr)
+    , m_depth_pyramid_pipeline_layout(nullptr)
+    , m_depth_pyramid_pipeline(nullptr)
+    , m_depth_pyramid_multisampled_pipeline(nullptr)
+    , m_color_image()
     , m_color_image_view(nullptr)
+    , m_scene_image()
+    , m_scene_image_view(nullptr)
+    , m_scene_framebuffer(nullptr)
+    , m_render_extent()
+    , m_timestamp_query_pool(nullptr)
+    , m_yuv_sampler(nullptr)
+    , m_yuv_set_layout(nullptr)
+    , m_yuv_update_template(nullptr)
+    , m_yuv_pipeline_layout(nullptr)
+    , m_yuv_pipeline(nullptr)
+    // load_model() fills in white vertex colors, so skip that attribute
+    , m_material {
+          .textured = true,
+          .vertex_colors = false,
+          .bindless_textures = false,
+          .base_color = {1.0F, 1.0F, 1.0F},
+          .texture_index = 0,
+      }
 {
   init_window();
   init_vulkan();
@@ -82,6 +164,11 @@ void vktut::hello_triangle::application::init_window()
   m_window = glfwCreateWindow(width, height, "Vulkan", nullptr, nullptr);
   glfwSetWindowUserPointer(m_window, this);
   glfwSetFramebufferSizeCallback(m_window, framebuffer_resize_callback);
+  glfwSetKeyCallback(m_window, key_callback);
+  glfwGetFramebufferSize(
+      m_window, &m_framebuffer_width, &m_framebuffer_height);
+  m_latest_framebuffer_size =
+      pack_framebuffer_size(m_framebuffer_width, m_framebuffer_height);
 }
 
 void vktut::hello_triangle::application::init_vulkan()
@@ -99,23 +186,33 @@ void vktut::hello_triangle::application::init_vulkan()
   create_swap_chain();
   create_image_views();
   create_render_pass();
+  create_depth_prepass_render_pass();
   create_descriptor_set_layout();
+  create_descriptor_update_template();
   create_graphics_pipeline();
+  create_depth_prepass_pipeline();
   create_command_pools();
+  create_async_compute();
   create_color_resources();
   create_depth_resources();
+  create_scene_target();
   create_framebuffers();
-  create_texture_image();
-  create_texture_image_view();
+  create_timestamp_queries();
+  create_asset_manager();
+  create_texture_images();
   create_texture_sampler();
+  create_bindless_descriptors();
   load_model();
-  create_vertex_buffer();
-  create_index_buffer();
+  create_meshlet_buffers();
   create_uniform_buffers();
-  create_descriptor_pool();
-  create_descriptor_sets();
+  create_instance_buffers();
+  create_descriptor_allocators();
+  create_cull_pipeline();
+  create_depth_pyramid_pipelines();
+  create_depth_pyramid();
   create_command_buffers();
   create_sync_objects();
+  create_frame_capture();
 }
 
 void vktut::hello_triangle::application::create_image_views()
@@ -132,15 +229,27 @@ void vktut::hello_triangle::application::create_image_views()
 
 void vktut::hello_triangle::application::create_render_pass()
 {
+  // without multisampling the scene image is rendered to directly and there is
+  // nothing to resolve
+  bool multisampled = m_msaa_samples != VK_SAMPLE_COUNT_1_BIT;
+
+  // the swap chain image is presented right after the pass instead of being
+  // blitted to
+  VkImageLayout output_layout = m_render_to_swap_chain
+      ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+      : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
   VkAttachmentDescription color_attachment = {
       .format = m_swap_chain_image_format,
       .samples = m_msaa_samples,
       .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-      .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+      // only the resolved image is kept
+      .storeOp = multisampled ? VK_ATTACHMENT_STORE_OP_DONT_CARE
+                              : VK_ATTACHMENT_STORE_OP_STORE,
       .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
       .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
       .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-      .finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+      .finalLayout = multisampled ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                                  : output_layout,
   };
 
   VkAttachmentReference color_attachment_ref = {
@@ -148,20 +257,26 @@ void vktut::hello_triangle::application::create_render_pass()
       .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
   };
 
+  // after a pre-pass depth is complete and only tested against
+  VkImageLayout depth_layout = m_depth_prepass
+      ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+      : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
   VkAttachmentDescription depth_attachment = {
       .format = find_depth_format(),
       .samples = m_msaa_samples,
-      .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+      .loadOp = m_depth_prepass ? VK_ATTACHMENT_LOAD_OP_LOAD
+                                : VK_ATTACHMENT_LOAD_OP_CLEAR,
       .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
       .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
       .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-      .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+      .initialLayout =
+          m_depth_prepass ? depth_layout : VK_IMAGE_LAYOUT_UNDEFINED,
+      .finalLayout = depth_layout,
   };
 
   VkAttachmentReference depth_attachment_ref = {
       .attachment = 1,
-      .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+      .layout = depth_layout,
   };
 
   VkAttachmentDescription color_attachment_resolve = {
@@ -172,7 +287,7 @@ void vktut::hello_triangle::application::create_render_pass()
       .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
       .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
       .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-      .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+      .finalLayout = output_layout,
   };
 
   VkAttachmentReference color_attachment_resolve_ref = {
@@ -184,17 +299,32 @@ void vktut::hello_triangle::application::create_render_pass()
       .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
       .colorAttachmentCount = 1,
       .pColorAttachments = &color_attachment_ref,
-      .pResolveAttachments = &color_attachment_resolve_ref,
+      .pResolveAttachments =
+          multisampled ? &color_attachment_resolve_ref : nullptr,
       .pDepthStencilAttachment = &depth_attachment_ref,
   };
 
-  VkSubpassDependency dependency = {
-      .srcSubpass = VK_SUBPASS_EXTERNAL,
-      .dstSubpass = 0,
-      .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-      .srcAccessMask = 0,
-      .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+  std::array dependencies = {
+      // the previous frame's blit, capture and yuv conversion have to finish
+      // reading the scene image
+      VkSubpassDependency {
+          .srcSubpass = VK_SUBPASS_EXTERNAL,
+          .dstSubpass = 0,
+          .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+              | VK_PIPELINE_STAGE_TRANSFER_BIT
+              | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          .srcAccessMask = 0,
+          .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+      },
+      VkSubpassDependency {
+          .srcSubpass = 0,
+          .dstSubpass = VK_SUBPASS_EXTERNAL,
+          .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+          .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+          .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+      },
   };
 
   std::array attachments = {
@@ -205,12 +335,13 @@ void vktut::hello_triangle::application::create_render_pass()
 
   VkRenderPassCreateInfo render_pass_info = {
       .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-      .attachmentCount = attachments.size(),
+      // the resolve attachment is last so it can simply be left off
+      .attachmentCount = multisampled ? 3U : 2U,
       .pAttachments = attachments.data(),
       .subpassCount = 1,
       .pSubpasses = &subpass,
-      .dependencyCount = 1,
-      .pDependencies = &dependency,
+      .dependencyCount = dependencies.size(),
+      .pDependencies = dependencies.data(),
   };
 
   if (vkCreateRenderPass(m_device, &render_pass_info, nullptr, &m_render_pass)
@@ -250,54 +381,238 @@ bool vktut::hello_triangle::application::check_validation_layer_support(
 }
 
 void vktut::hello_triangle::application::framebuffer_resize_callback(
-    GLFWwindow* window, int /*width*/, int /*height*/)
+    GLFWwindow* window, int width, int height)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  auto* app = reinterpret_cast<hello_triangle::application*>(
+      glfwGetWindowUserPointer(window));
+  app->m_latest_framebuffer_size.store(pack_framebuffer_size(width, height),
+                                       std::memory_order_release);
+}
+
+std::uint64_t vktut::hello_triangle::application::pack_framebuffer_size(
+    int width, int height)
+{
+  return (std::uint64_t {static_cast<std::uint32_t>(width)} << 32U)
+      | static_cast<std::uint32_t>(height);
+}
+
+void vktut::hello_triangle::application::key_callback(
+    GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/)
 {
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
   auto* app = reinterpret_cast<hello_triangle::application*>(
       glfwGetWindowUserPointer(window));
-  app->m_framebuffer_resized = true;
+  if (action != GLFW_PRESS) {
+    return;
+  }
+  // only full while the render thread is stuck, say so rather than lose the
+  // key silently
+  if (!app->m_window_events.push(window_event {.key = key})) {
+    std::cerr << "[vktut::hello_triangle::application::key_callback()] "
+              << "window event queue full, key " << key << " dropped\n";
+  }
 }
 
 void vktut::hello_triangle::application::main_loop()
 {
-  auto program_start = std::chrono::high_resolution_clock::now();
-  std::size_t frame_count = 0;
+  // the arrow keys orbit the camera around the z axis at its starting height
+  glm::vec3 camera = m_camera_position;
+  float orbit_radius = glm::length(glm::vec2 {camera.x, camera.y});
+  float orbit_angle = std::atan2(camera.y, camera.x);
+
+  // the main thread only handles window events and steps the simulation,
+  // rendering never waits on either
+  m_rendering = true;
+  std::thread render_thread {&application::render_loop, this};
+  auto start_time = std::chrono::high_resolution_clock::now();
+  auto last_step = start_time;
   while (glfwWindowShouldClose(m_window) == 0) {
-    glfwPollEvents();
-    draw_frame();
-    ++frame_count;
-
-    auto current_time = std::chrono::high_resolution_clock::now();
-    if (std::chrono::duration<float, std::chrono::seconds::period>(
-            current_time - program_start)
-            .count()
-        > 1)
-    {
-      std::cout << "FPS: " << frame_count << "\n";
-      frame_count = 0;
-      program_start = current_time;
+    glfwWaitEventsTimeout(simulation_step_seconds);
+
+    auto now = std::chrono::high_resolution_clock::now();
+    float step =
+        std::chrono::duration<float, std::chrono::seconds::period>(
+            now - last_step)
+            .count();
+    last_step = now;
+    float turn = 0.0F;
+    if (glfwGetKey(m_window, GLFW_KEY_LEFT) == GLFW_PRESS) {
+      turn -= 1.0F;
     }
+    if (glfwGetKey(m_window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
+      turn += 1.0F;
+    }
+    orbit_angle += turn * glm::radians(camera_turn_degrees_per_second) * step;
+
+    auto& state = m_simulation.write_slot();
+    state.time = std::chrono::duration<float, std::chrono::seconds::period>(
+                     now - start_time)
+                     .count();
+    state.camera_position = glm::vec3 {orbit_radius * std::cos(orbit_angle),
+                                       orbit_radius * std::sin(orbit_angle),
+                                       camera.z};
+    state.sampled_at = now;
+    m_simulation.publish();
   }
+  m_rendering = false;
+  render_thread.join();
 
   vkDeviceWaitIdle(m_device);
+  if (m_render_error) {
+    std::rethrow_exception(m_render_error);
+  }
+  if (m_frame_capture) {
+    m_frame_capture->flush();
+  }
+  if (m_video_stream) {
+    m_video_stream->flush();
+    std::cerr << "[vktut::hello_triangle::application::main_loop()] stream "
+              << "ended, " << m_video_stream->dropped_frames()
+              << " frames dropped\n";
+  }
+}
+
+void vktut::hello_triangle::application::render_loop()
+{
+  try {
+    auto program_start = std::chrono::high_resolution_clock::now();
+    auto last_frame = program_start;
+    std::size_t frame_count = 0;
+    while (m_rendering) {
+      process_window_events();
+      draw_frame();
+      ++frame_count;
+
+      auto current_time = std::chrono::high_resolution_clock::now();
+      float frame_time_ms =
+          std::chrono::duration<float, std::milli>(current_time - last_frame)
+              .count();
+      last_frame = current_time;
+      if (m_timestamp_query_pool == nullptr) {
+        m_resolution_scaler->update(frame_time_ms);
+      }
+      if (m_quality_governor->record_frame(frame_time_ms)) {
+        apply_quality_level();
+      }
+
+      if (std::chrono::duration<float, std::chrono::seconds::period>(
+              current_time - program_start)
+              .count()
+          > 1)
+      {
+        std::cout << "FPS: " << frame_count << " (render scale "
+                  << m_resolution_scaler->scale() << ")\n";
+        // how old the camera is when the frame is submitted, a lower bound
+        // on its input to photon latency
+        if (m_latched_frames > 0) {
+          auto frames = static_cast<double>(m_latched_frames);
+          std::cout << "input age at submit: "
+                    << m_latched_latency_ms / frames << " ms latched, "
+                    << m_early_latency_ms / frames << " ms without\n";
+          m_early_latency_ms = 0.0;
+          m_latched_latency_ms = 0.0;
+          m_latched_frames = 0;
+        }
+        // after a second of rendering the lazy allocations have settled
+        if (m_attachment_report_pending) {
+          m_attachment_report_pending = false;
+          report_attachment_memory();
+        }
+        frame_count = 0;
+        program_start = current_time;
+      }
+    }
+  } catch (...) {
+    // handed to the main thread, which is woken up to stop
+    m_render_error = std::current_exception();
+    glfwSetWindowShouldClose(m_window, GLFW_TRUE);
+    glfwPostEmptyEvent();
+  }
+}
+
+void vktut::hello_triangle::application::process_window_events()
+{
+  auto size = m_latest_framebuffer_size.load(std::memory_order_acquire);
+  auto width = static_cast<int>(size >> 32U);
+  auto height = static_cast<int>(size & 0xFFFFFFFFU);
+  if (width != m_framebuffer_width || height != m_framebuffer_height) {
+    m_framebuffer_width = width;
+    m_framebuffer_height = height;
+    m_framebuffer_resized = true;
+  }
+
+  while (auto event = m_window_events.pop()) {
+    if (event->key != GLFW_KEY_C || !m_frame_capture) {
+      continue;
+    }
+    m_capturing = !m_capturing;
+    std::cout << "[vktut::hello_triangle::application::"
+              << "process_window_events()] capture "
+              << (m_capturing ? "started" : "stopped") << ", "
+              << m_frame_capture->dropped_frames()
+              << " frames dropped so far\n";
+  }
 }
 
 void vktut::hello_triangle::application::cleanup()
 {
+  // waits for the encoders and the stream writer to finish
+  m_frame_capture.reset();
+  m_video_stream.reset();
   cleanup_swap_chain();
+  // main_loop() left the device idle
+  m_deletion_queue.flush();
+  m_async_compute.reset();
 
-  vkDestroySampler(m_device, m_texture_sampler, nullptr);
-  vkDestroyImageView(m_device, m_texture_image_view, nullptr);
-
-  vkDestroyImage(m_device, m_texture_image, nullptr);
-  vkFreeMemory(m_device, m_texture_image_memory, nullptr);
+  vkDestroyDescriptorPool(m_device, m_bindless_descriptor_pool, nullptr);
+  vkDestroyDescriptorSetLayout(m_device, m_bindless_set_layout, nullptr);
 
-  vkDestroyDescriptorSetLayout(m_device, m_descriptor_set_layout, nullptr);
+  vkDestroySampler(m_device, m_texture_sampler, nullptr);
 
-  vkDestroyBuffer(m_device, m_index_buffer, nullptr);
-  vkFreeMemory(m_device, m_index_buffer_memory, nullptr);
-  vkDestroyBuffer(m_device, m_vertex_buffer, nullptr);
-  vkFreeMemory(m_device, m_vertex_buffer_memory, nullptr);
+  vkDestroyQueryPool(m_device, m_timestamp_query_pool, nullptr);
+
+  vkDestroyPipeline(m_device, m_yuv_pipeline, nullptr);
+  vkDestroyPipelineLayout(m_device, m_yuv_pipeline_layout, nullptr);
+  vkDestroyDescriptorUpdateTemplate(m_device, m_yuv_update_template, nullptr);
+  vkDestroySampler(m_device, m_yuv_sampler, nullptr);
+
+  vkDestroyPipeline(m_device, m_depth_pyramid_pipeline, nullptr);
+  vkDestroyPipeline(m_device, m_depth_pyramid_multisampled_pipeline, nullptr);
+  vkDestroyPipelineLayout(m_device, m_depth_pyramid_pipeline_layout, nullptr);
+  vkDestroyDescriptorUpdateTemplate(
+      m_device, m_depth_pyramid_update_template, nullptr);
+  vkDestroySampler(m_device, m_depth_pyramid_sampler, nullptr);
+
+  vkDestroyPipeline(m_device, m_cull_pipeline, nullptr);
+  vkDestroyPipelineLayout(m_device, m_cull_pipeline_layout, nullptr);
+  vkDestroyDescriptorUpdateTemplate(m_device, m_cull_update_template, nullptr);
+  vkDestroyBuffer(m_device, m_meshlet_buffer, nullptr);
+  vkFreeMemory(m_device, m_meshlet_buffer_memory, nullptr);
+  for (const auto& buffer : m_draw_command_buffers) {
+    vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+    vkFreeMemory(m_device, buffer.memory, nullptr);
+  }
+  for (const auto& buffer : m_draw_count_buffers) {
+    vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+    vkFreeMemory(m_device, buffer.memory, nullptr);
+  }
+  for (const auto& buffer : m_instance_buffers) {
+    vkUnmapMemory(m_device, buffer.memory);
+    vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+    vkFreeMemory(m_device, buffer.memory, nullptr);
+  }
+  m_frame_descriptor_allocators.clear();
+  vkDestroyDescriptorUpdateTemplate(
+      m_device, m_descriptor_update_template, nullptr);
+  // owns m_descriptor_set_layout, m_cull_set_layout,
+  // m_depth_pyramid_set_layout and m_yuv_set_layout
+  m_descriptor_layout_cache.reset();
+
+  // the last handles release the gpu side of the assets
+  m_model.reset();
+  m_textures.clear();
+  m_assets.reset();
 
   for (auto* fence : m_in_flight_fences) {
     vkDestroyFence(m_device, fence, nullptr);
@@ -324,45 +639,12 @@ void vktut::hello_triangle::application::cleanup()
 
 void vktut::hello_triangle::application::load_model()
 {
-  tinyobj::ObjReader reader;
-  tinyobj::ObjReaderConfig config;
-  config.triangulate = true;
-  if (!reader.ParseFromFile(std::string {model_path}, config)) {
-    throw std::runtime_error {reader.Warning() + reader.Error()};
-  }
-  const auto& attrib = reader.GetAttrib();
-  const auto& shapes = reader.GetShapes();
-  const auto& materials = reader.GetMaterials();
-
-  std::unordered_map<shaders::vertex, std::uint32_t> unique_vertices;
-
-  for (const auto& shape : shapes) {
-    for (const auto& index : shape.mesh.indices) {
-      auto vert = shaders::vertex {};
-      vert.pos = {
-          attrib.vertices[3 * static_cast<std::size_t>(index.vertex_index) + 0],
-          attrib.vertices[3 * static_cast<std::size_t>(index.vertex_index) + 1],
-          attrib.vertices[3 * static_cast<std::size_t>(index.vertex_index) + 2],
-      };
-      vert.color = {1, 1, 1};
-      if (index.texcoord_index != -1) {
-        vert.tex_coord = {
-            attrib.texcoords[2 * static_cast<std::size_t>(index.texcoord_index)
-                             + 0],
-            1.0F
-                - attrib.texcoords
-                      [2 * static_cast<std::size_t>(index.texcoord_index) + 1],
-        };
-      }
+  m_model = m_assets->load_mesh(std::string {model_path});
 
-      if (unique_vertices.count(vert) == 0) {
-        unique_vertices.emplace(vert,
-                                static_cast<std::uint32_t>(m_vertices.size()));
-        m_vertices.emplace_back(vert);
-      }
-      m_indices.push_back(unique_vertices[vert]);
-    }
-  }
+  // the model is the first node, which makes it instance 0
+  m_model_node = m_scene.add_node(scene::scene_graph::no_parent);
+  m_frustum_culler.add(m_model->lod_chain.center,
+                       m_model->lod_chain.radius);
 }
 
 void vktut::hello_triangle::application::create_descriptor_set_layout()
@@ -383,23 +665,21 @@ void vktut::hello_triangle::application::create_descriptor_set_layout()
       .pImmutableSamplers = nullptr,
   };
 
-  std::array bindings = {
-      ubo_layout_binding,
-      sampler_layout_binding,
-  };
-
-  VkDescriptorSetLayoutCreateInfo layout_info = {
-      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-      .bindingCount = bindings.size(),
-      .pBindings = bindings.data(),
+  VkDescriptorSetLayoutBinding instance_layout_binding = {
+      .binding = 2,
+      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      .descriptorCount = 1,
+      .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+      .pImmutableSamplers = nullptr,
   };
 
-  if (vkCreateDescriptorSetLayout(
-          m_device, &layout_info, nullptr, &m_descriptor_set_layout)
-      != VK_SUCCESS)
-  {
-    throw std::runtime_error {"failed to create descriptor set layout!"};
-  }
+  m_descriptor_layout_cache =
+      std::make_unique<vulkan::descriptor_layout_cache>(m_device);
+  m_descriptor_set_layout = m_descriptor_layout_cache->get({
+      ubo_layout_binding,
+      sampler_layout_binding,
+      instance_layout_binding,
+  });
 }
 
 void vktut::hello_triangle::application::setup_debug_messenger()
@@ -450,7 +730,51 @@ void vktut::hello_triangle::application::pick_physical_device()
     throw std::runtime_error {"no suitable devices found!"};
   }
   m_physical_device = best_device->second;
-  m_msaa_samples = get_max_usable_sample_count();
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(m_physical_device, &properties);
+  VkPhysicalDeviceFeatures supported_features;
+  vkGetPhysicalDeviceFeatures(m_physical_device, &supported_features);
+  m_sample_rate_shading_supported =
+      supported_features.sampleRateShading == VK_TRUE;
+
+  // meshlet culling dispatches on the graphics queue and draws every meshlet
+  // slot with a single indirect call
+  auto indices =
+      vulkan::queue_family_indices::find(m_physical_device, m_surface);
+  std::uint32_t family_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      m_physical_device, &family_count, nullptr);
+  std::vector<VkQueueFamilyProperties> families;
+  families.resize(family_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      m_physical_device, &family_count, families.data());
+  m_meshlet_culling_supported = supported_features.multiDrawIndirect == VK_TRUE
+      && (families[*indices.graphics_family].queueFlags & VK_QUEUE_COMPUTE_BIT)
+          != 0U;
+  m_max_draw_indirect_count = properties.limits.maxDrawIndirectCount;
+
+  // the depth pyramid is reduced from the pre-pass depth in a compute shader
+  VkFormatProperties depth_format_properties;
+  vkGetPhysicalDeviceFormatProperties(
+      m_physical_device, find_depth_format(), &depth_format_properties);
+  m_depth_pyramid_supported = m_depth_prepass
+      && (depth_format_properties.optimalTilingFeatures
+          & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)
+          != 0U;
+
+  // software rasterizers run the fragment shader per sample on the cpu, so
+  // never offer them per-sample shading in the first place
+  bool software_rasterizer =
+      properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU;
+  m_quality_governor = std::make_unique<rendering::quality_governor>(
+      get_max_usable_sample_count(),
+      m_sample_rate_shading_supported && !software_rasterizer,
+      frame_budget_ms);
+  m_msaa_samples = m_quality_governor->current().samples;
+  m_resolution_scaler = std::make_unique<rendering::resolution_scaler>(
+      min_render_scale, max_render_scale, gpu_budget_ms);
+  m_material.bindless_textures = check_bindless_support();
 }
 
 void vktut::hello_triangle::application::create_logical_device()
@@ -459,38 +783,64 @@ void vktut::hello_triangle::application::create_logical_device()
       vulkan::queue_family_indices::find(m_physical_device, m_surface);
 
   std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
-  std::unordered_set<std::uint32_t> unique_queue_families = {
-      *indices.graphics_family,
-      *indices.present_family,
-      *indices.transfer_family,
+  // how many queues every family needs, the compute queue may be the second
+  // one of the graphics or transfer family
+  std::map<std::uint32_t, std::uint32_t> queue_counts = {
+      {*indices.graphics_family, 1},
+      {*indices.present_family, 1},
+      {*indices.transfer_family, 1},
   };
-  queue_create_infos.reserve(unique_queue_families.size());
-  float queue_priority = 1;
-  std::transform(unique_queue_families.begin(),
-                 unique_queue_families.end(),
+  if (indices.compute_family) {
+    auto& count = queue_counts[*indices.compute_family];
+    count = std::max(count, indices.compute_queue_index + 1);
+  }
+  queue_create_infos.reserve(queue_counts.size());
+  std::array queue_priorities = {1.0F, 1.0F};
+  std::transform(queue_counts.begin(),
+                 queue_counts.end(),
                  std::back_inserter(queue_create_infos),
-                 [&queue_priority](std::uint32_t queue_family)
+                 [&queue_priorities](const auto& family)
                  {
                    return VkDeviceQueueCreateInfo {
                        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-                       .queueFamilyIndex = queue_family,
-                       .queueCount = 1,
-                       .pQueuePriorities = &queue_priority,
+                       .queueFamilyIndex = family.first,
+                       .queueCount = family.second,
+                       .pQueuePriorities = queue_priorities.data(),
                    };
                  });
 
   VkPhysicalDeviceFeatures device_features = {
-      .sampleRateShading = VK_TRUE,
+      .sampleRateShading =
+          m_sample_rate_shading_supported ? VK_TRUE : VK_FALSE,
+      .multiDrawIndirect = m_meshlet_culling_supported ? VK_TRUE : VK_FALSE,
       .samplerAnisotropy = VK_TRUE,
   };
 
+  std::vector<const char*> enabled_extensions = {
+      device_extensions.begin(),
+      device_extensions.end(),
+  };
+  VkPhysicalDeviceDescriptorIndexingFeatures indexing_features = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+  };
+  if (m_material.bindless_textures) {
+    enabled_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    indexing_features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+    indexing_features.descriptorBindingVariableDescriptorCount = VK_TRUE;
+    indexing_features.runtimeDescriptorArray = VK_TRUE;
+  }
+
   VkDeviceCreateInfo create_info = {
       .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+      .pNext = m_material.bindless_textures ? &indexing_features : nullptr,
       .queueCreateInfoCount =
           static_cast<std::uint32_t>(queue_create_infos.size()),
       .pQueueCreateInfos = queue_create_infos.data(),
-      .enabledExtensionCount = device_extensions.size(),
-      .ppEnabledExtensionNames = device_extensions.data(),
+      .enabledExtensionCount =
+          static_cast<std::uint32_t>(enabled_extensions.size()),
+      .ppEnabledExtensionNames = enabled_extensions.data(),
       .pEnabledFeatures = &device_features,
   };
 
@@ -515,175 +865,805 @@ void vktut::hello_triangle::application::create_surface()
 
 void vktut::hello_triangle::application::create_framebuffers()
 {
-  m_swap_chain_framebuffers.resize(m_swap_chain_image_views.size());
+  bool multisampled = m_msaa_samples != VK_SAMPLE_COUNT_1_BIT;
+  // should match attachment order in create_render_pass()
+  auto attachments_for = [this, multisampled](VkImageView output)
+  {
+    return multisampled ? std::array {
+                              m_color_image_view,
+                              m_depth_image_view,
+                              output,
+                          }
+                        : std::array {
+                              output,
+                              m_depth_image_view,
+                              VkImageView {nullptr},
+                          };
+  };
+  auto attachments = attachments_for(m_scene_image_view);
 
-  for (size_t i = 0; i < m_swap_chain_image_views.size(); ++i) {
-    std::array attachments = {
-        m_color_image_view,
-        m_depth_image_view,
-        m_swap_chain_image_views[i],
-    };
+  // always full size, lower resolutions only render into the top left of it
+  VkFramebufferCreateInfo framebuffer_info = {
+      .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+      .renderPass = m_render_pass,
+      .attachmentCount = multisampled ? 3U : 2U,
+      .pAttachments = attachments.data(),
+      .width = m_swap_chain_extent.width,
+      .height = m_swap_chain_extent.height,
+      .layers = 1,
+  };
 
-    VkFramebufferCreateInfo framebuffer_info = {
-        .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-        .renderPass = m_render_pass,
-        .attachmentCount = attachments.size(),
-        .pAttachments = attachments.data(),
-        .width = m_swap_chain_extent.width,
-        .height = m_swap_chain_extent.height,
-        .layers = 1,
-    };
+  if (vkCreateFramebuffer(
+          m_device, &framebuffer_info, nullptr, &m_scene_framebuffer)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create framebuffer!"};
+  }
 
-    if (vkCreateFramebuffer(
-            m_device, &framebuffer_info, nullptr, &m_swap_chain_framebuffers[i])
-        != VK_SUCCESS)
-    {
-      throw std::runtime_error {"failed to create framebuffer!"};
+  m_swap_chain_framebuffers.clear();
+  if (m_render_to_swap_chain) {
+    m_swap_chain_framebuffers.resize(m_swap_chain_image_views.size());
+    for (size_t i = 0; i < m_swap_chain_image_views.size(); ++i) {
+      attachments = attachments_for(m_swap_chain_image_views[i]);
+      if (vkCreateFramebuffer(m_device,
+                              &framebuffer_info,
+                              nullptr,
+                              &m_swap_chain_framebuffers[i])
+          != VK_SUCCESS)
+      {
+        throw std::runtime_error {"failed to create framebuffer!"};
+      }
     }
   }
+
+  if (!m_depth_prepass) {
+    return;
+  }
+
+  VkFramebufferCreateInfo depth_prepass_framebuffer_info = {
+      .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+      .renderPass = m_depth_prepass_render_pass,
+      .attachmentCount = 1,
+      .pAttachments = &m_depth_image_view,
+      .width = m_swap_chain_extent.width,
+      .height = m_swap_chain_extent.height,
+      .layers = 1,
+  };
+
+  if (vkCreateFramebuffer(m_device,
+                          &depth_prepass_framebuffer_info,
+                          nullptr,
+                          &m_depth_prepass_framebuffer)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create framebuffer!"};
+  }
 }
 
-void vktut::hello_triangle::application::create_command_pools()
+void vktut::hello_triangle::application::create_scene_target()
 {
-  auto queue_family_indices =
-      vulkan::queue_family_indices::find(m_physical_device, m_surface);
+  VkFormatProperties format_properties;
+  vkGetPhysicalDeviceFormatProperties(
+      m_physical_device, m_swap_chain_image_format, &format_properties);
+  constexpr VkFormatFeatureFlags blit_features =
+      VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+  // without blit support the scene is copied 1:1, so it can't be scaled
+  m_scene_blit_supported = !m_render_to_swap_chain
+      && (format_properties.optimalTilingFeatures & blit_features)
+          == blit_features;
+
+  m_scene_image = create_image(m_swap_chain_extent.width,
+                               m_swap_chain_extent.height,
+                               1,
+                               VK_SAMPLE_COUNT_1_BIT,
+                               m_swap_chain_image_format,
+                               VK_IMAGE_TILING_OPTIMAL,
+                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+                                   | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                                   | VK_IMAGE_USAGE_SAMPLED_BIT,
+                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  m_scene_image_view = create_image_view(m_scene_image.image,
+                                         m_swap_chain_image_format,
+                                         VK_IMAGE_ASPECT_COLOR_BIT,
+                                         1);
+}
 
-  VkCommandPoolCreateInfo pool_info = {
-      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-      .flags = 0,
-      .queueFamilyIndex = *queue_family_indices.graphics_family,
+void vktut::hello_triangle::application::create_timestamp_queries()
+{
+  auto indices =
+      vulkan::queue_family_indices::find(m_physical_device, m_surface);
+  std::uint32_t family_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      m_physical_device, &family_count, nullptr);
+  std::vector<VkQueueFamilyProperties> families;
+  families.resize(family_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      m_physical_device, &family_count, families.data());
+
+  std::uint32_t valid_bits =
+      families[*indices.graphics_family].timestampValidBits;
+  if (valid_bits == 0) {
+    // the resolution scaler falls back to cpu frame times
+    return;
+  }
+  m_timestamp_mask = valid_bits >= 64
+      ? std::numeric_limits<std::uint64_t>::max()
+      : (std::uint64_t {1} << valid_bits) - 1;
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(m_physical_device, &properties);
+  m_timestamp_period_ns = properties.limits.timestampPeriod;
+
+  // a begin and end timestamp per frame in flight
+  VkQueryPoolCreateInfo query_pool_info = {
+      .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+      .queryType = VK_QUERY_TYPE_TIMESTAMP,
+      .queryCount = 2 * max_frames_in_flight,
   };
 
-  if (vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool)
+  if (vkCreateQueryPool(
+          m_device, &query_pool_info, nullptr, &m_timestamp_query_pool)
       != VK_SUCCESS)
   {
-    throw std::runtime_error {"failed to create command pool!"};
+    throw std::runtime_error {"failed to create timestamp query pool!"};
   }
+  m_timestamps_written.resize(max_frames_in_flight, false);
+}
 
-  pool_info.queueFamilyIndex = *queue_family_indices.transfer_family;
-  if (vkCreateCommandPool(
-          m_device, &pool_info, nullptr, &m_transfer_command_pool)
-      != VK_SUCCESS)
+void vktut::hello_triangle::application::create_frame_capture()
+{
+  if (m_render_to_swap_chain
+      || !rendering::frame_capture::supports(m_swap_chain_image_format))
   {
-    throw std::runtime_error {"failed to create transfer command pool!"};
+    return;
   }
+  m_frame_capture = std::make_unique<rendering::frame_capture>(
+      m_device,
+      m_physical_device,
+      capture_format,
+      ".",
+      capture_slots,
+      capture_encoders);
 }
 
-void vktut::hello_triangle::application::create_command_buffers()
+std::optional<float>
+vktut::hello_triangle::application::read_gpu_frame_time()
 {
-  m_command_buffers.resize(m_swap_chain_framebuffers.size());
-  m_transfer_command_buffers.resize(m_swap_chain_framebuffers.size());
+  if (m_timestamp_query_pool == nullptr
+      || !m_timestamps_written[m_current_frame])
+  {
+    return std::nullopt;
+  }
 
-  VkCommandBufferAllocateInfo alloc_info = {
-      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-      .commandPool = m_command_pool,
-      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-      .commandBufferCount =
-          static_cast<std::uint32_t>(m_command_buffers.size()),
+  std::array<std::uint64_t, 2> timestamps {};
+  // the frame's fence has signaled, so the results are already available
+  if (vkGetQueryPoolResults(m_device,
+                            m_timestamp_query_pool,
+                            2 * m_current_frame,
+                            2,
+                            sizeof(timestamps),
+                            timestamps.data(),
+                            sizeof(std::uint64_t),
+                            VK_QUERY_RESULT_64_BIT)
+      != VK_SUCCESS)
+  {
+    return std::nullopt;
+  }
+
+  auto ticks = (timestamps[1] - timestamps[0]) & m_timestamp_mask;
+  return static_cast<float>(static_cast<double>(ticks) * m_timestamp_period_ns
+                            / 1.0e6);
+}
+
+void vktut::hello_triangle::application::create_yuv_pipeline()
+{
+  VkSamplerCreateInfo sampler_info = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = VK_FILTER_LINEAR,
+      .minFilter = VK_FILTER_LINEAR,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+      .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .mipLodBias = 0,
+      .anisotropyEnable = VK_FALSE,
+      .maxAnisotropy = 1,
+      .compareEnable = VK_FALSE,
+      .compareOp = VK_COMPARE_OP_ALWAYS,
+      .minLod = 0,
+      .maxLod = 0,
+      .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK,
+      .unnormalizedCoordinates = VK_FALSE,
   };
+  if (vkCreateSampler(m_device, &sampler_info, nullptr, &m_yuv_sampler)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create texture sampler!"};
+  }
 
-  if (vkAllocateCommandBuffers(m_device, &alloc_info, m_command_buffers.data())
+  auto bindings = shaders::yuv_descriptors::layout_bindings();
+  m_yuv_set_layout = m_descriptor_layout_cache->get(
+      std::vector<VkDescriptorSetLayoutBinding> {bindings.begin(),
+                                                 bindings.end()});
+
+  auto entries = shaders::yuv_descriptors::template_entries();
+  VkDescriptorUpdateTemplateCreateInfo template_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+      .descriptorUpdateEntryCount = entries.size(),
+      .pDescriptorUpdateEntries = entries.data(),
+      .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+      .descriptorSetLayout = m_yuv_set_layout,
+  };
+  if (vkCreateDescriptorUpdateTemplate(
+          m_device, &template_info, nullptr, &m_yuv_update_template)
       != VK_SUCCESS)
   {
-    throw std::runtime_error {"failed to allocate command buffers!"};
+    throw std::runtime_error {"failed to create descriptor update template!"};
   }
 
-  alloc_info.commandPool = m_transfer_command_pool;
-  alloc_info.commandBufferCount =
-      static_cast<std::uint32_t>(m_transfer_command_buffers.size());
-  if (vkAllocateCommandBuffers(
-          m_device, &alloc_info, m_transfer_command_buffers.data())
+  VkPushConstantRange push_constant_range = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = sizeof(shaders::yuv_constants),
+  };
+  VkPipelineLayoutCreateInfo pipeline_layout_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &m_yuv_set_layout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &push_constant_range,
+  };
+  if (vkCreatePipelineLayout(
+          m_device, &pipeline_layout_info, nullptr, &m_yuv_pipeline_layout)
       != VK_SUCCESS)
   {
-    throw std::runtime_error {"failed to allocate transfer command buffers!"};
+    throw std::runtime_error {"failed to create pipeline layout!"};
   }
 
-  for (size_t i = 0; i < m_command_buffers.size(); ++i) {
-    VkCommandBufferBeginInfo begin_info = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
-        .pInheritanceInfo = nullptr,
-    };
+  m_yuv_pipeline = create_compute_pipeline(
+      shaders::embedded_spirv::rgb_to_yuv_comp, m_yuv_pipeline_layout);
+}
 
-    if (vkBeginCommandBuffer(m_command_buffers[i], &begin_info) != VK_SUCCESS) {
-      throw std::runtime_error {"failed to begin recording command buffer!"};
-    }
+void vktut::hello_triangle::application::record_yuv_conversion(
+    VkCommandBuffer command_buffer)
+{
+  auto frame = m_video_stream->acquire(m_current_frame);
+  if (!frame) {
+    return;
+  }
 
-    VkRenderPassBeginInfo render_pass_info = {
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .renderPass = m_render_pass,
-        .framebuffer = m_swap_chain_framebuffers[i],
-        .renderArea =
+  // the blit and the capture copy only read the scene image too, the
+  // transition just has to wait for them
+  if (m_async_compute) {
+    // converted on the compute queue while the graphics queue moves on to
+    // the next frame's pre-pass
+    auto release = m_async_compute->release(
+        m_scene_image.image,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        0,
+        true);
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &release);
+    // the scene pass starts from an undefined layout, so the image is never
+    // handed back
+    command_buffer = m_async_compute->begin(m_current_frame,
+                                            post_processing_pass);
+    auto acquire = m_async_compute->acquire(
+        m_scene_image.image,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_READ_BIT,
+        true);
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &acquire);
+    m_async_post_processing = true;
+  } else {
+    VkImageMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = m_scene_image.image,
+        .subresourceRange =
             {
-                .offset = {0, 0},
-                .extent = m_swap_chain_extent,
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
             },
     };
-
-    // should match attachment order in create_render_pass()
-    std::array clear_values = {
-        VkClearValue {
-            .color = {0, 0, 0, 1},
-        },
-        VkClearValue {
-            .depthStencil = {1, 0},
-        },
-    };
-    render_pass_info.clearValueCount = clear_values.size();
-    render_pass_info.pClearValues = clear_values.data();
-
-    vkCmdBeginRenderPass(
-        m_command_buffers[i], &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(m_command_buffers[i],
-                      VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      m_graphics_pipeline);
-    std::array vertex_buffers = {
-        m_vertex_buffer,
-    };
-    std::array offsets = {
-        VkDeviceSize {0},
-    };
-    vkCmdBindVertexBuffers(
-        m_command_buffers[i], 0, 1, vertex_buffers.data(), offsets.data());
-    vkCmdBindIndexBuffer(
-        m_command_buffers[i], m_index_buffer, 0, VK_INDEX_TYPE_UINT32);
-    vkCmdBindDescriptorSets(m_command_buffers[i],
-                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_pipeline_layout,
-                            0,
-                            1,
-                            &m_descriptor_sets[i],
-                            0,
-                            nullptr);
-    vkCmdDrawIndexed(m_command_buffers[i], m_indices.size(), 1, 0, 0, 0);
-    vkCmdEndRenderPass(m_command_buffers[i]);
-    if (vkEndCommandBuffer(m_command_buffers[i]) != VK_SUCCESS) {
-      throw std::runtime_error {"failed to record command buffer!"};
-    }
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &barrier);
   }
-}
 
-void vktut::hello_triangle::application::create_sync_objects()
-{
-  m_image_available_semaphores.resize(max_frames_in_flight);
-  m_render_finished_semaphores.resize(max_frames_in_flight);
-  m_in_flight_fences.resize(max_frames_in_flight);
-  m_images_in_flight.resize(m_swap_chain_images.size(), VK_NULL_HANDLE);
-  VkSemaphoreCreateInfo semaphore_info = {
-      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+  VkDescriptorSet descriptor_set =
+      m_frame_descriptor_allocators[m_current_frame].allocate(
+          m_yuv_set_layout);
+  shaders::yuv_descriptors descriptors = {
+      .source =
+          {
+              .sampler = m_yuv_sampler,
+              .imageView = m_scene_image_view,
+              .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+          },
+      .frame = *frame,
   };
-  VkFenceCreateInfo fence_info = {
-      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-      .flags = VK_FENCE_CREATE_SIGNALED_BIT,
+  vkUpdateDescriptorSetWithTemplate(
+      m_device, descriptor_set, m_yuv_update_template, &descriptors);
+
+  auto output_extent = m_video_stream->extent();
+  // the scene image is as large as the swap chain, the render extent moves
+  // with dynamic resolution and the window may have been resized since the
+  // stream started. all of it is scaled to the stream's fixed size.
+  auto constants = shaders::yuv_constants::from(
+      {output_extent.width, output_extent.height},
+      {m_render_extent.width, m_render_extent.height},
+      {m_swap_chain_extent.width, m_swap_chain_extent.height},
+      m_video_stream->interleaved_chroma(),
+      m_swap_chain_image_format == VK_FORMAT_B8G8R8A8_SRGB
+          || m_swap_chain_image_format == VK_FORMAT_R8G8B8A8_SRGB);
+
+  vkCmdBindPipeline(
+      command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_yuv_pipeline);
+  vkCmdBindDescriptorSets(command_buffer,
+                          VK_PIPELINE_BIND_POINT_COMPUTE,
+                          m_yuv_pipeline_layout,
+                          0,
+                          1,
+                          &descriptor_set,
+                          0,
+                          nullptr);
+  vkCmdPushConstants(command_buffer,
+                     m_yuv_pipeline_layout,
+                     VK_SHADER_STAGE_COMPUTE_BIT,
+                     0,
+                     sizeof(constants),
+                     &constants);
+  // matches local_size_x and local_size_y in rgb_to_yuv.comp, every
+  // invocation converts 8x2 pixels
+  constexpr std::uint32_t workgroup_size = 8;
+  vkCmdDispatch(
+      command_buffer,
+      (output_extent.width / 8 + workgroup_size - 1) / workgroup_size,
+      (output_extent.height / 2 + workgroup_size - 1) / workgroup_size,
+      1);
+
+  VkBufferMemoryBarrier host_barrier = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = frame->buffer,
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
   };
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       1,
+                       &host_barrier,
+                       0,
+                       nullptr);
+}
 
-  for (size_t i = 0; i < max_frames_in_flight; ++i) {
-    if (vkCreateSemaphore(m_device,
-                          &semaphore_info,
-                          nullptr,
-                          &m_image_available_semaphores[i])
-            != VK_SUCCESS
-        || vkCreateSemaphore(m_device,
+void vktut::hello_triangle::application::blit_scene_to_swap_chain(
+    VkCommandBuffer command_buffer, std::uint32_t image_index)
+{
+  VkImageMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = 0,
+      .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = m_swap_chain_images[image_index],
+      .subresourceRange =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .baseMipLevel = 0,
+              .levelCount = 1,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+  };
+  // the acquire semaphore is waited on at the transfer stage
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &barrier);
+
+  VkImageSubresourceLayers subresource = {
+      .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+      .mipLevel = 0,
+      .baseArrayLayer = 0,
+      .layerCount = 1,
+  };
+  if (m_scene_blit_supported) {
+    VkImageBlit blit = {
+        .srcSubresource = subresource,
+        .srcOffsets =
+            {
+                {0, 0, 0},
+                {static_cast<std::int32_t>(m_render_extent.width),
+                 static_cast<std::int32_t>(m_render_extent.height),
+                 1},
+            },
+        .dstSubresource = subresource,
+        .dstOffsets =
+            {
+                {0, 0, 0},
+                {static_cast<std::int32_t>(m_swap_chain_extent.width),
+                 static_cast<std::int32_t>(m_swap_chain_extent.height),
+                 1},
+            },
+    };
+    vkCmdBlitImage(command_buffer,
+                   m_scene_image.image,
+                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   m_swap_chain_images[image_index],
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   1,
+                   &blit,
+                   VK_FILTER_LINEAR);
+  } else {
+    VkImageCopy copy = {
+        .srcSubresource = subresource,
+        .srcOffset = {0, 0, 0},
+        .dstSubresource = subresource,
+        .dstOffset = {0, 0, 0},
+        .extent = {m_swap_chain_extent.width, m_swap_chain_extent.height, 1},
+    };
+    vkCmdCopyImage(command_buffer,
+                   m_scene_image.image,
+                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   m_swap_chain_images[image_index],
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   1,
+                   &copy);
+  }
+
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = 0;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &barrier);
+}
+
+void vktut::hello_triangle::application::create_command_pools()
+{
+  auto queue_family_indices =
+      vulkan::queue_family_indices::find(m_physical_device, m_surface);
+
+  // command buffers are re-recorded every frame with fresh push constants
+  VkCommandPoolCreateInfo pool_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = *queue_family_indices.graphics_family,
+  };
+
+  if (vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create command pool!"};
+  }
+
+  pool_info.queueFamilyIndex = *queue_family_indices.transfer_family;
+  if (vkCreateCommandPool(
+          m_device, &pool_info, nullptr, &m_transfer_command_pool)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create transfer command pool!"};
+  }
+}
+
+void vktut::hello_triangle::application::create_async_compute()
+{
+  auto indices =
+      vulkan::queue_family_indices::find(m_physical_device, m_surface);
+  if (!indices.compute_family) {
+    std::cout << "[vktut::hello_triangle::application::create_async_compute()]"
+              << " no second compute queue, compute passes stay on the "
+              << "graphics queue\n";
+    return;
+  }
+  m_async_compute =
+      std::make_unique<vulkan::async_compute>(m_device,
+                                              *indices.compute_family,
+                                              indices.compute_queue_index,
+                                              *indices.graphics_family,
+                                              max_frames_in_flight,
+                                              compute_pass_count);
+}
+
+void vktut::hello_triangle::application::create_command_buffers()
+{
+  m_command_buffers.resize(m_swap_chain_images.size());
+  m_transfer_command_buffers.resize(m_swap_chain_images.size());
+
+  VkCommandBufferAllocateInfo alloc_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = m_command_pool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount =
+          static_cast<std::uint32_t>(m_command_buffers.size()),
+  };
+
+  if (vkAllocateCommandBuffers(m_device, &alloc_info, m_command_buffers.data())
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to allocate command buffers!"};
+  }
+
+  if (m_async_compute) {
+    m_prepass_command_buffers.resize(m_swap_chain_images.size());
+    if (vkAllocateCommandBuffers(
+            m_device, &alloc_info, m_prepass_command_buffers.data())
+        != VK_SUCCESS)
+    {
+      throw std::runtime_error {"failed to allocate command buffers!"};
+    }
+  }
+
+  alloc_info.commandPool = m_transfer_command_pool;
+  alloc_info.commandBufferCount =
+      static_cast<std::uint32_t>(m_transfer_command_buffers.size());
+  if (vkAllocateCommandBuffers(
+          m_device, &alloc_info, m_transfer_command_buffers.data())
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to allocate transfer command buffers!"};
+  }
+}
+
+void vktut::hello_triangle::application::record_command_buffer(
+    std::uint32_t image_index)
+{
+  m_render_extent = m_scene_blit_supported
+      ? m_resolution_scaler->apply(m_swap_chain_extent)
+      : m_swap_chain_extent;
+
+  const auto& lod = select_lod();
+  VkDescriptorSet frame_descriptor_set =
+      allocate_frame_descriptor_set(image_index);
+
+  // meshlets only cover the full detail level, the coarser levels are cheap
+  // enough to draw whole. their draws are all for the model's instance
+  bool model_visible = std::binary_search(
+      m_visible_objects.begin(), m_visible_objects.end(), m_model_node);
+  bool cull_meshlets = m_meshlet_culling_supported && lod.first_index == 0
+      && model_visible;
+  // the pre-pass then goes into a submission of its own, which the culling
+  // pass waits for on the compute queue
+  m_async_culling = m_async_compute && cull_meshlets;
+  m_async_post_processing = false;
+
+  VkCommandBuffer command_buffer = m_command_buffers[image_index];
+  VkCommandBuffer first_command_buffer = m_async_culling
+      ? m_prepass_command_buffers[image_index]
+      : command_buffer;
+  begin_frame_commands(first_command_buffer);
+
+  auto first_query = static_cast<std::uint32_t>(2 * m_current_frame);
+  if (m_timestamp_query_pool != nullptr) {
+    vkCmdResetQueryPool(
+        first_command_buffer, m_timestamp_query_pool, first_query, 2);
+    vkCmdWriteTimestamp(first_command_buffer,
+                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        m_timestamp_query_pool,
+                        first_query);
+  }
+
+  if (m_depth_prepass) {
+    record_depth_prepass(first_command_buffer, lod, frame_descriptor_set);
+  }
+
+  if (m_async_culling) {
+    record_async_culling(first_command_buffer, command_buffer, image_index);
+  } else if (cull_meshlets) {
+    // the occluders come from this frame's pre-pass, so the test never lags
+    // behind the camera
+    if (m_depth_pyramid_supported) {
+      record_depth_pyramid(command_buffer);
+    }
+    record_meshlet_culling(
+        command_buffer, image_index, m_depth_pyramid_supported);
+  }
+
+  VkRenderPassBeginInfo render_pass_info = {
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+      .renderPass = m_render_pass,
+      .framebuffer = m_render_to_swap_chain
+          ? m_swap_chain_framebuffers[image_index]
+          : m_scene_framebuffer,
+      .renderArea =
+          {
+              .offset = {0, 0},
+              .extent = m_render_extent,
+          },
+  };
+
+  // should match attachment order in create_render_pass()
+  std::array clear_values = {
+      VkClearValue {
+          .color = {0, 0, 0, 1},
+      },
+      VkClearValue {
+          .depthStencil = {1, 0},
+      },
+  };
+  render_pass_info.clearValueCount = clear_values.size();
+  render_pass_info.pClearValues = clear_values.data();
+
+  vkCmdBeginRenderPass(
+      command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
+  vkCmdBindPipeline(
+      command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphics_pipeline);
+  set_render_viewport(command_buffer);
+  std::array vertex_buffers = {
+      m_model->vertex_buffer.buffer,
+  };
+  std::array offsets = {
+      VkDeviceSize {0},
+  };
+  vkCmdBindVertexBuffers(
+      command_buffer, 0, 1, vertex_buffers.data(), offsets.data());
+  vkCmdBindIndexBuffer(command_buffer,
+                       m_model->index_buffer.buffer,
+                       0,
+                       VK_INDEX_TYPE_UINT32);
+  std::array descriptor_sets = {
+      frame_descriptor_set,
+      m_bindless_descriptor_set,
+  };
+  // the bindless set is bound once, draws only change the texture index
+  vkCmdBindDescriptorSets(command_buffer,
+                          VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          m_pipeline_layout,
+                          0,
+                          m_material.bindless_textures ? 2 : 1,
+                          descriptor_sets.data(),
+                          0,
+                          nullptr);
+
+  auto push_constants =
+      shaders::push_constants::from(m_material.texture_index);
+  vkCmdPushConstants(command_buffer,
+                     m_pipeline_layout,
+                     VK_SHADER_STAGE_FRAGMENT_BIT,
+                     0,
+                     sizeof(push_constants),
+                     &push_constants);
+  if (cull_meshlets) {
+    auto meshlet_count = static_cast<std::uint32_t>(m_model->meshlets.size());
+    vkCmdDrawIndexedIndirect(command_buffer,
+                             m_draw_command_buffers[m_current_frame].buffer,
+                             0,
+                             meshlet_count,
+                             sizeof(VkDrawIndexedIndirectCommand));
+  } else {
+    for (auto object : m_visible_objects) {
+      vkCmdDrawIndexed(
+          command_buffer, lod.index_count, 1, lod.first_index, 0, object);
+    }
+  }
+  vkCmdEndRenderPass(command_buffer);
+
+  if (!m_render_to_swap_chain) {
+    blit_scene_to_swap_chain(command_buffer, image_index);
+  }
+  // the scene image is still in TRANSFER_SRC_OPTIMAL after the blit, and holds
+  // the frame at its render resolution
+  if (m_capturing) {
+    m_frame_capture->record(command_buffer,
+                            m_current_frame,
+                            m_scene_image.image,
+                            m_swap_chain_image_format,
+                            m_render_extent);
+  }
+  if (m_video_stream) {
+    record_yuv_conversion(command_buffer);
+  }
+  if (m_timestamp_query_pool != nullptr) {
+    vkCmdWriteTimestamp(command_buffer,
+                        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        m_timestamp_query_pool,
+                        first_query + 1);
+    m_timestamps_written[m_current_frame] = true;
+  }
+
+  if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to record command buffer!"};
+  }
+}
+
+void vktut::hello_triangle::application::begin_frame_commands(
+    VkCommandBuffer command_buffer)
+{
+  vkResetCommandBuffer(command_buffer, 0);
+
+  VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+      .pInheritanceInfo = nullptr,
+  };
+
+  if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to begin recording command buffer!"};
+  }
+}
+
+void vktut::hello_triangle::application::create_sync_objects()
+{
+  m_image_available_semaphores.resize(max_frames_in_flight);
+  m_render_finished_semaphores.resize(max_frames_in_flight);
+  m_in_flight_fences.resize(max_frames_in_flight);
+  m_images_in_flight.resize(m_swap_chain_images.size(), VK_NULL_HANDLE);
+  VkSemaphoreCreateInfo semaphore_info = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+  };
+  VkFenceCreateInfo fence_info = {
+      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+      .flags = VK_FENCE_CREATE_SIGNALED_BIT,
+  };
+
+  for (size_t i = 0; i < max_frames_in_flight; ++i) {
+    if (vkCreateSemaphore(m_device,
+                          &semaphore_info,
+                          nullptr,
+                          &m_image_available_semaphores[i])
+            != VK_SUCCESS
+        || vkCreateSemaphore(m_device,
                              &semaphore_info,
                              nullptr,
                              &m_render_finished_semaphores[i])
@@ -721,6 +1701,18 @@ void vktut::hello_triangle::application::draw_frame()
   if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
     throw std::runtime_error {"failed to acquire swap chain image!"};
   }
+  // the fence above guarantees no submitted work still reads these sets
+  m_frame_descriptor_allocators[m_current_frame].reset();
+  m_deletion_queue.collect();
+  if (m_frame_capture) {
+    m_frame_capture->frame_completed(m_current_frame);
+  }
+  if (m_video_stream) {
+    m_video_stream->frame_completed(m_current_frame);
+  }
+  if (auto gpu_frame_time = read_gpu_frame_time()) {
+    m_resolution_scaler->update(*gpu_frame_time);
+  }
   // 1b. if a previous frame is using this image, wait
   if (m_images_in_flight[image_index] != VK_NULL_HANDLE) {
     vkWaitForFences(m_device,
@@ -729,45 +1721,20 @@ void vktut::hello_triangle::application::draw_frame()
                     VK_TRUE,
                     std::numeric_limits<std::uint64_t>::max());
   }
+  m_images_in_flight[image_index] = m_in_flight_fences[m_current_frame];
   // 2. execute the command buffer with that image
-  update_uniform_buffer(image_index);
-
-  VkSubmitInfo submit_info = {
-      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-  };
-
-  std::array wait_semaphores = {
-      m_image_available_semaphores[m_current_frame],
-  };
-  std::array<VkPipelineStageFlags, 1> wait_stages = {
-      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-  };
-  submit_info.waitSemaphoreCount = 1;
-  submit_info.pWaitSemaphores = wait_semaphores.data();
-  submit_info.pWaitDstStageMask = wait_stages.data();
-  submit_info.commandBufferCount = 1;
-  submit_info.pCommandBuffers = &m_command_buffers[image_index];
+  update_scene();
+  record_command_buffer(image_index);
 
-  std::array signal_semaphores = {
-      m_render_finished_semaphores[m_current_frame],
-  };
-  submit_info.signalSemaphoreCount = 1;
-  submit_info.pSignalSemaphores = signal_semaphores.data();
+  // recorded against the uniform buffer, which only now gets the camera
+  latch_uniform_buffer(image_index);
+  submit_frame(image_index);
 
-  vkResetFences(m_device, 1, &m_in_flight_fences[m_current_frame]);
-  if (vkQueueSubmit(m_graphics_queue,
-                    1,
-                    &submit_info,
-                    m_in_flight_fences[m_current_frame])
-      != VK_SUCCESS)
-  {
-    throw std::runtime_error {"failed to submit draw command buffer!"};
-  }
   // 3. return the image to the swap chain for presentation
   VkPresentInfoKHR present_info = {
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
       .waitSemaphoreCount = 1,
-      .pWaitSemaphores = signal_semaphores.data(),
+      .pWaitSemaphores = &m_render_finished_semaphores[m_current_frame],
   };
 
   std::array swap_chains = {
@@ -788,85 +1755,346 @@ void vktut::hello_triangle::application::draw_frame()
     throw std::runtime_error {"failed to present swap chain image!"};
   }
   m_current_frame = (m_current_frame + 1) % max_frames_in_flight;
+  m_deletion_queue.next_frame();
+}
+
+void vktut::hello_triangle::application::submit_frame(
+    std::uint32_t image_index)
+{
+  // the last submission of the frame carries the fence, everything else of
+  // the frame is done by the time it is
+  VkFence fence = m_in_flight_fences[m_current_frame];
+  vkResetFences(m_device, 1, &fence);
+
+  std::array<VkSemaphore, 3> wait_semaphores = {
+      m_image_available_semaphores[m_current_frame],
+  };
+  // the swap chain image is first touched by the blit, or by the main pass
+  // when it renders into it
+  std::array<VkPipelineStageFlags, 3> wait_stages = {
+      m_render_to_swap_chain ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                             : VK_PIPELINE_STAGE_TRANSFER_BIT,
+  };
+  std::uint32_t wait_count = 1;
+
+  if (m_async_culling) {
+    VkSemaphore prepass_done =
+        m_async_compute->ready(m_current_frame, culling_pass);
+    VkSubmitInfo prepass_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &m_prepass_command_buffers[image_index],
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &prepass_done,
+    };
+    if (vkQueueSubmit(m_graphics_queue, 1, &prepass_info, nullptr)
+        != VK_SUCCESS)
+    {
+      throw std::runtime_error {"failed to submit pre-pass command buffer!"};
+    }
+    m_async_compute->submit(m_current_frame,
+                            culling_pass,
+                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                            true,
+                            nullptr);
+    // the draws read the culled commands, the depth tests the pre-pass depth
+    wait_semaphores[wait_count] =
+        m_async_compute->done(m_current_frame, culling_pass);
+    wait_stages[wait_count] = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT
+        | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+        | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    ++wait_count;
+  }
+  // the previous frame's conversion still reads the scene image this frame
+  // renders into
+  if (m_post_processing_done != nullptr) {
+    wait_semaphores[wait_count] = m_post_processing_done;
+    wait_stages[wait_count] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    ++wait_count;
+    m_post_processing_done = nullptr;
+  }
+
+  std::array signal_semaphores = {
+      m_render_finished_semaphores[m_current_frame],
+      m_async_compute
+          ? m_async_compute->ready(m_current_frame, post_processing_pass)
+          : VkSemaphore {nullptr},
+  };
+  VkSubmitInfo submit_info = {
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .waitSemaphoreCount = wait_count,
+      .pWaitSemaphores = wait_semaphores.data(),
+      .pWaitDstStageMask = wait_stages.data(),
+      .commandBufferCount = 1,
+      .pCommandBuffers = &m_command_buffers[image_index],
+      .signalSemaphoreCount = m_async_post_processing ? 2U : 1U,
+      .pSignalSemaphores = signal_semaphores.data(),
+  };
+  if (vkQueueSubmit(m_graphics_queue,
+                    1,
+                    &submit_info,
+                    m_async_post_processing ? nullptr : fence)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to submit draw command buffer!"};
+  }
+
+  if (m_async_post_processing) {
+    m_async_compute->submit(m_current_frame,
+                            post_processing_pass,
+                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                            true,
+                            fence);
+    m_post_processing_done =
+        m_async_compute->done(m_current_frame, post_processing_pass);
+  }
 }
 
 void vktut::hello_triangle::application::recreate_swap_chain()
 {
-  int width = 0;
-  int height = 0;
-  glfwGetFramebufferSize(m_window, &width, &height);
-  while (width == 0 || height == 0) {
-    glfwGetFramebufferSize(m_window, &width, &height);
-    glfwWaitEvents();
+  // minimized, nothing to render into until the window is restored
+  while (m_framebuffer_width == 0 || m_framebuffer_height == 0) {
+    if (!m_rendering) {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds {1});
+    process_window_events();
   }
-  vkDeviceWaitIdle(m_device);
 
+  // frames still in flight keep the old objects until they are done, the new
+  // swap chain takes over from the old one without draining the device
   cleanup_swap_chain();
 
   create_swap_chain();
   create_image_views();
   create_render_pass();
+  create_depth_prepass_render_pass();
   create_graphics_pipeline();
+  create_depth_prepass_pipeline();
   create_color_resources();
   create_depth_resources();
+  create_scene_target();
   create_framebuffers();
+  create_depth_pyramid();
   create_uniform_buffers();
-  create_descriptor_pool();
-  create_descriptor_sets();
   create_command_buffers();
+  // indices into the old swap chain, its fences are waited on by frame anyway
+  m_images_in_flight.assign(m_swap_chain_images.size(), VK_NULL_HANDLE);
 }
 
-void vktut::hello_triangle::application::cleanup_swap_chain()
+void vktut::hello_triangle::application::apply_quality_level()
 {
-  vkDestroyImageView(m_device, m_color_image_view, nullptr);
-  vkDestroyImage(m_device, m_color_image, nullptr);
-  vkFreeMemory(m_device, m_color_image_memory, nullptr);
-  vkDestroyImageView(m_device, m_depth_image_view, nullptr);
-  vkDestroyImage(m_device, m_depth_image, nullptr);
-  vkFreeMemory(m_device, m_depth_image_memory, nullptr);
-
-  for (auto* framebuffer : m_swap_chain_framebuffers) {
-    vkDestroyFramebuffer(m_device, framebuffer, nullptr);
-  }
-  vkFreeCommandBuffers(m_device,
-                       m_command_pool,
-                       m_command_buffers.size(),
-                       m_command_buffers.data());
-  vkDestroyPipeline(m_device, m_graphics_pipeline, nullptr);
-  vkDestroyPipelineLayout(m_device, m_pipeline_layout, nullptr);
-  vkDestroyRenderPass(m_device, m_render_pass, nullptr);
-  for (auto* image_view : m_swap_chain_image_views) {
-    vkDestroyImageView(m_device, image_view, nullptr);
-  }
-  vkDestroySwapchainKHR(m_device, m_swap_chain, nullptr);
+  const auto& quality = m_quality_governor->current();
+  std::cout << "[vktut::hello_triangle::application::apply_quality_level()] "
+            << quality.samples << "x msaa, sample shading "
+            << (quality.sample_shading ? "on" : "off") << "\n";
 
-  for (size_t i = 0; i < m_swap_chain_images.size(); ++i) {
-    vkDestroyBuffer(m_device, m_uniform_buffers[i], nullptr);
-    vkFreeMemory(m_device, m_uniform_buffers_memory[i], nullptr);
-  }
+  // only the sample count dependent objects are rebuilt, the swap chain and
+  // everything bound through descriptors stays as it is
+  retire_sample_count_resources();
 
-  vkDestroyDescriptorPool(m_device, m_descriptor_pool, nullptr);
+  m_msaa_samples = quality.samples;
+  create_render_pass();
+  create_depth_prepass_render_pass();
+  create_graphics_pipeline();
+  create_depth_prepass_pipeline();
+  create_color_resources();
+  create_depth_resources();
+  create_framebuffers();
 }
 
-void vktut::hello_triangle::application::update_uniform_buffer(
-    std::uint32_t current_image)
+void vktut::hello_triangle::application::cleanup_swap_chain()
 {
-  static auto start_time = std::chrono::high_resolution_clock::now();
+  // the handles are copied, the members are overwritten by the rebuild long
+  // before the queue gets to them
+  retire_sample_count_resources();
+
+  m_deletion_queue.push(
+      [device = m_device,
+       scene_image = m_scene_image,
+       scene_image_view = m_scene_image_view,
+       depth_pyramid = m_depth_pyramid,
+       depth_pyramid_view = m_depth_pyramid_view,
+       depth_pyramid_level_views = std::move(m_depth_pyramid_level_views)]
+      {
+        vkDestroyImageView(device, scene_image_view, nullptr);
+        vkDestroyImage(device, scene_image.image, nullptr);
+        vkFreeMemory(device, scene_image.memory, nullptr);
+
+        for (auto* image_view : depth_pyramid_level_views) {
+          vkDestroyImageView(device, image_view, nullptr);
+        }
+        vkDestroyImageView(device, depth_pyramid_view, nullptr);
+        vkDestroyImage(device, depth_pyramid.image, nullptr);
+        vkFreeMemory(device, depth_pyramid.memory, nullptr);
+      });
+  m_depth_pyramid_level_views.clear();
+
+  // the old swap chain stays alive until it has been handed to
+  // vkCreateSwapchainKHR and its last presented frame is done
+  m_deletion_queue.push(
+      [device = m_device,
+       command_pool = m_command_pool,
+       command_buffers = m_command_buffers,
+       prepass_command_buffers = m_prepass_command_buffers,
+       transfer_command_pool = m_transfer_command_pool,
+       transfer_command_buffers = m_transfer_command_buffers,
+       swap_chain = m_swap_chain,
+       swap_chain_image_views = m_swap_chain_image_views,
+       uniform_buffers = m_uniform_buffers,
+       uniform_buffers_memory = m_uniform_buffers_memory]
+      {
+        vkFreeCommandBuffers(device,
+                             command_pool,
+                             command_buffers.size(),
+                             command_buffers.data());
+        if (!prepass_command_buffers.empty()) {
+          vkFreeCommandBuffers(device,
+                               command_pool,
+                               prepass_command_buffers.size(),
+                               prepass_command_buffers.data());
+        }
+        vkFreeCommandBuffers(device,
+                             transfer_command_pool,
+                             transfer_command_buffers.size(),
+                             transfer_command_buffers.data());
+        for (auto* image_view : swap_chain_image_views) {
+          vkDestroyImageView(device, image_view, nullptr);
+        }
+        vkDestroySwapchainKHR(device, swap_chain, nullptr);
+
+        for (size_t i = 0; i < uniform_buffers.size(); ++i) {
+          vkUnmapMemory(device, uniform_buffers_memory[i]);
+          vkDestroyBuffer(device, uniform_buffers[i], nullptr);
+          vkFreeMemory(device, uniform_buffers_memory[i], nullptr);
+        }
+      });
+}
 
-  auto current_time = std::chrono::high_resolution_clock::now();
-  float time = std::chrono::duration<float, std::chrono::seconds::period>(
-                   current_time - start_time)
-                   .count();
+void vktut::hello_triangle::application::retire_sample_count_resources()
+{
+  m_deletion_queue.push(
+      [device = m_device,
+       color_image = m_color_image,
+       color_image_view = m_color_image_view,
+       depth_image = m_depth_image,
+       depth_image_view = m_depth_image_view,
+       scene_framebuffer = m_scene_framebuffer,
+       swap_chain_framebuffers = std::move(m_swap_chain_framebuffers),
+       depth_prepass_framebuffer = m_depth_prepass_framebuffer,
+       graphics_pipeline = m_graphics_pipeline,
+       depth_prepass_pipeline = m_depth_prepass_pipeline,
+       pipeline_layout = m_pipeline_layout,
+       render_pass = m_render_pass,
+       depth_prepass_render_pass = m_depth_prepass_render_pass]
+      {
+        vkDestroyImageView(device, color_image_view, nullptr);
+        vkDestroyImage(device, color_image.image, nullptr);
+        vkFreeMemory(device, color_image.memory, nullptr);
+        vkDestroyImageView(device, depth_image_view, nullptr);
+        vkDestroyImage(device, depth_image.image, nullptr);
+        vkFreeMemory(device, depth_image.memory, nullptr);
+        vkDestroyFramebuffer(device, scene_framebuffer, nullptr);
+        for (auto* framebuffer : swap_chain_framebuffers) {
+          vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
+        vkDestroyFramebuffer(device, depth_prepass_framebuffer, nullptr);
+        vkDestroyPipeline(device, graphics_pipeline, nullptr);
+        vkDestroyPipeline(device, depth_prepass_pipeline, nullptr);
+        vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
+        vkDestroyRenderPass(device, render_pass, nullptr);
+        vkDestroyRenderPass(device, depth_prepass_render_pass, nullptr);
+      });
+}
+
+const vktut::geometry::lod_level&
+vktut::hello_triangle::application::select_lod()
+{
+  const auto& lod_chain = m_model->lod_chain;
+  glm::vec3 center = m_model_transform * glm::vec4 {lod_chain.center, 1.0F};
+  // measured to the near side of the bounding sphere so a mesh right in front
+  // of the camera never picks a coarse level
+  float distance = std::max(glm::distance(m_camera_position, center)
+                               - lod_chain.radius - m_camera_drift,
+                           0.1F);
+  float pixels_per_unit = static_cast<float>(m_render_extent.height)
+      / (2.0F * std::tan(glm::radians(field_of_view_degrees) / 2.0F)
+         * distance);
+  return lod_chain.select(pixels_per_unit, lod_pixel_threshold);
+}
+
+void vktut::hello_triangle::application::update_scene()
+{
+  // whatever the main thread published last, possibly the same as last frame.
+  // culling and level selection use this camera, the shaders a later one
+  const auto& state = m_simulation.read();
+  m_camera_position = state.camera_position;
+  m_frame_sampled_at = state.sampled_at;
+  // the camera only orbits, at most this fast. the latch is expected to come
+  // as late as last frame's, plus a simulation step for the main thread
+  float orbit_speed = glm::length(glm::vec2 {m_camera_position})
+      * glm::radians(camera_turn_degrees_per_second);
+  m_camera_drift = orbit_speed
+      * (std::chrono::duration<float, std::chrono::seconds::period>(
+             m_latch_lag)
+             .count()
+         + static_cast<float>(simulation_step_seconds));
+
+  m_scene.set_rotation(m_model_node,
+                       glm::angleAxis(state.time * glm::radians(90.0F),
+                                      glm::vec3 {0.0F, 0.0F, 1.0F}));
+  m_scene.update();
+  // the fence of this frame has signaled, nothing reads its copy anymore
+  m_scene.write_instances(m_instance_data[m_current_frame],
+                          m_instance_generations[m_current_frame]);
+
+  auto ubo = camera_uniforms(state);
+  m_model_transform = ubo.model;
+  m_view_projection = ubo.proj * ubo.view;
+
+  // the sphere grows with the largest scale on any axis
+  float scale = std::max({glm::length(glm::vec3 {m_model_transform[0]}),
+                          glm::length(glm::vec3 {m_model_transform[1]}),
+                          glm::length(glm::vec3 {m_model_transform[2]})});
+  const auto& lod_chain = m_model->lod_chain;
+  m_frustum_culler.set(
+      m_model_node,
+      glm::vec3 {m_model_transform * glm::vec4 {lod_chain.center, 1.0F}},
+      lod_chain.radius * scale + m_camera_drift);
+  m_frustum_culler.cull(m_view_projection, m_visible_objects, m_jobs.get());
+}
+
+void vktut::hello_triangle::application::latch_uniform_buffer(
+    std::uint32_t current_image)
+{
+  // the image's fence has signaled, the gpu is done with its uniform buffer
+  const auto& state = m_simulation.read();
+  *m_uniform_data[current_image] = camera_uniforms(state);
+
+  m_latch_lag = std::max(state.sampled_at - m_frame_sampled_at,
+                         std::chrono::high_resolution_clock::duration {});
+
+  auto now = std::chrono::high_resolution_clock::now();
+  m_early_latency_ms +=
+      std::chrono::duration<double, std::milli>(now - m_frame_sampled_at)
+          .count();
+  m_latched_latency_ms +=
+      std::chrono::duration<double, std::milli>(now - state.sampled_at)
+          .count();
+  ++m_latched_frames;
+}
 
+vktut::shaders::uniform_buffer_object
+vktut::hello_triangle::application::camera_uniforms(
+    const simulation_state& state) const
+{
   shaders::uniform_buffer_object ubo = {
-      .model = glm::rotate(glm::mat4 {1.0F},
-                           time * glm::radians(90.0F),
-                           glm::vec3 {0.0F, 0.0F, 1.0F}),
-      .view = glm::lookAt(glm::vec3 {30.0F, 30.0F, 30.0F},
+      .model = m_scene.world(m_model_node),
+      .view = glm::lookAt(state.camera_position,
                           glm::vec3 {0.0F, 0.0F, 0.0F},
                           glm::vec3 {0.0F, 0.0F, 1.0F}),
       .proj =
-          glm::perspective(glm::radians(45.0F),
+          glm::perspective(glm::radians(field_of_view_degrees),
                            static_cast<float>(m_swap_chain_extent.width)
                                / static_cast<float>(m_swap_chain_extent.height),
                            0.1F,
@@ -875,17 +2103,7 @@ void vktut::hello_triangle::application::update_uniform_buffer(
 
   // flip y axis, vulkan has a sensible y axis unlike ogl
   ubo.proj[1][1] *= -1;
-
-  void* data = nullptr;
-  vkMapMemory(m_device,
-              m_uniform_buffers_memory[current_image],
-              0,
-              sizeof(shaders::uniform_buffer_object),
-              0,
-              &data);
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-  std::copy(&ubo, &ubo + 1, static_cast<shaders::uniform_buffer_object*>(data));
-  vkUnmapMemory(m_device, m_uniform_buffers_memory[current_image]);
+  return ubo;
 }
 
 vktut::vulkan::swap_chain_support_details
@@ -918,83 +2136,591 @@ vktut::hello_triangle::application::query_swap_chain_support(
   return details;
 }
 
-void vktut::hello_triangle::application::create_swap_chain()
+void vktut::hello_triangle::application::create_swap_chain()
+{
+  auto swap_chain_support = query_swap_chain_support(m_physical_device);
+
+  auto surface_format = choose_swap_surface_format(swap_chain_support.formats);
+  auto present_mode =
+      choose_swap_present_mode(swap_chain_support.present_modes);
+  auto extent = choose_swap_extent(swap_chain_support.capabilities);
+
+  std::uint32_t image_count = swap_chain_support.capabilities.minImageCount + 1;
+  if (swap_chain_support.capabilities.maxImageCount > 0
+      && image_count > swap_chain_support.capabilities.maxImageCount)
+  {
+    image_count = swap_chain_support.capabilities.maxImageCount;
+  }
+
+  VkSwapchainCreateInfoKHR create_info = {
+      .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
+      .surface = m_surface,
+      .minImageCount = image_count,
+      .imageFormat = surface_format.format,
+      .imageColorSpace = surface_format.colorSpace,
+      .imageExtent = extent,
+      .imageArrayLayers = 1,
+      .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+  };
+  // the scene is rendered offscreen and blitted in, where the surface allows
+  m_render_to_swap_chain =
+      (swap_chain_support.capabilities.supportedUsageFlags
+       & VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+      == 0U;
+  if (!m_render_to_swap_chain) {
+    create_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  }
+
+  auto indices =
+      vulkan::queue_family_indices::find(m_physical_device, m_surface);
+  std::array queue_family_indices = {
+      *indices.graphics_family,
+      *indices.present_family,
+      *indices.transfer_family,
+  };
+
+  std::array dedup_queue_family_indices = {
+      *indices.graphics_family,
+      *indices.transfer_family,
+  };
+
+  create_info.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+  if (indices.graphics_family != indices.present_family) {
+    create_info.queueFamilyIndexCount = 3;
+    create_info.pQueueFamilyIndices = queue_family_indices.data();
+  } else {
+    create_info.queueFamilyIndexCount = 2;
+    create_info.pQueueFamilyIndices = dedup_queue_family_indices.data();
+  }
+
+  create_info.preTransform = swap_chain_support.capabilities.currentTransform;
+  create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+  create_info.presentMode = present_mode;
+  create_info.clipped = VK_TRUE;
+  // still alive when rebuilding, lets the driver hand over the old images
+  // while frames presented from them are in flight
+  create_info.oldSwapchain = m_swap_chain;
+  if (vkCreateSwapchainKHR(m_device, &create_info, nullptr, &m_swap_chain)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create swap chain!"};
+  }
+
+  vkGetSwapchainImagesKHR(m_device, m_swap_chain, &image_count, nullptr);
+  m_swap_chain_images.resize(image_count);
+  vkGetSwapchainImagesKHR(
+      m_device, m_swap_chain, &image_count, m_swap_chain_images.data());
+  m_swap_chain_image_format = surface_format.format;
+  m_swap_chain_extent = extent;
+}
+
+void vktut::hello_triangle::application::create_graphics_pipeline()
+{
+  VkShaderModule vert_shader_module =
+      create_shader_module(m_material.vertex_spirv());
+  VkShaderModule frag_shader_module =
+      create_shader_module(m_material.fragment_spirv());
+
+  auto fragment_constants = m_material.specialization();
+  auto fragment_map_entries = shaders::fragment_constants::map_entries();
+  VkSpecializationInfo fragment_specialization = {
+      .mapEntryCount = fragment_map_entries.size(),
+      .pMapEntries = fragment_map_entries.data(),
+      .dataSize = sizeof(fragment_constants),
+      .pData = &fragment_constants,
+  };
+
+  VkPipelineShaderStageCreateInfo vert_shader_stage_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+      .stage = VK_SHADER_STAGE_VERTEX_BIT,
+      .module = vert_shader_module,
+      .pName = "main",
+  };
+  VkPipelineShaderStageCreateInfo frag_shader_stage_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+      .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .module = frag_shader_module,
+      .pName = "main",
+      .pSpecializationInfo = &fragment_specialization,
+  };
+
+  std::array shader_stages = {
+      vert_shader_stage_info,
+      frag_shader_stage_info,
+  };
+
+  auto binding_description = shaders::vertex::binding_description();
+  auto attribute_descriptions = m_material.attribute_descriptions();
+
+  VkPipelineVertexInputStateCreateInfo vertex_input_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+      .vertexBindingDescriptionCount = 1,
+      .pVertexBindingDescriptions = &binding_description,
+      .vertexAttributeDescriptionCount =
+          static_cast<std::uint32_t>(attribute_descriptions.size()),
+      .pVertexAttributeDescriptions = attribute_descriptions.data(),
+  };
+
+  VkPipelineInputAssemblyStateCreateInfo input_assembly = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+      .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+      .primitiveRestartEnable = VK_FALSE,
+  };
+
+  // viewport and scissor are dynamic, they follow the render resolution
+  VkPipelineViewportStateCreateInfo viewport_state = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+      .viewportCount = 1,
+      .pViewports = nullptr,
+      .scissorCount = 1,
+      .pScissors = nullptr,
+  };
+
+  VkPipelineRasterizationStateCreateInfo rasterizer = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+      .depthClampEnable = VK_FALSE,
+      .rasterizerDiscardEnable = VK_FALSE,
+      .polygonMode = VK_POLYGON_MODE_FILL,
+      .cullMode = VK_CULL_MODE_BACK_BIT,
+      .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+      .depthBiasEnable = VK_FALSE,
+      .depthBiasConstantFactor = 0,
+      .depthBiasClamp = 0,
+      .depthBiasSlopeFactor = 0,
+      .lineWidth = 1,
+  };
+
+  const auto& quality = m_quality_governor->current();
+  VkPipelineMultisampleStateCreateInfo multisampling = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+      .rasterizationSamples = quality.samples,
+      .sampleShadingEnable = quality.sample_shading ? VK_TRUE : VK_FALSE,
+      .minSampleShading = quality.min_sample_shading,
+      .pSampleMask = nullptr,
+      .alphaToCoverageEnable = VK_FALSE,
+      .alphaToOneEnable = VK_FALSE,
+  };
+
+  VkPipelineColorBlendAttachmentState color_blend_attachment = {
+      .blendEnable = VK_FALSE,
+      .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
+      .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
+      .colorBlendOp = VK_BLEND_OP_ADD,
+      .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+      .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+      .alphaBlendOp = VK_BLEND_OP_ADD,
+      .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+          | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+  };
+
+  VkPipelineColorBlendStateCreateInfo color_blending = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+      .logicOpEnable = VK_FALSE,
+      .logicOp = VK_LOGIC_OP_COPY,
+      .attachmentCount = 1,
+      .pAttachments = &color_blend_attachment,
+      .blendConstants = {0, 0, 0, 0},
+  };
+
+  std::array dynamic_states = {
+      VK_DYNAMIC_STATE_VIEWPORT,
+      VK_DYNAMIC_STATE_SCISSOR,
+  };
+
+  VkPipelineDynamicStateCreateInfo dynamic_state = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+      .dynamicStateCount = dynamic_states.size(),
+      .pDynamicStates = dynamic_states.data(),
+  };
+
+  VkPushConstantRange push_constant_range = {
+      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .offset = 0,
+      .size = sizeof(shaders::push_constants),
+  };
+
+  std::array set_layouts = {
+      m_descriptor_set_layout,
+      m_bindless_set_layout,
+  };
+
+  VkPipelineLayoutCreateInfo pipeline_layout_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = m_material.bindless_textures ? 2U : 1U,
+      .pSetLayouts = set_layouts.data(),
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &push_constant_range,
+  };
+
+  if (vkCreatePipelineLayout(
+          m_device, &pipeline_layout_info, nullptr, &m_pipeline_layout)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create pipeline layout!"};
+  }
+
+  // the pre-pass already wrote the nearest depth, only fragments matching it
+  // get shaded
+  VkPipelineDepthStencilStateCreateInfo depth_stencil = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+      .depthTestEnable = VK_TRUE,
+      .depthWriteEnable = m_depth_prepass ? VK_FALSE : VK_TRUE,
+      .depthCompareOp = m_depth_prepass ? VK_COMPARE_OP_LESS_OR_EQUAL
+                                        : VK_COMPARE_OP_LESS,
+      .depthBoundsTestEnable = VK_FALSE,
+      .stencilTestEnable = VK_FALSE,
+      .front = {},
+      .back = {},
+      .minDepthBounds = 0,
+      .maxDepthBounds = 1,
+  };
+
+  VkGraphicsPipelineCreateInfo pipeline_info = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+      .stageCount = 2,
+      .pStages = shader_stages.data(),
+      .pVertexInputState = &vertex_input_info,
+      .pInputAssemblyState = &input_assembly,
+      .pViewportState = &viewport_state,
+      .pRasterizationState = &rasterizer,
+      .pMultisampleState = &multisampling,
+      .pDepthStencilState = &depth_stencil,
+      .pColorBlendState = &color_blending,
+      .pDynamicState = &dynamic_state,
+      .layout = m_pipeline_layout,
+      .renderPass = m_render_pass,
+      .subpass = 0,
+      .basePipelineHandle = VK_NULL_HANDLE,
+      .basePipelineIndex = -1,
+  };
+
+  if (vkCreateGraphicsPipelines(m_device,
+                                VK_NULL_HANDLE,
+                                1,
+                                &pipeline_info,
+                                nullptr,
+                                &m_graphics_pipeline)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create graphics pipeline!"};
+  }
+
+  vkDestroyShaderModule(m_device, vert_shader_module, nullptr);
+  vkDestroyShaderModule(m_device, frag_shader_module, nullptr);
+}
+
+void vktut::hello_triangle::application::create_asset_manager()
+{
+  auto backend = assets::asset_manager::backend {
+      .create_texture = [this](std::span<const std::byte> file_bytes)
+      { return load_texture(file_bytes); },
+      .destroy_texture =
+          [this](const vulkan::texture& texture)
+      {
+        vkDestroyImageView(m_device, texture.view, nullptr);
+        vkDestroyImage(m_device, texture.image, nullptr);
+        vkFreeMemory(m_device, texture.memory, nullptr);
+      },
+      .upload_buffer = [this](std::span<const std::byte> data,
+                              VkBufferUsageFlags usage)
+      { return upload_buffer(data, usage); },
+      .destroy_buffer =
+          [this](const vulkan::buffer_and_memory& buffer)
+      {
+        vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+        vkFreeMemory(m_device, buffer.memory, nullptr);
+      },
+  };
+  // the pool is shared with culling, model loading is done before that starts
+  m_jobs = std::make_unique<utilities::thread_pool>(
+      std::max(std::thread::hardware_concurrency(), 2U) - 1);
+  m_assets = std::make_unique<assets::asset_manager>(
+      std::move(backend), max_lod_levels, m_jobs.get());
+}
+
+void vktut::hello_triangle::application::create_meshlet_buffers()
+{
+  // meshes uploaded straight from a glb file have no meshlets to cull
+  if (m_model->meshlets.empty()
+      || m_model->meshlets.size() > m_max_draw_indirect_count)
+  {
+    m_meshlet_culling_supported = false;
+  }
+  if (!m_meshlet_culling_supported) {
+    return;
+  }
+
+  auto meshlets = upload_buffer(std::as_bytes(std::span {m_model->meshlets}),
+                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  m_meshlet_buffer = meshlets.buffer;
+  m_meshlet_buffer_memory = meshlets.memory;
+
+  for (size_t i = 0; i < max_frames_in_flight; ++i) {
+    m_draw_command_buffers.push_back(create_buffer(
+        sizeof(VkDrawIndexedIndirectCommand) * m_model->meshlets.size(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+            | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+    m_draw_count_buffers.push_back(
+        create_buffer(sizeof(std::uint32_t),
+                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                          | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+  }
+}
+
+void vktut::hello_triangle::application::create_cull_pipeline()
+{
+  if (!m_meshlet_culling_supported) {
+    return;
+  }
+
+  auto bindings = shaders::cull_descriptors::layout_bindings();
+  m_cull_set_layout = m_descriptor_layout_cache->get(
+      std::vector<VkDescriptorSetLayoutBinding> {bindings.begin(),
+                                                 bindings.end()});
+
+  auto entries = shaders::cull_descriptors::template_entries();
+  VkDescriptorUpdateTemplateCreateInfo template_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+      .descriptorUpdateEntryCount = entries.size(),
+      .pDescriptorUpdateEntries = entries.data(),
+      .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+      .descriptorSetLayout = m_cull_set_layout,
+  };
+  if (vkCreateDescriptorUpdateTemplate(
+          m_device, &template_info, nullptr, &m_cull_update_template)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create descriptor update template!"};
+  }
+
+  VkPushConstantRange push_constant_range = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = sizeof(shaders::cull_constants),
+  };
+  VkPipelineLayoutCreateInfo pipeline_layout_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &m_cull_set_layout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &push_constant_range,
+  };
+  if (vkCreatePipelineLayout(
+          m_device, &pipeline_layout_info, nullptr, &m_cull_pipeline_layout)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create pipeline layout!"};
+  }
+
+  m_cull_pipeline = create_compute_pipeline(
+      shaders::embedded_spirv::cull_meshlets_comp, m_cull_pipeline_layout);
+}
+
+void vktut::hello_triangle::application::record_meshlet_culling(
+    VkCommandBuffer command_buffer, std::uint32_t image_index, bool occlusion)
+{
+  const auto& draw_commands = m_draw_command_buffers[m_current_frame];
+  const auto& draw_count = m_draw_count_buffers[m_current_frame];
+
+  // culled meshlets leave their slot zeroed, which draws nothing
+  vkCmdFillBuffer(command_buffer, draw_commands.buffer, 0, VK_WHOLE_SIZE, 0);
+  vkCmdFillBuffer(command_buffer, draw_count.buffer, 0, VK_WHOLE_SIZE, 0);
+  VkMemoryBarrier cleared = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+  };
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       0,
+                       1,
+                       &cleared,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr);
+
+  VkDescriptorSet descriptor_set =
+      m_frame_descriptor_allocators[m_current_frame].allocate(
+          m_cull_set_layout);
+  shaders::cull_descriptors descriptors = {
+      .meshlets =
+          {
+              .buffer = m_meshlet_buffer,
+              .offset = 0,
+              .range = VK_WHOLE_SIZE,
+          },
+      .draw_commands =
+          {
+              .buffer = draw_commands.buffer,
+              .offset = 0,
+              .range = VK_WHOLE_SIZE,
+          },
+      .draw_count =
+          {
+              .buffer = draw_count.buffer,
+              .offset = 0,
+              .range = VK_WHOLE_SIZE,
+          },
+      .uniform_buffer =
+          {
+              .buffer = m_uniform_buffers[image_index],
+              .offset = 0,
+              .range = sizeof(shaders::uniform_buffer_object),
+          },
+      // bound even when it wasn't built this frame, the shader then never
+      // reads it
+      .depth_pyramid =
+          {
+              .sampler = m_depth_pyramid_sampler,
+              .imageView = m_depth_pyramid_view,
+              .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+          },
+  };
+  vkUpdateDescriptorSetWithTemplate(
+      m_device, descriptor_set, m_cull_update_template, &descriptors);
+
+  auto meshlet_count = static_cast<std::uint32_t>(m_model->meshlets.size());
+  // the frustum and the camera come from the uniform buffer, latched after
+  // this is recorded
+  auto constants = shaders::cull_constants::from(
+      meshlet_count,
+      occlusion ? glm::uvec2 {m_render_extent.width, m_render_extent.height}
+                : glm::uvec2 {0, 0});
+  vkCmdBindPipeline(
+      command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cull_pipeline);
+  vkCmdBindDescriptorSets(command_buffer,
+                          VK_PIPELINE_BIND_POINT_COMPUTE,
+                          m_cull_pipeline_layout,
+                          0,
+                          1,
+                          &descriptor_set,
+                          0,
+                          nullptr);
+  vkCmdPushConstants(command_buffer,
+                     m_cull_pipeline_layout,
+                     VK_SHADER_STAGE_COMPUTE_BIT,
+                     0,
+                     sizeof(constants),
+                     &constants);
+  // matches local_size_x in cull_meshlets.comp
+  constexpr std::uint32_t workgroup_size = 64;
+  vkCmdDispatch(command_buffer,
+                (meshlet_count + workgroup_size - 1) / workgroup_size,
+                1,
+                1);
+
+  VkMemoryBarrier written = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+  };
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                       0,
+                       1,
+                       &written,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr);
+}
+
+void vktut::hello_triangle::application::create_depth_prepass_render_pass()
 {
-  auto swap_chain_support = query_swap_chain_support(m_physical_device);
-
-  auto surface_format = choose_swap_surface_format(swap_chain_support.formats);
-  auto present_mode =
-      choose_swap_present_mode(swap_chain_support.present_modes);
-  auto extent = choose_swap_extent(swap_chain_support.capabilities);
-
-  std::uint32_t image_count = swap_chain_support.capabilities.minImageCount + 1;
-  if (swap_chain_support.capabilities.maxImageCount > 0
-      && image_count > swap_chain_support.capabilities.maxImageCount)
-  {
-    image_count = swap_chain_support.capabilities.maxImageCount;
+  if (!m_depth_prepass) {
+    return;
   }
 
-  VkSwapchainCreateInfoKHR create_info = {
-      .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
-      .surface = m_surface,
-      .minImageCount = image_count,
-      .imageFormat = surface_format.format,
-      .imageColorSpace = surface_format.colorSpace,
-      .imageExtent = extent,
-      .imageArrayLayers = 1,
-      .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+  VkAttachmentDescription depth_attachment = {
+      .format = find_depth_format(),
+      .samples = m_msaa_samples,
+      .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+      // kept for the main pass and the depth pyramid
+      .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+      .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+      .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
   };
 
-  auto indices =
-      vulkan::queue_family_indices::find(m_physical_device, m_surface);
-  std::array queue_family_indices = {
-      *indices.graphics_family,
-      *indices.present_family,
-      *indices.transfer_family,
+  VkAttachmentReference depth_attachment_ref = {
+      .attachment = 0,
+      .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
   };
 
-  std::array dedup_queue_family_indices = {
-      *indices.graphics_family,
-      *indices.transfer_family,
+  VkSubpassDescription subpass = {
+      .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+      .colorAttachmentCount = 0,
+      .pDepthStencilAttachment = &depth_attachment_ref,
   };
 
-  create_info.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-  if (indices.graphics_family != indices.present_family) {
-    create_info.queueFamilyIndexCount = 3;
-    create_info.pQueueFamilyIndices = queue_family_indices.data();
-  } else {
-    create_info.queueFamilyIndexCount = 2;
-    create_info.pQueueFamilyIndices = dedup_queue_family_indices.data();
-  }
+  std::array dependencies = {
+      // the previous frame's main pass and depth pyramid have to finish
+      // reading the depth buffer before it is cleared
+      VkSubpassDependency {
+          .srcSubpass = VK_SUBPASS_EXTERNAL,
+          .dstSubpass = 0,
+          .srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+              | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+              | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+              | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+          .srcAccessMask = 0,
+          .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+              | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+      },
+      VkSubpassDependency {
+          .srcSubpass = 0,
+          .dstSubpass = VK_SUBPASS_EXTERNAL,
+          .srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+              | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+              | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+          .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+              | VK_ACCESS_SHADER_READ_BIT,
+      },
+  };
 
-  create_info.preTransform = swap_chain_support.capabilities.currentTransform;
-  create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-  create_info.presentMode = present_mode;
-  create_info.clipped = VK_TRUE;
-  create_info.oldSwapchain = VK_NULL_HANDLE;
-  if (vkCreateSwapchainKHR(m_device, &create_info, nullptr, &m_swap_chain)
+  VkRenderPassCreateInfo render_pass_info = {
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+      .attachmentCount = 1,
+      .pAttachments = &depth_attachment,
+      .subpassCount = 1,
+      .pSubpasses = &subpass,
+      .dependencyCount = dependencies.size(),
+      .pDependencies = dependencies.data(),
+  };
+
+  if (vkCreateRenderPass(
+          m_device, &render_pass_info, nullptr, &m_depth_prepass_render_pass)
       != VK_SUCCESS)
   {
-    throw std::runtime_error {"failed to create swap chain!"};
+    throw std::runtime_error {"failed to create render pass!"};
   }
-
-  vkGetSwapchainImagesKHR(m_device, m_swap_chain, &image_count, nullptr);
-  m_swap_chain_images.resize(image_count);
-  vkGetSwapchainImagesKHR(
-      m_device, m_swap_chain, &image_count, m_swap_chain_images.data());
-  m_swap_chain_image_format = surface_format.format;
-  m_swap_chain_extent = extent;
 }
 
-void vktut::hello_triangle::application::create_graphics_pipeline()
+void vktut::hello_triangle::application::create_depth_prepass_pipeline()
 {
-  auto vert_shader_code =
-      utilities::files::read_file("Resources/Shaders/basic.vert.spv");
-  auto frag_shader_code =
-      utilities::files::read_file("Resources/Shaders/basic.frag.spv");
+  if (!m_depth_prepass) {
+    return;
+  }
 
-  VkShaderModule vert_shader_module = create_shader_module(vert_shader_code);
-  VkShaderModule frag_shader_module = create_shader_module(frag_shader_code);
+  // the plain permutation only reads positions and has no fragment outputs
+  shaders::material depth_only = {
+      .textured = false,
+      .vertex_colors = false,
+      .bindless_textures = false,
+      .base_color = {1.0F, 1.0F, 1.0F},
+      .texture_index = 0,
+  };
+  VkShaderModule vert_shader_module =
+      create_shader_module(depth_only.vertex_spirv());
 
   VkPipelineShaderStageCreateInfo vert_shader_stage_info = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -1002,26 +2728,16 @@ void vktut::hello_triangle::application::create_graphics_pipeline()
       .module = vert_shader_module,
       .pName = "main",
   };
-  VkPipelineShaderStageCreateInfo frag_shader_stage_info = {
-      .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-      .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-      .module = frag_shader_module,
-      .pName = "main",
-  };
-
-  std::array shader_stages = {
-      vert_shader_stage_info,
-      frag_shader_stage_info,
-  };
 
   auto binding_description = shaders::vertex::binding_description();
-  auto attribute_descriptions = shaders::vertex::attribute_descriptions();
+  auto attribute_descriptions = depth_only.attribute_descriptions();
 
   VkPipelineVertexInputStateCreateInfo vertex_input_info = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
       .vertexBindingDescriptionCount = 1,
       .pVertexBindingDescriptions = &binding_description,
-      .vertexAttributeDescriptionCount = attribute_descriptions.size(),
+      .vertexAttributeDescriptionCount =
+          static_cast<std::uint32_t>(attribute_descriptions.size()),
       .pVertexAttributeDescriptions = attribute_descriptions.data(),
   };
 
@@ -1031,28 +2747,15 @@ void vktut::hello_triangle::application::create_graphics_pipeline()
       .primitiveRestartEnable = VK_FALSE,
   };
 
-  VkViewport viewport = {
-      .x = 0,
-      .y = 0,
-      .width = static_cast<float>(m_swap_chain_extent.width),
-      .height = static_cast<float>(m_swap_chain_extent.height),
-      .minDepth = 0,
-      .maxDepth = 1,
-  };
-
-  VkRect2D scissor = {
-      .offset = {0, 0},
-      .extent = m_swap_chain_extent,
-  };
-
   VkPipelineViewportStateCreateInfo viewport_state = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
       .viewportCount = 1,
-      .pViewports = &viewport,
+      .pViewports = nullptr,
       .scissorCount = 1,
-      .pScissors = &scissor,
+      .pScissors = nullptr,
   };
 
+  // has to match the main pass exactly, or its depth test rejects fragments
   VkPipelineRasterizationStateCreateInfo rasterizer = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
       .depthClampEnable = VK_FALSE,
@@ -1070,64 +2773,13 @@ void vktut::hello_triangle::application::create_graphics_pipeline()
   VkPipelineMultisampleStateCreateInfo multisampling = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
       .rasterizationSamples = m_msaa_samples,
-      .sampleShadingEnable = VK_TRUE,
-      .minSampleShading = 0.2F,
+      .sampleShadingEnable = VK_FALSE,
+      .minSampleShading = 1,
       .pSampleMask = nullptr,
       .alphaToCoverageEnable = VK_FALSE,
       .alphaToOneEnable = VK_FALSE,
   };
 
-  VkPipelineColorBlendAttachmentState color_blend_attachment = {
-      .blendEnable = VK_FALSE,
-      .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
-      .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
-      .colorBlendOp = VK_BLEND_OP_ADD,
-      .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
-      .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
-      .alphaBlendOp = VK_BLEND_OP_ADD,
-      .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
-          | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
-  };
-
-  VkPipelineColorBlendStateCreateInfo color_blending = {
-      .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-      .logicOpEnable = VK_FALSE,
-      .logicOp = VK_LOGIC_OP_COPY,
-      .attachmentCount = 1,
-      .pAttachments = &color_blend_attachment,
-      .blendConstants = {0, 0, 0, 0},
-  };
-
-  std::array dynamic_states = {
-      VK_DYNAMIC_STATE_VIEWPORT,
-      VK_DYNAMIC_STATE_LINE_WIDTH,
-  };
-
-  // not used, but could be to avoid recreating the entire pipeline when these
-  // params are changed
-  VkPipelineDynamicStateCreateInfo dynamic_state = {
-      .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-      .dynamicStateCount = 2,
-      .pDynamicStates = dynamic_states.data(),
-  };
-  // explicitly unused to suppress warning, read comment above
-  (void)dynamic_state;
-
-  VkPipelineLayoutCreateInfo pipeline_layout_info = {
-      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-      .setLayoutCount = 1,
-      .pSetLayouts = &m_descriptor_set_layout,
-      .pushConstantRangeCount = 0,
-      .pPushConstantRanges = nullptr,
-  };
-
-  if (vkCreatePipelineLayout(
-          m_device, &pipeline_layout_info, nullptr, &m_pipeline_layout)
-      != VK_SUCCESS)
-  {
-    throw std::runtime_error {"failed to create pipeline layout!"};
-  }
-
   VkPipelineDepthStencilStateCreateInfo depth_stencil = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
       .depthTestEnable = VK_TRUE,
@@ -1141,20 +2793,32 @@ void vktut::hello_triangle::application::create_graphics_pipeline()
       .maxDepthBounds = 1,
   };
 
+  std::array dynamic_states = {
+      VK_DYNAMIC_STATE_VIEWPORT,
+      VK_DYNAMIC_STATE_SCISSOR,
+  };
+
+  VkPipelineDynamicStateCreateInfo dynamic_state = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+      .dynamicStateCount = dynamic_states.size(),
+      .pDynamicStates = dynamic_states.data(),
+  };
+
+  // shares the main pipeline's layout, so the same push constants apply
   VkGraphicsPipelineCreateInfo pipeline_info = {
       .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-      .stageCount = 2,
-      .pStages = shader_stages.data(),
+      .stageCount = 1,
+      .pStages = &vert_shader_stage_info,
       .pVertexInputState = &vertex_input_info,
       .pInputAssemblyState = &input_assembly,
       .pViewportState = &viewport_state,
       .pRasterizationState = &rasterizer,
       .pMultisampleState = &multisampling,
       .pDepthStencilState = &depth_stencil,
-      .pColorBlendState = &color_blending,
-      .pDynamicState = nullptr,
+      .pColorBlendState = nullptr,
+      .pDynamicState = &dynamic_state,
       .layout = m_pipeline_layout,
-      .renderPass = m_render_pass,
+      .renderPass = m_depth_prepass_render_pass,
       .subpass = 0,
       .basePipelineHandle = VK_NULL_HANDLE,
       .basePipelineIndex = -1,
@@ -1165,82 +2829,438 @@ void vktut::hello_triangle::application::create_graphics_pipeline()
                                 1,
                                 &pipeline_info,
                                 nullptr,
-                                &m_graphics_pipeline)
+                                &m_depth_prepass_pipeline)
       != VK_SUCCESS)
   {
     throw std::runtime_error {"failed to create graphics pipeline!"};
   }
 
   vkDestroyShaderModule(m_device, vert_shader_module, nullptr);
-  vkDestroyShaderModule(m_device, frag_shader_module, nullptr);
 }
 
-void vktut::hello_triangle::application::create_vertex_buffer()
-{
-  auto buffer_size =
-      sizeof(decltype(m_vertices)::value_type) * m_vertices.size();
-  auto staging_buffer_and_memory =
-      create_buffer(buffer_size,
-                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-                        | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-  VkBuffer staging_buffer = staging_buffer_and_memory.buffer;
-  VkDeviceMemory staging_memory = staging_buffer_and_memory.memory;
-  void* data = nullptr;
-  vkMapMemory(m_device, staging_memory, 0, buffer_size, 0, &data);
-  std::copy(m_vertices.begin(),
-            m_vertices.end(),
-            static_cast<shaders::vertex*>(data));
-  vkUnmapMemory(m_device, staging_memory);
-
-  auto vertex_buffer_and_memory = create_buffer(
-      buffer_size,
-      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  m_vertex_buffer = vertex_buffer_and_memory.buffer;
-  m_vertex_buffer_memory = vertex_buffer_and_memory.memory;
-
-  copy_buffer(staging_buffer,
-              m_vertex_buffer,
-              buffer_size,
-              m_transfer_command_pool,
-              m_transfer_queue);
+void vktut::hello_triangle::application::record_depth_prepass(
+    VkCommandBuffer command_buffer,
+    const geometry::lod_level& lod,
+    VkDescriptorSet frame_descriptor_set)
+{
+  VkClearValue clear_value = {
+      .depthStencil = {1, 0},
+  };
+  VkRenderPassBeginInfo render_pass_info = {
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+      .renderPass = m_depth_prepass_render_pass,
+      .framebuffer = m_depth_prepass_framebuffer,
+      .renderArea =
+          {
+              .offset = {0, 0},
+              .extent = m_render_extent,
+          },
+      .clearValueCount = 1,
+      .pClearValues = &clear_value,
+  };
+
+  vkCmdBeginRenderPass(
+      command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
+  vkCmdBindPipeline(command_buffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    m_depth_prepass_pipeline);
+  set_render_viewport(command_buffer);
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers(
+      command_buffer, 0, 1, &m_model->vertex_buffer.buffer, &offset);
+  vkCmdBindIndexBuffer(command_buffer,
+                       m_model->index_buffer.buffer,
+                       0,
+                       VK_INDEX_TYPE_UINT32);
+  // the depth pipeline shares the main layout, set 0 holds the camera and
+  // the instances
+  vkCmdBindDescriptorSets(command_buffer,
+                          VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          m_pipeline_layout,
+                          0,
+                          1,
+                          &frame_descriptor_set,
+                          0,
+                          nullptr);
+  // everything in the frustum is drawn here, the occlusion culling that
+  // follows needs the complete depth
+  for (auto object : m_visible_objects) {
+    vkCmdDrawIndexed(
+        command_buffer, lod.index_count, 1, lod.first_index, 0, object);
+  }
+  vkCmdEndRenderPass(command_buffer);
+}
+
+void vktut::hello_triangle::application::create_depth_pyramid()
+{
+  if (!m_meshlet_culling_supported) {
+    return;
+  }
+
+  // level 0 is half the depth buffer. power of two levels always have room
+  // for the rounded up halves of any smaller render extent
+  std::uint32_t width = std::bit_ceil((m_swap_chain_extent.width + 1) / 2);
+  std::uint32_t height = std::bit_ceil((m_swap_chain_extent.height + 1) / 2);
+  auto mip_levels =
+      static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+
+  m_depth_pyramid =
+      create_image(width,
+                   height,
+                   mip_levels,
+                   VK_SAMPLE_COUNT_1_BIT,
+                   VK_FORMAT_R32_SFLOAT,
+                   VK_IMAGE_TILING_OPTIMAL,
+                   VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  m_depth_pyramid_view = create_image_view(m_depth_pyramid.image,
+                                           VK_FORMAT_R32_SFLOAT,
+                                           VK_IMAGE_ASPECT_COLOR_BIT,
+                                           mip_levels);
+  m_depth_pyramid_level_views.reserve(mip_levels);
+  for (std::uint32_t level = 0; level < mip_levels; ++level) {
+    m_depth_pyramid_level_views.push_back(
+        create_image_view(m_depth_pyramid.image,
+                          VK_FORMAT_R32_SFLOAT,
+                          VK_IMAGE_ASPECT_COLOR_BIT,
+                          1,
+                          level));
+  }
+
+  m_depth_pyramid_undefined = true;
+}
+
+void vktut::hello_triangle::application::create_depth_pyramid_pipelines()
+{
+  if (!m_meshlet_culling_supported) {
+    return;
+  }
+
+  // only texelFetch() is used, the sampler just has to exist
+  VkSamplerCreateInfo sampler_info = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = VK_FILTER_NEAREST,
+      .minFilter = VK_FILTER_NEAREST,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+      .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .mipLodBias = 0,
+      .anisotropyEnable = VK_FALSE,
+      .maxAnisotropy = 1,
+      .compareEnable = VK_FALSE,
+      .compareOp = VK_COMPARE_OP_ALWAYS,
+      .minLod = 0,
+      .maxLod = VK_LOD_CLAMP_NONE,
+      .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
+      .unnormalizedCoordinates = VK_FALSE,
+  };
+  if (vkCreateSampler(
+          m_device, &sampler_info, nullptr, &m_depth_pyramid_sampler)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create texture sampler!"};
+  }
+
+  auto bindings = shaders::depth_pyramid_descriptors::layout_bindings();
+  m_depth_pyramid_set_layout = m_descriptor_layout_cache->get(
+      std::vector<VkDescriptorSetLayoutBinding> {bindings.begin(),
+                                                 bindings.end()});
+
+  auto entries = shaders::depth_pyramid_descriptors::template_entries();
+  VkDescriptorUpdateTemplateCreateInfo template_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+      .descriptorUpdateEntryCount = entries.size(),
+      .pDescriptorUpdateEntries = entries.data(),
+      .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+      .descriptorSetLayout = m_depth_pyramid_set_layout,
+  };
+  if (vkCreateDescriptorUpdateTemplate(m_device,
+                                       &template_info,
+                                       nullptr,
+                                       &m_depth_pyramid_update_template)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create descriptor update template!"};
+  }
+
+  // the rendered part of the source level
+  VkPushConstantRange push_constant_range = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = sizeof(VkExtent2D),
+  };
+  VkPipelineLayoutCreateInfo pipeline_layout_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &m_depth_pyramid_set_layout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &push_constant_range,
+  };
+  if (vkCreatePipelineLayout(m_device,
+                             &pipeline_layout_info,
+                             nullptr,
+                             &m_depth_pyramid_pipeline_layout)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create pipeline layout!"};
+  }
+
+  m_depth_pyramid_pipeline =
+      create_compute_pipeline(shaders::embedded_spirv::depth_pyramid_comp,
+                              m_depth_pyramid_pipeline_layout);
+  m_depth_pyramid_multisampled_pipeline = create_compute_pipeline(
+      shaders::embedded_spirv::depth_pyramid_comp_multisampled,
+      m_depth_pyramid_pipeline_layout);
+}
+
+void vktut::hello_triangle::application::record_depth_pyramid(
+    VkCommandBuffer command_buffer)
+{
+  // the previous frame's culling pass has to be done reading the pyramid,
+  // and every level has to be written before the next one reads it
+  VkMemoryBarrier level_written = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+  };
+  // written and read as storage and sampled image alike, so after its first
+  // build it simply stays in GENERAL
+  VkImageMemoryBarrier first_build = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = 0,
+      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+      .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = m_depth_pyramid.image,
+      .subresourceRange =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .baseMipLevel = 0,
+              .levelCount = VK_REMAINING_MIP_LEVELS,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+  };
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       m_depth_pyramid_undefined ? 1 : 0,
+                       &first_build);
+  m_depth_pyramid_undefined = false;
+
+  bool multisampled = m_msaa_samples != VK_SAMPLE_COUNT_1_BIT;
+  vkCmdBindPipeline(command_buffer,
+                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                    multisampled ? m_depth_pyramid_multisampled_pipeline
+                                 : m_depth_pyramid_pipeline);
+
+  // halved and rounded up until a single texel is left, cull_meshlets.comp
+  // walks the same chain
+  VkExtent2D source_extent = m_render_extent;
+  std::uint32_t level = 0;
+  do {
+    VkDescriptorSet descriptor_set =
+        m_frame_descriptor_allocators[m_current_frame].allocate(
+            m_depth_pyramid_set_layout);
+    shaders::depth_pyramid_descriptors descriptors = {
+        .source = level == 0
+            ? VkDescriptorImageInfo {
+                  .sampler = m_depth_pyramid_sampler,
+                  .imageView = m_depth_image_view,
+                  .imageLayout =
+                      VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+              }
+            : VkDescriptorImageInfo {
+                  .sampler = m_depth_pyramid_sampler,
+                  .imageView = m_depth_pyramid_level_views[level - 1],
+                  .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+              },
+        .destination =
+            {
+                .sampler = nullptr,
+                .imageView = m_depth_pyramid_level_views[level],
+                .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+            },
+    };
+    vkUpdateDescriptorSetWithTemplate(m_device,
+                                      descriptor_set,
+                                      m_depth_pyramid_update_template,
+                                      &descriptors);
+
+    if (level == 1 && multisampled) {
+      vkCmdBindPipeline(command_buffer,
+                        VK_PIPELINE_BIND_POINT_COMPUTE,
+                        m_depth_pyramid_pipeline);
+    }
+    vkCmdBindDescriptorSets(command_buffer,
+                            VK_PIPELINE_BIND_POINT_COMPUTE,
+                            m_depth_pyramid_pipeline_layout,
+                            0,
+                            1,
+                            &descriptor_set,
+                            0,
+                            nullptr);
+    vkCmdPushConstants(command_buffer,
+                       m_depth_pyramid_pipeline_layout,
+                       VK_SHADER_STAGE_COMPUTE_BIT,
+                       0,
+                       sizeof(source_extent),
+                       &source_extent);
+
+    VkExtent2D extent = {
+        .width = (source_extent.width + 1) / 2,
+        .height = (source_extent.height + 1) / 2,
+    };
+    // matches local_size_x and local_size_y in depth_pyramid.comp
+    constexpr std::uint32_t workgroup_size = 8;
+    vkCmdDispatch(command_buffer,
+                  (extent.width + workgroup_size - 1) / workgroup_size,
+                  (extent.height + workgroup_size - 1) / workgroup_size,
+                  1);
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0,
+                         1,
+                         &level_written,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr);
 
-  vkDestroyBuffer(m_device, staging_buffer, nullptr);
-  vkFreeMemory(m_device, staging_memory, nullptr);
+    source_extent = extent;
+    ++level;
+  } while (source_extent.width > 1 || source_extent.height > 1);
 }
 
-void vktut::hello_triangle::application::create_index_buffer()
+void vktut::hello_triangle::application::record_async_culling(
+    VkCommandBuffer prepass_command_buffer,
+    VkCommandBuffer command_buffer,
+    std::uint32_t image_index)
 {
-  VkDeviceSize buffer_size =
-      sizeof(decltype(m_indices)::value_type) * m_indices.size();
-
-  auto staging = create_buffer(buffer_size,
-                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-                                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  // the pre-pass depth is lent to the compute family for the pyramid and
+  // handed back for the main pass. the pyramid itself stays with the compute
+  // family, it is rewritten whole every frame
+  VkImageAspectFlags depth_aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+  if (has_stencil_component(find_depth_format())) {
+    depth_aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+  }
+  constexpr auto depth_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+  if (m_depth_pyramid_supported) {
+    auto release = m_async_compute->release(
+        m_depth_image.image,
+        depth_aspect,
+        depth_layout,
+        depth_layout,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        true);
+    vkCmdPipelineBarrier(prepass_command_buffer,
+                         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &release);
+  }
+  if (vkEndCommandBuffer(prepass_command_buffer) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to record command buffer!"};
+  }
 
-  void* data = nullptr;
-  vkMapMemory(m_device, staging.memory, 0, buffer_size, 0, &data);
-  std::copy(m_indices.begin(),
-            m_indices.end(),
-            static_cast<decltype(m_indices)::value_type*>(data));
-  vkUnmapMemory(m_device, staging.memory);
+  VkCommandBuffer compute_command_buffer =
+      m_async_compute->begin(m_current_frame, culling_pass);
+  if (m_depth_pyramid_supported) {
+    auto acquire = m_async_compute->acquire(m_depth_image.image,
+                                            depth_aspect,
+                                            depth_layout,
+                                            depth_layout,
+                                            VK_ACCESS_SHADER_READ_BIT,
+                                            true);
+    vkCmdPipelineBarrier(compute_command_buffer,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &acquire);
+    record_depth_pyramid(compute_command_buffer);
+  }
+  record_meshlet_culling(
+      compute_command_buffer, image_index, m_depth_pyramid_supported);
+  if (!m_depth_pyramid_supported) {
+    begin_frame_commands(command_buffer);
+    return;
+  }
 
-  auto index = create_buffer(
-      buffer_size,
-      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  m_index_buffer = index.buffer;
-  m_index_buffer_memory = index.memory;
-  copy_buffer(staging.buffer,
-              index.buffer,
-              buffer_size,
-              m_transfer_command_pool,
-              m_transfer_queue);
+  // only read, so there is nothing to make available on the way back
+  auto release = m_async_compute->release(m_depth_image.image,
+                                          depth_aspect,
+                                          depth_layout,
+                                          depth_layout,
+                                          0,
+                                          false);
+  vkCmdPipelineBarrier(compute_command_buffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &release);
+
+  begin_frame_commands(command_buffer);
+  auto acquire = m_async_compute->acquire(
+      m_depth_image.image,
+      depth_aspect,
+      depth_layout,
+      depth_layout,
+      VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+      false);
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+                           | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &acquire);
+}
 
-  vkDestroyBuffer(m_device, staging.buffer, nullptr);
-  vkFreeMemory(m_device, staging.memory, nullptr);
+void vktut::hello_triangle::application::set_render_viewport(
+    VkCommandBuffer command_buffer)
+{
+  VkViewport viewport = {
+      .x = 0,
+      .y = 0,
+      .width = static_cast<float>(m_render_extent.width),
+      .height = static_cast<float>(m_render_extent.height),
+      .minDepth = 0,
+      .maxDepth = 1,
+  };
+  VkRect2D scissor = {
+      .offset = {0, 0},
+      .extent = m_render_extent,
+  };
+  vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+  vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 }
 
 void vktut::hello_triangle::application::create_uniform_buffers()
@@ -1249,6 +3269,7 @@ void vktut::hello_triangle::application::create_uniform_buffers()
 
   m_uniform_buffers.resize(m_swap_chain_images.size());
   m_uniform_buffers_memory.resize(m_swap_chain_images.size());
+  m_uniform_data.resize(m_swap_chain_images.size());
 
   for (size_t i = 0; i < m_swap_chain_images.size(); ++i) {
     auto uniform = create_buffer(buffer_size,
@@ -1257,120 +3278,123 @@ void vktut::hello_triangle::application::create_uniform_buffers()
                                      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
     m_uniform_buffers[i] = uniform.buffer;
     m_uniform_buffers_memory[i] = uniform.memory;
+    void* data = nullptr;
+    vkMapMemory(m_device, uniform.memory, 0, buffer_size, 0, &data);
+    m_uniform_data[i] = static_cast<shaders::uniform_buffer_object*>(data);
   }
 }
 
-void vktut::hello_triangle::application::create_descriptor_pool()
+void vktut::hello_triangle::application::create_instance_buffers()
 {
-  std::array pool_sizes = {
-      VkDescriptorPoolSize {
-          .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-          .descriptorCount =
-              static_cast<std::uint32_t>(m_swap_chain_images.size()),
-      },
-      VkDescriptorPoolSize {
-          .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-          .descriptorCount =
-              static_cast<std::uint32_t>(m_swap_chain_images.size()),
-      },
-  };
-
-  VkDescriptorPoolCreateInfo pool_info = {
-      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-      .flags = 0,
-      .maxSets = static_cast<std::uint32_t>(m_swap_chain_images.size()),
-      .poolSizeCount = pool_sizes.size(),
-      .pPoolSizes = pool_sizes.data(),
-  };
+  VkDeviceSize buffer_size = std::max<std::size_t>(m_scene.size(), 1)
+      * scene::scene_graph::instance_stride;
 
-  if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_descriptor_pool)
-      != VK_SUCCESS)
-  {
-    throw std::runtime_error {"failed to create descriptor pool!"};
+  m_instance_buffers.reserve(max_frames_in_flight);
+  m_instance_data.reserve(max_frames_in_flight);
+  for (size_t i = 0; i < max_frames_in_flight; ++i) {
+    auto instances = create_buffer(buffer_size,
+                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                       | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    void* data = nullptr;
+    vkMapMemory(m_device, instances.memory, 0, buffer_size, 0, &data);
+    m_instance_buffers.push_back(instances);
+    m_instance_data.emplace_back(static_cast<std::byte*>(data), buffer_size);
   }
+  // every copy still needs the whole scene
+  m_instance_generations.assign(max_frames_in_flight, 0);
 }
 
-void vktut::hello_triangle::application::create_descriptor_sets()
+void vktut::hello_triangle::application::create_descriptor_update_template()
 {
-  std::vector<VkDescriptorSetLayout> layouts;
-  layouts.resize(m_swap_chain_images.size(), m_descriptor_set_layout);
-
-  VkDescriptorSetAllocateInfo allocate_info = {
-      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-      .descriptorPool = m_descriptor_pool,
-      .descriptorSetCount =
-          static_cast<std::uint32_t>(m_swap_chain_images.size()),
-      .pSetLayouts = layouts.data(),
+  auto entries = shaders::frame_descriptors::template_entries();
+
+  VkDescriptorUpdateTemplateCreateInfo template_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+      .descriptorUpdateEntryCount = entries.size(),
+      .pDescriptorUpdateEntries = entries.data(),
+      .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+      .descriptorSetLayout = m_descriptor_set_layout,
   };
 
-  m_descriptor_sets.resize(m_swap_chain_images.size());
-  if (vkAllocateDescriptorSets(
-          m_device, &allocate_info, m_descriptor_sets.data())
+  if (vkCreateDescriptorUpdateTemplate(
+          m_device, &template_info, nullptr, &m_descriptor_update_template)
       != VK_SUCCESS)
   {
-    throw std::runtime_error {"failed to allocate descriptor sets!"};
+    throw std::runtime_error {"failed to create descriptor update template!"};
   }
+}
 
-  for (std::size_t i = 0; i < m_swap_chain_images.size(); ++i) {
-    VkDescriptorBufferInfo buffer_info = {
-        .buffer = m_uniform_buffers[i],
-        .offset = 0,
-        .range = sizeof(shaders::uniform_buffer_object),
-    };
+void vktut::hello_triangle::application::create_descriptor_allocators()
+{
+  m_frame_descriptor_allocators.reserve(max_frames_in_flight);
+  for (size_t i = 0; i < max_frames_in_flight; ++i) {
+    m_frame_descriptor_allocators.emplace_back(m_device);
+  }
+}
 
-    VkDescriptorImageInfo image_info = {
-        .sampler = m_texture_sampler,
-        .imageView = m_texture_image_view,
-        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-    };
+VkDescriptorSet
+vktut::hello_triangle::application::allocate_frame_descriptor_set(
+    std::uint32_t image_index)
+{
+  VkDescriptorSet descriptor_set =
+      m_frame_descriptor_allocators[m_current_frame].allocate(
+          m_descriptor_set_layout);
 
-    std::array descriptor_writes = {
-        VkWriteDescriptorSet {
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .dstSet = m_descriptor_sets[i],
-            .dstBinding = 0,
-            .dstArrayElement = 0,
-            .descriptorCount = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .pImageInfo = nullptr,
-            .pBufferInfo = &buffer_info,
-            .pTexelBufferView = nullptr,
-        },
-        VkWriteDescriptorSet {
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .dstSet = m_descriptor_sets[i],
-            .dstBinding = 1,
-            .dstArrayElement = 0,
-            .descriptorCount = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .pImageInfo = &image_info,
-            .pBufferInfo = nullptr,
-            .pTexelBufferView = nullptr,
-        },
-    };
+  shaders::frame_descriptors descriptors = {
+      .uniform_buffer =
+          {
+              .buffer = m_uniform_buffers[image_index],
+              .offset = 0,
+              .range = sizeof(shaders::uniform_buffer_object),
+          },
+      .texture_sampler =
+          {
+              .sampler = m_texture_sampler,
+              .imageView = m_textures[m_material.texture_index]->view,
+              .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+          },
+      .instances =
+          {
+              .buffer = m_instance_buffers[m_current_frame].buffer,
+              .offset = 0,
+              .range = VK_WHOLE_SIZE,
+          },
+  };
+  vkUpdateDescriptorSetWithTemplate(
+      m_device, descriptor_set, m_descriptor_update_template, &descriptors);
+  return descriptor_set;
+}
 
-    vkUpdateDescriptorSets(m_device,
-                           descriptor_writes.size(),
-                           descriptor_writes.data(),
-                           0,
-                           nullptr);
+void vktut::hello_triangle::application::create_texture_images()
+{
+  m_textures.reserve(texture_paths.size());
+  for (const auto* texture_path : texture_paths) {
+    m_textures.push_back(m_assets->load_texture(std::string {texture_path}));
   }
 }
 
-void vktut::hello_triangle::application::create_texture_image()
+vktut::vulkan::texture vktut::hello_triangle::application::load_texture(
+    std::span<const std::byte> file_bytes)
 {
   int tex_width = 0;
   int tex_height = 0;
   int tex_channels = 0;
-  stbi_uc* pixels = stbi_load(
-      texture_paths[0], &tex_width, &tex_height, &tex_channels, STBI_rgb_alpha);
+  stbi_uc* pixels = stbi_load_from_memory(
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      reinterpret_cast<const stbi_uc*>(file_bytes.data()),
+      static_cast<int>(file_bytes.size()),
+      &tex_width,
+      &tex_height,
+      &tex_channels,
+      STBI_rgb_alpha);
   if (pixels == nullptr) {
     throw std::runtime_error {"failed to load texture image!"};
   }
   auto image_size = static_cast<VkDeviceSize>(tex_width)
       * static_cast<VkDeviceSize>(tex_height) * 4;
-  m_mip_levels = static_cast<std::uint32_t>(
-                     std::floor(std::log2(std::max(tex_width, tex_height))))
+  auto mip_levels = static_cast<std::uint32_t>(
+                        std::floor(std::log2(std::max(tex_width, tex_height))))
       + 1;
 
   auto staging = create_buffer(image_size,
@@ -1388,7 +3412,7 @@ void vktut::hello_triangle::application::create_texture_image()
 
   auto image = create_image(tex_width,
                             tex_height,
-                            m_mip_levels,
+                            mip_levels,
                             VK_SAMPLE_COUNT_1_BIT,
                             VK_FORMAT_R8G8B8A8_SRGB,
                             VK_IMAGE_TILING_OPTIMAL,
@@ -1396,36 +3420,36 @@ void vktut::hello_triangle::application::create_texture_image()
                                 | VK_IMAGE_USAGE_TRANSFER_DST_BIT
                                 | VK_IMAGE_USAGE_SAMPLED_BIT,
                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  m_texture_image = image.image;
-  m_texture_image_memory = image.memory;
 
-  transition_image_layout(m_texture_image,
+  transition_image_layout(image.image,
                           VK_FORMAT_R8G8B8A8_SRGB,
                           VK_IMAGE_LAYOUT_UNDEFINED,
                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                          m_mip_levels,
+                          mip_levels,
                           m_transfer_command_pool,
                           m_transfer_queue);
   copy_buffer_to_image(staging.buffer,
-                       m_texture_image,
+                       image.image,
                        static_cast<std::uint32_t>(tex_width),
                        static_cast<std::uint32_t>(tex_height));
-  generate_mipmaps(m_texture_image,
+  generate_mipmaps(image.image,
                    VK_FORMAT_R8G8B8A8_SRGB,
                    tex_width,
                    tex_height,
-                   m_mip_levels);
+                   mip_levels);
 
   vkDestroyBuffer(m_device, staging.buffer, nullptr);
   vkFreeMemory(m_device, staging.memory, nullptr);
-}
 
-void vktut::hello_triangle::application::create_texture_image_view()
-{
-  m_texture_image_view = create_image_view(m_texture_image,
-                                           VK_FORMAT_R8G8B8A8_SRGB,
-                                           VK_IMAGE_ASPECT_COLOR_BIT,
-                                           m_mip_levels);
+  return vulkan::texture {
+      .image = image.image,
+      .memory = image.memory,
+      .view = create_image_view(image.image,
+                                VK_FORMAT_R8G8B8A8_SRGB,
+                                VK_IMAGE_ASPECT_COLOR_BIT,
+                                mip_levels),
+      .mip_levels = mip_levels,
+  };
 }
 
 void vktut::hello_triangle::application::create_texture_sampler()
@@ -1446,7 +3470,7 @@ void vktut::hello_triangle::application::create_texture_sampler()
       .compareEnable = VK_FALSE,
       .compareOp = VK_COMPARE_OP_ALWAYS,
       .minLod = 0.0F,
-      .maxLod = static_cast<float>(m_mip_levels),
+      .maxLod = VK_LOD_CLAMP_NONE,
       .borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
       .unnormalizedCoordinates = VK_FALSE,
   };
@@ -1458,55 +3482,220 @@ void vktut::hello_triangle::application::create_texture_sampler()
   }
 }
 
+void vktut::hello_triangle::application::create_bindless_descriptors()
+{
+  if (!m_material.bindless_textures) {
+    return;
+  }
+
+  VkDescriptorSetLayoutBinding textures_binding = {
+      .binding = 0,
+      .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      .descriptorCount = m_bindless_capacity,
+      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .pImmutableSamplers = nullptr,
+  };
+
+  // slots past the loaded textures stay empty, and textures streamed in later
+  // can be written while command buffers using the set are pending
+  VkDescriptorBindingFlags binding_flags =
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+      | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+      | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+  VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info = {
+      .sType =
+          VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+      .bindingCount = 1,
+      .pBindingFlags = &binding_flags,
+  };
+
+  VkDescriptorSetLayoutCreateInfo layout_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .pNext = &binding_flags_info,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+      .bindingCount = 1,
+      .pBindings = &textures_binding,
+  };
+
+  if (vkCreateDescriptorSetLayout(
+          m_device, &layout_info, nullptr, &m_bindless_set_layout)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create bindless set layout!"};
+  }
+
+  VkDescriptorPoolSize pool_size = {
+      .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      .descriptorCount = m_bindless_capacity,
+  };
+
+  VkDescriptorPoolCreateInfo pool_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+      .maxSets = 1,
+      .poolSizeCount = 1,
+      .pPoolSizes = &pool_size,
+  };
+
+  if (vkCreateDescriptorPool(
+          m_device, &pool_info, nullptr, &m_bindless_descriptor_pool)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create bindless descriptor pool!"};
+  }
+
+  VkDescriptorSetVariableDescriptorCountAllocateInfo variable_count_info = {
+      .sType =
+          VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
+      .descriptorSetCount = 1,
+      .pDescriptorCounts = &m_bindless_capacity,
+  };
+
+  VkDescriptorSetAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .pNext = &variable_count_info,
+      .descriptorPool = m_bindless_descriptor_pool,
+      .descriptorSetCount = 1,
+      .pSetLayouts = &m_bindless_set_layout,
+  };
+
+  if (vkAllocateDescriptorSets(
+          m_device, &allocate_info, &m_bindless_descriptor_set)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to allocate bindless descriptor set!"};
+  }
+
+  std::vector<VkDescriptorImageInfo> image_infos;
+  image_infos.reserve(m_textures.size());
+  std::transform(m_textures.begin(),
+                 m_textures.end(),
+                 std::back_inserter(image_infos),
+                 [this](const auto& texture)
+                 {
+                   return VkDescriptorImageInfo {
+                       .sampler = m_texture_sampler,
+                       .imageView = texture->view,
+                       .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   };
+                 });
+
+  VkWriteDescriptorSet descriptor_write = {
+      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+      .dstSet = m_bindless_descriptor_set,
+      .dstBinding = 0,
+      .dstArrayElement = 0,
+      .descriptorCount = static_cast<std::uint32_t>(image_infos.size()),
+      .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      .pImageInfo = image_infos.data(),
+      .pBufferInfo = nullptr,
+      .pTexelBufferView = nullptr,
+  };
+
+  vkUpdateDescriptorSets(m_device, 1, &descriptor_write, 0, nullptr);
+}
+
 void vktut::hello_triangle::application::create_depth_resources()
 {
   VkFormat depth_format = find_depth_format();
-  auto depth = create_image(m_swap_chain_extent.width,
-                            m_swap_chain_extent.height,
-                            1,
-                            m_msaa_samples,
-                            depth_format,
-                            VK_IMAGE_TILING_OPTIMAL,
-                            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  m_depth_image = depth.image;
-  m_depth_image_memory = depth.memory;
+  // without a pre-pass depth is only read within the render pass, so it never
+  // needs to be backed by real memory on gpus that keep attachments on-chip.
+  // with one it is stored and carried over, and read by the depth pyramid
+  VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+  VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  if (!m_depth_prepass) {
+    usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    properties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+  } else if (m_depth_pyramid_supported) {
+    usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+  }
+  m_depth_image = create_image(m_swap_chain_extent.width,
+                               m_swap_chain_extent.height,
+                               1,
+                               m_msaa_samples,
+                               depth_format,
+                               VK_IMAGE_TILING_OPTIMAL,
+                               usage,
+                               properties);
   m_depth_image_view = create_image_view(
-      m_depth_image, depth_format, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
-
-  transition_image_layout(m_depth_image,
-                          depth_format,
-                          VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                          1,
-                          m_command_pool,
-                          m_graphics_queue);
+      m_depth_image.image, depth_format, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
+  // no layout transition here, the first render pass starts from UNDEFINED
 }
 
 void vktut::hello_triangle::application::create_color_resources()
 {
+  m_attachment_report_pending = true;
+  if (m_msaa_samples == VK_SAMPLE_COUNT_1_BIT) {
+    m_color_image = {};
+    m_color_image_view = nullptr;
+    return;
+  }
+
   VkFormat color_format = m_swap_chain_image_format;
 
-  auto color = create_image(m_swap_chain_extent.width,
-                            m_swap_chain_extent.height,
-                            1,
-                            m_msaa_samples,
-                            color_format,
-                            VK_IMAGE_TILING_OPTIMAL,
-                            VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
-                                | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  m_color_image = color.image;
-  m_color_image_memory = color.memory;
+  // the multisampled color is resolved into the swap chain image and then
+  // discarded, so it is transient just like depth
+  m_color_image = create_image(m_swap_chain_extent.width,
+                               m_swap_chain_extent.height,
+                               1,
+                               m_msaa_samples,
+                               color_format,
+                               VK_IMAGE_TILING_OPTIMAL,
+                               VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+                                   | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                                   | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
   m_color_image_view = create_image_view(
-      m_color_image, color_format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+      m_color_image.image, color_format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+}
+
+void vktut::hello_triangle::application::report_attachment_memory()
+{
+  constexpr double mebibyte = 1024.0 * 1024.0;
+
+  auto committed = [this](const vulkan::image_and_memory& attachment)
+  {
+    // only lazily allocated memory can commit less than it was asked for
+    if (!attachment.lazily_allocated) {
+      return attachment.size;
+    }
+    VkDeviceSize committed_bytes = 0;
+    vkGetDeviceMemoryCommitment(m_device, attachment.memory, &committed_bytes);
+    return committed_bytes;
+  };
+
+  std::cout << "[vktut::hello_triangle::application::"
+               "report_attachment_memory()] "
+            << m_swap_chain_extent.width << "x" << m_swap_chain_extent.height
+            << " at " << m_msaa_samples << "x msaa:\n";
+  std::array attachments = {
+      std::pair {"color", &m_color_image},
+      std::pair {"depth", &m_depth_image},
+  };
+  VkDeviceSize total_requested = 0;
+  VkDeviceSize total_committed = 0;
+  for (const auto& [name, attachment] : attachments) {
+    VkDeviceSize committed_bytes = committed(*attachment);
+    total_requested += attachment->size;
+    total_committed += committed_bytes;
+    std::cout << "\t" << name << ": "
+              << static_cast<double>(attachment->size) / mebibyte
+              << " MiB requested, "
+              << static_cast<double>(committed_bytes) / mebibyte
+              << " MiB committed"
+              << (attachment->lazily_allocated ? " (lazily allocated)" : "")
+              << "\n";
+  }
+  auto saved = static_cast<double>(total_requested - total_committed);
+  std::cout << "\tsaved " << saved / mebibyte << " MiB\n";
 }
 
 VkImageView vktut::hello_triangle::application::create_image_view(
     VkImage image,
     VkFormat format,
     VkImageAspectFlags aspect_flags,
-    std::uint32_t mip_levels)
+    std::uint32_t mip_levels,
+    std::uint32_t base_mip_level)
 {
   VkImageViewCreateInfo view_info = {
       .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -1523,7 +3712,7 @@ VkImageView vktut::hello_triangle::application::create_image_view(
       .subresourceRange =
           {
               .aspectMask = aspect_flags,
-              .baseMipLevel = 0,
+              .baseMipLevel = base_mip_level,
               .levelCount = mip_levels,
               .baseArrayLayer = 0,
               .layerCount = 1,
@@ -1578,6 +3767,14 @@ vktut::hello_triangle::application::create_image(
   VkMemoryRequirements memory_requirements;
   vkGetImageMemoryRequirements(m_device, image, &memory_requirements);
 
+  // lazily allocated memory mostly exists on tiled gpus, everything else gets
+  // ordinary device-local memory
+  if ((properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0U
+      && !has_memory_type(memory_requirements.memoryTypeBits, properties))
+  {
+    properties &= ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+  }
+
   VkMemoryAllocateInfo allocate_info = {
       .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
       .allocationSize = memory_requirements.size,
@@ -1592,7 +3789,41 @@ vktut::hello_triangle::application::create_image(
   }
 
   vkBindImageMemory(m_device, image, memory, 0);
-  return vulkan::image_and_memory {image, memory};
+  return vulkan::image_and_memory {
+      .image = image,
+      .memory = memory,
+      .size = memory_requirements.size,
+      .lazily_allocated =
+          (properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0U,
+  };
+}
+
+vktut::vulkan::buffer_and_memory
+vktut::hello_triangle::application::upload_buffer(
+    std::span<const std::byte> data, VkBufferUsageFlags usage)
+{
+  auto staging = create_buffer(data.size(),
+                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  void* mapped = nullptr;
+  vkMapMemory(m_device, staging.memory, 0, data.size(), 0, &mapped);
+  std::copy(data.begin(), data.end(), static_cast<std::byte*>(mapped));
+  vkUnmapMemory(m_device, staging.memory);
+
+  auto buffer = create_buffer(data.size(),
+                              VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  copy_buffer(staging.buffer,
+              buffer.buffer,
+              data.size(),
+              m_transfer_command_pool,
+              m_transfer_queue);
+
+  vkDestroyBuffer(m_device, staging.buffer, nullptr);
+  vkFreeMemory(m_device, staging.memory, nullptr);
+  return buffer;
 }
 
 vktut::vulkan::buffer_and_memory
@@ -1603,16 +3834,22 @@ vktut::hello_triangle::application::create_buffer(
 {
   auto indices =
       vulkan::queue_family_indices::find(m_physical_device, m_surface);
+  // the compute family reads and writes the culling buffers and the uniform
+  // buffers, unless it is one of the other two
   std::array queue_family_indices = {
       *indices.graphics_family,
       *indices.transfer_family,
+      indices.compute_family.value_or(*indices.graphics_family),
   };
+  bool separate_compute = indices.compute_family
+      && indices.compute_family != indices.graphics_family
+      && indices.compute_family != indices.transfer_family;
   VkBufferCreateInfo buffer_info = {
       .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
       .size = size,
       .usage = usage,
       .sharingMode = VK_SHARING_MODE_CONCURRENT,
-      .queueFamilyIndexCount = 2,
+      .queueFamilyIndexCount = separate_compute ? 3U : 2U,
       .pQueueFamilyIndices = queue_family_indices.data(),
   };
 
@@ -1646,13 +3883,12 @@ vktut::hello_triangle::application::create_buffer(
 }
 
 VkShaderModule vktut::hello_triangle::application::create_shader_module(
-    const std::vector<char>& code)
+    std::span<const std::uint32_t> code)
 {
   VkShaderModuleCreateInfo create_info = {
       .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-      .codeSize = code.size(),
-      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-      .pCode = reinterpret_cast<const std::uint32_t*>(code.data()),
+      .codeSize = code.size_bytes(),
+      .pCode = code.data(),
   };
 
   VkShaderModule shader_module = {};
@@ -1664,6 +3900,32 @@ VkShaderModule vktut::hello_triangle::application::create_shader_module(
   return shader_module;
 }
 
+VkPipeline vktut::hello_triangle::application::create_compute_pipeline(
+    std::span<const std::uint32_t> code, VkPipelineLayout layout)
+{
+  VkShaderModule shader_module = create_shader_module(code);
+  VkComputePipelineCreateInfo pipeline_info = {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .stage =
+          {
+              .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+              .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+              .module = shader_module,
+              .pName = "main",
+          },
+      .layout = layout,
+  };
+
+  VkPipeline pipeline = nullptr;
+  VkResult result = vkCreateComputePipelines(
+      m_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline);
+  vkDestroyShaderModule(m_device, shader_module, nullptr);
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error {"failed to create compute pipeline!"};
+  }
+  return pipeline;
+}
+
 VkCommandBuffer vktut::hello_triangle::application::begin_single_time_commands(
     VkCommandPool command_pool)
 {
@@ -2036,12 +4298,10 @@ VkExtent2D vktut::hello_triangle::application::choose_swap_extent(
     return capabilities.currentExtent;
   }
 
-  int width = 0;
-  int height = 0;
-  glfwGetFramebufferSize(m_window, &width, &height);
-
-  VkExtent2D actual_extent = {static_cast<std::uint32_t>(width),
-                              static_cast<std::uint32_t>(height)};
+  VkExtent2D actual_extent = {
+      static_cast<std::uint32_t>(m_framebuffer_width),
+      static_cast<std::uint32_t>(m_framebuffer_height),
+  };
   actual_extent.width = std::clamp(actual_extent.width,
                                    capabilities.minImageExtent.width,
                                    capabilities.maxImageExtent.width);
@@ -2078,6 +4338,24 @@ std::uint32_t vktut::hello_triangle::application::find_memory_type(
   throw std::runtime_error {"failed to find suitable memory type!"};
 }
 
+bool vktut::hello_triangle::application::has_memory_type(
+    std::uint32_t type_filter, VkMemoryPropertyFlags properties)
+{
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
+
+  for (std::uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+    if ((type_filter & (1 << i)) != 0U
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        && (memory_properties.memoryTypes[i].propertyFlags & properties)
+            == properties)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 VkFormat vktut::hello_triangle::application::find_supported_format(
     const std::vector<VkFormat>& candidates,
     VkImageTiling tiling,
@@ -2199,3 +4477,76 @@ bool vktut::hello_triangle::application::check_device_extensions_support(
 
   return required_extensions.empty();
 }
+
+bool vktut::hello_triangle::application::check_bindless_support()
+{
+  // the feature and property queries below are core 1.1 entry points
+  VkPhysicalDeviceProperties device_properties;
+  vkGetPhysicalDeviceProperties(m_physical_device, &device_properties);
+  if (device_properties.apiVersion < VK_API_VERSION_1_1) {
+    return false;
+  }
+
+  std::uint32_t extension_count = 0;
+  vkEnumerateDeviceExtensionProperties(
+      m_physical_device, nullptr, &extension_count, nullptr);
+
+  std::vector<VkExtensionProperties> available_extensions;
+  available_extensions.resize(extension_count);
+  vkEnumerateDeviceExtensionProperties(m_physical_device,
+                                       nullptr,
+                                       &extension_count,
+                                       available_extensions.data());
+
+  if (std::none_of(available_extensions.begin(),
+                   available_extensions.end(),
+                   [](const auto& extension)
+                   {
+                     return std::string {static_cast<const char*>(
+                                extension.extensionName)}
+                     == VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME;
+                   }))
+  {
+    return false;
+  }
+
+  VkPhysicalDeviceDescriptorIndexingFeatures indexing_features = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+  };
+  VkPhysicalDeviceFeatures2 features = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+      .pNext = &indexing_features,
+  };
+  vkGetPhysicalDeviceFeatures2(m_physical_device, &features);
+
+  if (indexing_features.shaderSampledImageArrayNonUniformIndexing == VK_FALSE
+      || indexing_features.descriptorBindingSampledImageUpdateAfterBind
+          == VK_FALSE
+      || indexing_features.descriptorBindingPartiallyBound == VK_FALSE
+      || indexing_features.descriptorBindingVariableDescriptorCount == VK_FALSE
+      || indexing_features.runtimeDescriptorArray == VK_FALSE)
+  {
+    return false;
+  }
+
+  VkPhysicalDeviceDescriptorIndexingProperties indexing_properties = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+  };
+  VkPhysicalDeviceProperties2 properties = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+      .pNext = &indexing_properties,
+  };
+  vkGetPhysicalDeviceProperties2(m_physical_device, &properties);
+
+  // combined image samplers count against both the sampler and the sampled
+  // image limits
+  m_bindless_capacity = std::min({
+      max_bindless_textures,
+      indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+      indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+      indexing_properties.maxDescriptorSetUpdateAfterBindSamplers,
+      indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+  });
+
+  return m_bindless_capacity >= texture_paths.size();
+}
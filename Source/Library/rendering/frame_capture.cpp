@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+#include "vktut/rendering/frame_capture.hpp"
+
+#include <stb_image_write.h>
+
+vktut::rendering::frame_capture::frame_capture(VkDevice device,
+                                               VkPhysicalDevice physical_device,
+                                               capture_format format,
+                                               std::string directory,
+                                               std::size_t slot_count,
+                                               std::size_t encoder_count)
+    : m_format(format)
+    , m_directory(std::move(directory))
+    , m_ring(device,
+             physical_device,
+             VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+             slot_count)
+    , m_captures(slot_count)
+    , m_encoders(std::make_unique<utilities::thread_pool>(encoder_count))
+{
+}
+
+vktut::rendering::frame_capture::~frame_capture()
+{
+  // joins the encoders before the ring goes away under them
+  m_encoders.reset();
+}
+
+bool vktut::rendering::frame_capture::supports(VkFormat format)
+{
+  switch (format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool vktut::rendering::frame_capture::record(VkCommandBuffer command_buffer,
+                                             std::size_t frame_index,
+                                             VkImage image,
+                                             VkFormat format,
+                                             VkExtent2D extent)
+{
+  auto slot_index = m_ring.acquire(
+      frame_index, static_cast<VkDeviceSize>(extent.width) * extent.height * 4);
+  if (!slot_index) {
+    ++m_dropped_frames;
+    ++m_frame_number;
+    return false;
+  }
+  m_captures[*slot_index] = capture {
+      .format = format,
+      .extent = extent,
+      .frame_number = m_frame_number++,
+  };
+
+  VkBufferImageCopy region = {
+      .bufferOffset = 0,
+      .bufferRowLength = 0,
+      .bufferImageHeight = 0,
+      .imageSubresource =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .mipLevel = 0,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+      .imageOffset = {0, 0, 0},
+      .imageExtent = {extent.width, extent.height, 1},
+  };
+  vkCmdCopyImageToBuffer(command_buffer,
+                         image,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         m_ring.buffer(*slot_index),
+                         1,
+                         &region);
+
+  VkBufferMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = m_ring.buffer(*slot_index),
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       1,
+                       &barrier,
+                       0,
+                       nullptr);
+  return true;
+}
+
+void vktut::rendering::frame_capture::frame_completed(std::size_t frame_index)
+{
+  for (auto slot_index : m_ring.complete(frame_index)) {
+    encode(slot_index);
+  }
+}
+
+void vktut::rendering::frame_capture::flush()
+{
+  for (auto slot_index : m_ring.complete_all()) {
+    encode(slot_index);
+  }
+}
+
+std::uint64_t vktut::rendering::frame_capture::dropped_frames() const
+{
+  return m_dropped_frames;
+}
+
+void vktut::rendering::frame_capture::encode(std::size_t slot_index)
+{
+  m_encoders->submit(
+      [this, slot_index]
+      {
+        // copied out, the slot may be reused as soon as it is released
+        const auto capture = m_captures[slot_index];
+        const auto* mapped = m_ring.data(slot_index);
+        bool bgra = capture.format == VK_FORMAT_B8G8R8A8_UNORM
+            || capture.format == VK_FORMAT_B8G8R8A8_SRGB;
+        // only raw keeps alpha, there is nothing meaningful in it
+        std::size_t channels = m_format == capture_format::raw ? 4 : 3;
+        std::size_t pixel_count =
+            static_cast<std::size_t>(capture.extent.width)
+            * capture.extent.height;
+
+        std::vector<unsigned char> pixels(pixel_count * channels);
+        for (std::size_t i = 0; i < pixel_count; ++i) {
+          const auto* source = &mapped[i * 4];
+          auto* destination = &pixels[i * channels];
+          destination[0] = std::to_integer<unsigned char>(source[bgra ? 2 : 0]);
+          destination[1] = std::to_integer<unsigned char>(source[1]);
+          destination[2] = std::to_integer<unsigned char>(source[bgra ? 0 : 2]);
+          if (channels == 4) {
+            destination[3] = std::to_integer<unsigned char>(source[3]);
+          }
+        }
+        // the slot can take the next frame while this one hits the disk
+        m_ring.release(slot_index);
+
+        std::array<char, 32> file_name {};
+        constexpr std::array<std::string_view, 3> extensions = {
+            "rgba",
+            "ppm",
+            "png",
+        };
+        std::snprintf(file_name.data(),
+                      file_name.size(),
+                      "/frame_%06llu.",
+                      static_cast<unsigned long long>(capture.frame_number));
+        auto path = m_directory + file_name.data()
+            + std::string {extensions.at(static_cast<std::size_t>(m_format))};
+
+        auto width = static_cast<int>(capture.extent.width);
+        auto height = static_cast<int>(capture.extent.height);
+        if (m_format == capture_format::png) {
+          if (stbi_write_png(path.c_str(),
+                             width,
+                             height,
+                             static_cast<int>(channels),
+                             pixels.data(),
+                             width * static_cast<int>(channels))
+              == 0)
+          {
+            std::cerr << "failed to write " << path << "\n";
+          }
+          return;
+        }
+
+        std::ofstream file {path, std::ios::binary};
+        if (m_format == capture_format::ppm) {
+          file << "P6\n" << width << " " << height << "\n255\n";
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        file.write(reinterpret_cast<const char*>(pixels.data()),
+                   static_cast<std::streamsize>(pixels.size()));
+        if (!file) {
+          std::cerr << "failed to write " << path << "\n";
+        }
+      });
+}
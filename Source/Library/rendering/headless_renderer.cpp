@@ -0,0 +1,685 @@
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+#include "vktut/rendering/headless_renderer.hpp"
+
+#include <vktut/shaders/material.hpp>
+#include <vktut/shaders/push_constants.hpp>
+#include <vktut/shaders/uniform_buffer_object.hpp>
+
+vktut::rendering::headless_renderer::headless_renderer(
+    std::shared_ptr<vulkan::device_context> context,
+    VkExtent2D extent,
+    assets::asset_manager::texture_handle texture)
+    : m_context(std::move(context))
+    , m_device(m_context->device())
+    , m_extent(extent)
+    , m_command_pool(nullptr)
+    , m_command_buffer(nullptr)
+    , m_fence(nullptr)
+    , m_color_image()
+    , m_color_view(nullptr)
+    , m_depth_image()
+    , m_depth_view(nullptr)
+    , m_readback_buffer()
+    , m_instance_buffer()
+    , m_uniform_buffer()
+    , m_render_pass(nullptr)
+    , m_framebuffer(nullptr)
+    , m_descriptor_set_layout(nullptr)
+    , m_pipeline_layout(nullptr)
+    , m_pipeline(nullptr)
+    , m_descriptor_allocator(m_device)
+    , m_descriptor_set(nullptr)
+    , m_texture(std::move(texture))
+    , m_mesh(nullptr)
+{
+  VkCommandPoolCreateInfo pool_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = m_context->graphics_family(),
+  };
+  if (vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create command pool!"};
+  }
+
+  VkCommandBufferAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = m_command_pool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+  if (vkAllocateCommandBuffers(m_device, &allocate_info, &m_command_buffer)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to allocate command buffers!"};
+  }
+
+  VkFenceCreateInfo fence_info = {
+      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+  };
+  if (vkCreateFence(m_device, &fence_info, nullptr, &m_fence) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to create fence!"};
+  }
+
+  create_targets();
+  create_render_pass();
+  create_pipeline();
+  create_descriptor_set();
+}
+
+vktut::rendering::headless_renderer::~headless_renderer()
+{
+  // render() waits for its own submission, nothing of ours is in flight and
+  // the mesh and texture may go with the members
+  vkDestroyPipeline(m_device, m_pipeline, nullptr);
+  vkDestroyPipelineLayout(m_device, m_pipeline_layout, nullptr);
+  vkDestroyFramebuffer(m_device, m_framebuffer, nullptr);
+  vkDestroyRenderPass(m_device, m_render_pass, nullptr);
+  vkDestroyBuffer(m_device, m_uniform_buffer.buffer, nullptr);
+  vkFreeMemory(m_device, m_uniform_buffer.memory, nullptr);
+  vkDestroyBuffer(m_device, m_instance_buffer.buffer, nullptr);
+  vkFreeMemory(m_device, m_instance_buffer.memory, nullptr);
+  vkDestroyBuffer(m_device, m_readback_buffer.buffer, nullptr);
+  vkFreeMemory(m_device, m_readback_buffer.memory, nullptr);
+  vkDestroyImageView(m_device, m_depth_view, nullptr);
+  vkDestroyImage(m_device, m_depth_image.image, nullptr);
+  vkFreeMemory(m_device, m_depth_image.memory, nullptr);
+  vkDestroyImageView(m_device, m_color_view, nullptr);
+  vkDestroyImage(m_device, m_color_image.image, nullptr);
+  vkFreeMemory(m_device, m_color_image.memory, nullptr);
+  vkDestroyFence(m_device, m_fence, nullptr);
+  vkDestroyCommandPool(m_device, m_command_pool, nullptr);
+}
+
+VkExtent2D vktut::rendering::headless_renderer::extent() const
+{
+  return m_extent;
+}
+
+void vktut::rendering::headless_renderer::set_mesh(
+    assets::asset_manager::mesh_handle mesh)
+{
+  // the previous render has been waited for, nothing reads the old one
+  m_mesh = std::move(mesh);
+}
+
+std::vector<std::byte> vktut::rendering::headless_renderer::render(
+    const glm::mat4& view_projection, const glm::mat4& model)
+{
+  // the previous render has been waited for, the buffer is free to rewrite
+  std::array<float, 12> model_rows {};
+  for (glm::length_t row = 0; row < 3; ++row) {
+    for (glm::length_t column = 0; column < 4; ++column) {
+      model_rows[static_cast<std::size_t>(row * 4 + column)] =
+          model[column][row];
+    }
+  }
+  void* instance = nullptr;
+  vkMapMemory(m_device,
+              m_instance_buffer.memory,
+              0,
+              sizeof(model_rows),
+              0,
+              &instance);
+  std::copy(
+      model_rows.begin(), model_rows.end(), static_cast<float*>(instance));
+  vkUnmapMemory(m_device, m_instance_buffer.memory);
+
+  // the shader multiplies proj * view, the combined matrix goes in view
+  shaders::uniform_buffer_object ubo = {
+      .model = model,
+      .view = view_projection,
+      .proj = glm::mat4 {1.0F},
+  };
+  void* uniform = nullptr;
+  vkMapMemory(
+      m_device, m_uniform_buffer.memory, 0, sizeof(ubo), 0, &uniform);
+  std::copy(
+      &ubo, &ubo + 1, static_cast<shaders::uniform_buffer_object*>(uniform));
+  vkUnmapMemory(m_device, m_uniform_buffer.memory);
+
+  vkResetCommandBuffer(m_command_buffer, 0);
+  VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  if (vkBeginCommandBuffer(m_command_buffer, &begin_info) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to begin recording command buffer!"};
+  }
+
+  std::array clear_values = {
+      VkClearValue {.color = {{0.0F, 0.0F, 0.0F, 1.0F}}},
+      VkClearValue {.depthStencil = {1.0F, 0}},
+  };
+  VkRenderPassBeginInfo render_pass_info = {
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+      .renderPass = m_render_pass,
+      .framebuffer = m_framebuffer,
+      .renderArea =
+          {
+              .offset = {0, 0},
+              .extent = m_extent,
+          },
+      .clearValueCount = clear_values.size(),
+      .pClearValues = clear_values.data(),
+  };
+  vkCmdBeginRenderPass(
+      m_command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
+
+  if (m_mesh) {
+    vkCmdBindPipeline(
+        m_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(
+        m_command_buffer, 0, 1, &m_mesh->vertex_buffer.buffer, &offset);
+    vkCmdBindIndexBuffer(m_command_buffer,
+                         m_mesh->index_buffer.buffer,
+                         0,
+                         VK_INDEX_TYPE_UINT32);
+    vkCmdBindDescriptorSets(m_command_buffer,
+                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_pipeline_layout,
+                            0,
+                            1,
+                            &m_descriptor_set,
+                            0,
+                            nullptr);
+    auto push_constants = shaders::push_constants::from(0);
+    vkCmdPushConstants(m_command_buffer,
+                       m_pipeline_layout,
+                       VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0,
+                       sizeof(push_constants),
+                       &push_constants);
+    const auto& full_detail = m_mesh->lod_chain.levels.front();
+    vkCmdDrawIndexed(m_command_buffer,
+                     full_detail.index_count,
+                     1,
+                     full_detail.first_index,
+                     0,
+                     0);
+  }
+
+  vkCmdEndRenderPass(m_command_buffer);
+
+  // the render pass leaves the color image in TRANSFER_SRC_OPTIMAL
+  VkBufferImageCopy region = {
+      .bufferOffset = 0,
+      .bufferRowLength = 0,
+      .bufferImageHeight = 0,
+      .imageSubresource =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .mipLevel = 0,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+      .imageOffset = {0, 0, 0},
+      .imageExtent = {m_extent.width, m_extent.height, 1},
+  };
+  vkCmdCopyImageToBuffer(m_command_buffer,
+                         m_color_image.image,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         m_readback_buffer.buffer,
+                         1,
+                         &region);
+
+  VkBufferMemoryBarrier host_barrier = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = m_readback_buffer.buffer,
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier(m_command_buffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       1,
+                       &host_barrier,
+                       0,
+                       nullptr);
+
+  if (vkEndCommandBuffer(m_command_buffer) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to record command buffer!"};
+  }
+
+  m_context->submit_and_wait(m_command_buffer, m_fence);
+
+  auto size =
+      static_cast<std::size_t>(m_extent.width) * m_extent.height * 4;
+  std::vector<std::byte> pixels(size);
+  void* mapped = nullptr;
+  vkMapMemory(m_device, m_readback_buffer.memory, 0, size, 0, &mapped);
+  std::copy_n(static_cast<const std::byte*>(mapped), size, pixels.begin());
+  vkUnmapMemory(m_device, m_readback_buffer.memory);
+  return pixels;
+}
+
+void vktut::rendering::headless_renderer::create_targets()
+{
+  m_color_image = m_context->create_image(
+      m_extent,
+      color_format,
+      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  m_color_view = m_context->create_image_view(
+      m_color_image.image, color_format, VK_IMAGE_ASPECT_COLOR_BIT);
+
+  m_depth_image =
+      m_context->create_image(m_extent,
+                              depth_format,
+                              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  m_depth_view = m_context->create_image_view(
+      m_depth_image.image, depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+  m_readback_buffer = m_context->create_buffer(
+      static_cast<VkDeviceSize>(m_extent.width) * m_extent.height * 4,
+      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+          | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  // a row major 3x4 matrix, matches `layout(row_major) mat4x3`
+  m_instance_buffer = m_context->create_buffer(
+      12 * sizeof(float),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+          | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  m_uniform_buffer = m_context->create_buffer(
+      sizeof(shaders::uniform_buffer_object),
+      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+          | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+void vktut::rendering::headless_renderer::create_render_pass()
+{
+  std::array attachments = {
+      VkAttachmentDescription {
+          .format = color_format,
+          .samples = VK_SAMPLE_COUNT_1_BIT,
+          .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+          .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+          .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+          .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+          .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+          .finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+      },
+      VkAttachmentDescription {
+          .format = depth_format,
+          .samples = VK_SAMPLE_COUNT_1_BIT,
+          .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+          .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+          .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+          .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+          .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+          .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+      },
+  };
+
+  VkAttachmentReference color_attachment_ref = {
+      .attachment = 0,
+      .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+  };
+  VkAttachmentReference depth_attachment_ref = {
+      .attachment = 1,
+      .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+  };
+
+  VkSubpassDescription subpass = {
+      .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+      .colorAttachmentCount = 1,
+      .pColorAttachments = &color_attachment_ref,
+      .pDepthStencilAttachment = &depth_attachment_ref,
+  };
+
+  // the previous render's readback copy has to finish before the clear
+  // overwrites the image, and this render's writes before the next copy
+  std::array dependencies = {
+      VkSubpassDependency {
+          .srcSubpass = VK_SUBPASS_EXTERNAL,
+          .dstSubpass = 0,
+          .srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT
+              | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+              | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+          .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+          .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+              | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+      },
+      VkSubpassDependency {
+          .srcSubpass = 0,
+          .dstSubpass = VK_SUBPASS_EXTERNAL,
+          .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+          .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+          .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+      },
+  };
+
+  VkRenderPassCreateInfo render_pass_info = {
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+      .attachmentCount = attachments.size(),
+      .pAttachments = attachments.data(),
+      .subpassCount = 1,
+      .pSubpasses = &subpass,
+      .dependencyCount = dependencies.size(),
+      .pDependencies = dependencies.data(),
+  };
+
+  if (vkCreateRenderPass(m_device, &render_pass_info, nullptr, &m_render_pass)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create render pass!"};
+  }
+
+  std::array views = {m_color_view, m_depth_view};
+  VkFramebufferCreateInfo framebuffer_info = {
+      .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+      .renderPass = m_render_pass,
+      .attachmentCount = views.size(),
+      .pAttachments = views.data(),
+      .width = m_extent.width,
+      .height = m_extent.height,
+      .layers = 1,
+  };
+
+  if (vkCreateFramebuffer(m_device, &framebuffer_info, nullptr, &m_framebuffer)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create framebuffer!"};
+  }
+}
+
+void vktut::rendering::headless_renderer::create_pipeline()
+{
+  shaders::material material = {
+      .textured = true,
+      .vertex_colors = false,
+      .bindless_textures = false,
+      .base_color = glm::vec3 {1.0F},
+      .texture_index = 0,
+  };
+
+  auto create_shader_module = [this](std::span<const std::uint32_t> code)
+  {
+    VkShaderModuleCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = code.size_bytes(),
+        .pCode = code.data(),
+    };
+    VkShaderModule shader_module = {};
+    if (vkCreateShaderModule(m_device, &create_info, nullptr, &shader_module)
+        != VK_SUCCESS)
+    {
+      throw std::runtime_error {"failed to create shader module!"};
+    }
+    return shader_module;
+  };
+  VkShaderModule vert_shader_module =
+      create_shader_module(material.vertex_spirv());
+  VkShaderModule frag_shader_module =
+      create_shader_module(material.fragment_spirv());
+
+  auto fragment_constants = material.specialization();
+  auto fragment_map_entries = shaders::fragment_constants::map_entries();
+  VkSpecializationInfo fragment_specialization = {
+      .mapEntryCount = fragment_map_entries.size(),
+      .pMapEntries = fragment_map_entries.data(),
+      .dataSize = sizeof(fragment_constants),
+      .pData = &fragment_constants,
+  };
+
+  std::array shader_stages = {
+      VkPipelineShaderStageCreateInfo {
+          .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+          .stage = VK_SHADER_STAGE_VERTEX_BIT,
+          .module = vert_shader_module,
+          .pName = "main",
+      },
+      VkPipelineShaderStageCreateInfo {
+          .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+          .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+          .module = frag_shader_module,
+          .pName = "main",
+          .pSpecializationInfo = &fragment_specialization,
+      },
+  };
+
+  auto binding_description = shaders::vertex::binding_description();
+  auto attribute_descriptions = material.attribute_descriptions();
+  VkPipelineVertexInputStateCreateInfo vertex_input_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+      .vertexBindingDescriptionCount = 1,
+      .pVertexBindingDescriptions = &binding_description,
+      .vertexAttributeDescriptionCount =
+          static_cast<std::uint32_t>(attribute_descriptions.size()),
+      .pVertexAttributeDescriptions = attribute_descriptions.data(),
+  };
+
+  VkPipelineInputAssemblyStateCreateInfo input_assembly = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+      .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+      .primitiveRestartEnable = VK_FALSE,
+  };
+
+  // the target never changes size, so neither does the viewport
+  VkViewport viewport = {
+      .x = 0,
+      .y = 0,
+      .width = static_cast<float>(m_extent.width),
+      .height = static_cast<float>(m_extent.height),
+      .minDepth = 0,
+      .maxDepth = 1,
+  };
+  VkRect2D scissor = {
+      .offset = {0, 0},
+      .extent = m_extent,
+  };
+  VkPipelineViewportStateCreateInfo viewport_state = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+      .viewportCount = 1,
+      .pViewports = &viewport,
+      .scissorCount = 1,
+      .pScissors = &scissor,
+  };
+
+  VkPipelineRasterizationStateCreateInfo rasterizer = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+      .depthClampEnable = VK_FALSE,
+      .rasterizerDiscardEnable = VK_FALSE,
+      .polygonMode = VK_POLYGON_MODE_FILL,
+      .cullMode = VK_CULL_MODE_BACK_BIT,
+      .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+      .depthBiasEnable = VK_FALSE,
+      .depthBiasConstantFactor = 0,
+      .depthBiasClamp = 0,
+      .depthBiasSlopeFactor = 0,
+      .lineWidth = 1,
+  };
+
+  VkPipelineMultisampleStateCreateInfo multisampling = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+      .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+      .sampleShadingEnable = VK_FALSE,
+      .minSampleShading = 1,
+      .pSampleMask = nullptr,
+      .alphaToCoverageEnable = VK_FALSE,
+      .alphaToOneEnable = VK_FALSE,
+  };
+
+  VkPipelineDepthStencilStateCreateInfo depth_stencil = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+      .depthTestEnable = VK_TRUE,
+      .depthWriteEnable = VK_TRUE,
+      .depthCompareOp = VK_COMPARE_OP_LESS,
+      .depthBoundsTestEnable = VK_FALSE,
+      .stencilTestEnable = VK_FALSE,
+      .front = {},
+      .back = {},
+      .minDepthBounds = 0,
+      .maxDepthBounds = 1,
+  };
+
+  VkPipelineColorBlendAttachmentState color_blend_attachment = {
+      .blendEnable = VK_FALSE,
+      .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
+      .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
+      .colorBlendOp = VK_BLEND_OP_ADD,
+      .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+      .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+      .alphaBlendOp = VK_BLEND_OP_ADD,
+      .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+          | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+  };
+  VkPipelineColorBlendStateCreateInfo color_blending = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+      .logicOpEnable = VK_FALSE,
+      .logicOp = VK_LOGIC_OP_COPY,
+      .attachmentCount = 1,
+      .pAttachments = &color_blend_attachment,
+      .blendConstants = {0, 0, 0, 0},
+  };
+
+  // bindings 0 to 2 as in the windowed material
+  m_descriptor_set_layout = m_context->descriptor_set_layout({
+      VkDescriptorSetLayoutBinding {
+          .binding = 0,
+          .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+          .pImmutableSamplers = nullptr,
+      },
+      VkDescriptorSetLayoutBinding {
+          .binding = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+          .pImmutableSamplers = nullptr,
+      },
+      VkDescriptorSetLayoutBinding {
+          .binding = 2,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+          .pImmutableSamplers = nullptr,
+      },
+  });
+
+  VkPushConstantRange push_constant_range = {
+      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .offset = 0,
+      .size = sizeof(shaders::push_constants),
+  };
+  VkPipelineLayoutCreateInfo pipeline_layout_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &m_descriptor_set_layout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &push_constant_range,
+  };
+  if (vkCreatePipelineLayout(
+          m_device, &pipeline_layout_info, nullptr, &m_pipeline_layout)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create pipeline layout!"};
+  }
+
+  VkGraphicsPipelineCreateInfo pipeline_info = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+      .stageCount = shader_stages.size(),
+      .pStages = shader_stages.data(),
+      .pVertexInputState = &vertex_input_info,
+      .pInputAssemblyState = &input_assembly,
+      .pViewportState = &viewport_state,
+      .pRasterizationState = &rasterizer,
+      .pMultisampleState = &multisampling,
+      .pDepthStencilState = &depth_stencil,
+      .pColorBlendState = &color_blending,
+      .pDynamicState = nullptr,
+      .layout = m_pipeline_layout,
+      .renderPass = m_render_pass,
+      .subpass = 0,
+      .basePipelineHandle = VK_NULL_HANDLE,
+      .basePipelineIndex = -1,
+  };
+
+  // renderers after the first find their pipeline in the shared cache
+  if (vkCreateGraphicsPipelines(m_device,
+                                m_context->pipeline_cache(),
+                                1,
+                                &pipeline_info,
+                                nullptr,
+                                &m_pipeline)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create graphics pipeline!"};
+  }
+
+  vkDestroyShaderModule(m_device, vert_shader_module, nullptr);
+  vkDestroyShaderModule(m_device, frag_shader_module, nullptr);
+}
+
+void vktut::rendering::headless_renderer::create_descriptor_set()
+{
+  m_descriptor_set = m_descriptor_allocator.allocate(m_descriptor_set_layout);
+
+  VkDescriptorImageInfo image_info = {
+      .sampler = m_context->sampler(VK_FILTER_LINEAR,
+                                    VK_SAMPLER_ADDRESS_MODE_REPEAT),
+      .imageView = m_texture->view,
+      .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+  };
+  VkDescriptorBufferInfo instance_info = {
+      .buffer = m_instance_buffer.buffer,
+      .offset = 0,
+      .range = VK_WHOLE_SIZE,
+  };
+  VkDescriptorBufferInfo uniform_info = {
+      .buffer = m_uniform_buffer.buffer,
+      .offset = 0,
+      .range = sizeof(shaders::uniform_buffer_object),
+  };
+  std::array writes = {
+      VkWriteDescriptorSet {
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = m_descriptor_set,
+          .dstBinding = 0,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+          .pBufferInfo = &uniform_info,
+      },
+      VkWriteDescriptorSet {
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = m_descriptor_set,
+          .dstBinding = 1,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .pImageInfo = &image_info,
+      },
+      VkWriteDescriptorSet {
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = m_descriptor_set,
+          .dstBinding = 2,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .pBufferInfo = &instance_info,
+      },
+  };
+  vkUpdateDescriptorSets(m_device, writes.size(), writes.data(), 0, nullptr);
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <array>
+
+#include "vktut/rendering/quality_governor.hpp"
+
+vktut::rendering::quality_governor::quality_governor(
+    VkSampleCountFlagBits max_samples,
+    bool sample_shading_supported,
+    float budget_ms)
+    : m_current(0)
+    , m_budget_ms(budget_ms)
+    , m_average_ms(0)
+    , m_frames_measured(0)
+    , m_frames_over_budget(0)
+    , m_frames_with_headroom(0)
+    , m_step_up_frames(initial_step_up_frames)
+{
+  constexpr std::array sample_counts = {
+      VK_SAMPLE_COUNT_64_BIT,
+      VK_SAMPLE_COUNT_32_BIT,
+      VK_SAMPLE_COUNT_16_BIT,
+      VK_SAMPLE_COUNT_8_BIT,
+      VK_SAMPLE_COUNT_4_BIT,
+      VK_SAMPLE_COUNT_2_BIT,
+      VK_SAMPLE_COUNT_1_BIT,
+  };
+
+  for (auto samples : sample_counts) {
+    if (samples > max_samples) {
+      continue;
+    }
+    // per-sample shading costs more than halving the sample count, so it is
+    // the first thing to go at every count
+    if (sample_shading_supported && samples != VK_SAMPLE_COUNT_1_BIT) {
+      m_levels.push_back(quality_level {
+          .samples = samples,
+          .sample_shading = true,
+          .min_sample_shading = 0.2F,
+      });
+    }
+    m_levels.push_back(quality_level {
+        .samples = samples,
+        .sample_shading = false,
+        .min_sample_shading = 0,
+    });
+  }
+}
+
+const vktut::rendering::quality_level&
+vktut::rendering::quality_governor::current() const
+{
+  return m_levels[m_current];
+}
+
+float vktut::rendering::quality_governor::average_frame_time_ms() const
+{
+  return m_average_ms;
+}
+
+bool vktut::rendering::quality_governor::record_frame(float frame_time_ms)
+{
+  m_average_ms = m_frames_measured == 0
+      ? frame_time_ms
+      : m_average_ms + smoothing * (frame_time_ms - m_average_ms);
+  ++m_frames_measured;
+  if (m_frames_measured < settle_frames) {
+    return false;
+  }
+
+  if (m_average_ms > m_budget_ms) {
+    ++m_frames_over_budget;
+    m_frames_with_headroom = 0;
+  } else if (m_average_ms < m_budget_ms * step_up_headroom) {
+    ++m_frames_with_headroom;
+    m_frames_over_budget = 0;
+  } else {
+    m_frames_over_budget = 0;
+    m_frames_with_headroom = 0;
+  }
+
+  if (m_frames_over_budget >= step_down_frames
+      && m_current + 1 < m_levels.size())
+  {
+    change_level(m_current + 1);
+    m_step_up_frames = std::min(m_step_up_frames * 2, max_step_up_frames);
+    return true;
+  }
+  if (m_frames_with_headroom >= m_step_up_frames && m_current > 0) {
+    change_level(m_current - 1);
+    return true;
+  }
+  return false;
+}
+
+void vktut::rendering::quality_governor::change_level(std::size_t level)
+{
+  m_current = level;
+  // frame times from the old level say nothing about the new one
+  m_average_ms = 0;
+  m_frames_measured = 0;
+  m_frames_over_budget = 0;
+  m_frames_with_headroom = 0;
+}
@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "vktut/rendering/resolution_scaler.hpp"
+
+vktut::rendering::resolution_scaler::resolution_scaler(float min_scale,
+                                                       float max_scale,
+                                                       float target_ms)
+    : m_min_scale(min_scale)
+    , m_max_scale(max_scale)
+    , m_target_ms(target_ms)
+    , m_scale(max_scale)
+{
+}
+
+float vktut::rendering::resolution_scaler::scale() const
+{
+  return m_scale;
+}
+
+VkExtent2D vktut::rendering::resolution_scaler::apply(
+    VkExtent2D full_extent) const
+{
+  auto scaled = [this](std::uint32_t size)
+  {
+    auto scaled_size = std::ceil(static_cast<float>(size) * m_scale);
+    return std::max(1U, static_cast<std::uint32_t>(scaled_size));
+  };
+  return VkExtent2D {
+      .width = std::min(scaled(full_extent.width), full_extent.width),
+      .height = std::min(scaled(full_extent.height), full_extent.height),
+  };
+}
+
+void vktut::rendering::resolution_scaler::update(float gpu_frame_time_ms)
+{
+  if (gpu_frame_time_ms <= 0) {
+    return;
+  }
+
+  float ratio = m_target_ms / gpu_frame_time_ms;
+  if (std::abs(ratio - 1.0F) < dead_band) {
+    return;
+  }
+
+  // frame time is roughly proportional to pixel count, i.e. to scale squared
+  float step = std::clamp(std::sqrt(ratio), 1.0F - max_step, 1.0F + max_step);
+  m_scale = std::clamp(m_scale * step, m_min_scale, m_max_scale);
+}
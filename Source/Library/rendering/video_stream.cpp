@@ -0,0 +1,128 @@
+#include <stdexcept>
+#include <string_view>
+
+#include "vktut/rendering/video_stream.hpp"
+
+vktut::rendering::video_stream::video_stream(VkDevice device,
+                                             VkPhysicalDevice physical_device,
+                                             video_format format,
+                                             VkExtent2D extent,
+                                             const std::string& path,
+                                             std::uint32_t frame_rate,
+                                             std::size_t slot_count)
+    : m_format(format)
+    , m_extent(extent)
+    // a full resolution luma plane and two quarter resolution chroma planes
+    , m_frame_size(static_cast<VkDeviceSize>(extent.width) * extent.height * 3
+                   / 2)
+    , m_output(path == "-" ? stdout : std::fopen(path.c_str(), "wb"))
+    , m_ring(device,
+             physical_device,
+             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+             slot_count)
+    , m_writer(std::make_unique<utilities::thread_pool>(1))
+{
+  if (m_output == nullptr) {
+    throw std::runtime_error {"failed to open video stream output!"};
+  }
+  if (extent.width % 8 != 0 || extent.height % 2 != 0 || extent.width == 0
+      || extent.height == 0)
+  {
+    throw std::runtime_error {"invalid video stream extent!"};
+  }
+
+  if (m_format == video_format::y4m) {
+    // C420jpeg is 4:2:0 with chroma centered between the luma samples, which
+    // is how rgb_to_yuv.comp averages it
+    std::fprintf(m_output,
+                 "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg "
+                 "XCOLORRANGE=LIMITED\n",
+                 extent.width,
+                 extent.height,
+                 frame_rate);
+  }
+}
+
+vktut::rendering::video_stream::~video_stream()
+{
+  // joins the writer before the ring goes away under it
+  m_writer.reset();
+  if (m_output != stdout) {
+    std::fclose(m_output);
+  } else {
+    std::fflush(m_output);
+  }
+}
+
+VkExtent2D vktut::rendering::video_stream::stream_extent(VkExtent2D extent)
+{
+  return VkExtent2D {
+      .width = extent.width / 8 * 8,
+      .height = extent.height / 2 * 2,
+  };
+}
+
+VkExtent2D vktut::rendering::video_stream::extent() const
+{
+  return m_extent;
+}
+
+bool vktut::rendering::video_stream::interleaved_chroma() const
+{
+  return m_format == video_format::nv12;
+}
+
+std::optional<VkDescriptorBufferInfo> vktut::rendering::video_stream::acquire(
+    std::size_t frame_index)
+{
+  auto slot_index = m_ring.acquire(frame_index, m_frame_size);
+  if (!slot_index) {
+    ++m_dropped_frames;
+    return std::nullopt;
+  }
+  return VkDescriptorBufferInfo {
+      .buffer = m_ring.buffer(*slot_index),
+      .offset = 0,
+      .range = m_frame_size,
+  };
+}
+
+void vktut::rendering::video_stream::frame_completed(std::size_t frame_index)
+{
+  for (auto slot_index : m_ring.complete(frame_index)) {
+    write(slot_index);
+  }
+}
+
+void vktut::rendering::video_stream::flush()
+{
+  for (auto slot_index : m_ring.complete_all()) {
+    write(slot_index);
+  }
+}
+
+std::uint64_t vktut::rendering::video_stream::dropped_frames() const
+{
+  return m_dropped_frames;
+}
+
+void vktut::rendering::video_stream::write(std::size_t slot_index)
+{
+  // one writer thread, so frames reach the output in the order they were
+  // rendered
+  m_writer->submit(
+      [this, slot_index]
+      {
+        if (m_format == video_format::y4m) {
+          constexpr std::string_view frame_header = "FRAME\n";
+          std::fwrite(
+              frame_header.data(), 1, frame_header.size(), m_output);
+        }
+        // straight from the mapped readback memory, nothing is copied
+        std::fwrite(m_ring.data(slot_index), 1, m_frame_size, m_output);
+        m_ring.release(slot_index);
+        // whoever reads the pipe should see the frame now, not once the
+        // stdio buffer happens to fill up
+        std::fflush(m_output);
+      });
+}
@@ -0,0 +1,63 @@
+#include <limits>
+
+#include "vktut/scene/bounding_box.hpp"
+
+vktut::scene::bounding_box vktut::scene::bounding_box::empty()
+{
+  return bounding_box {
+      .min = glm::vec3 {std::numeric_limits<float>::max()},
+      .max = glm::vec3 {std::numeric_limits<float>::lowest()},
+  };
+}
+
+vktut::scene::bounding_box vktut::scene::bounding_box::sphere(
+    const glm::vec3& center, float radius)
+{
+  return bounding_box {
+      .min = center - glm::vec3 {radius},
+      .max = center + glm::vec3 {radius},
+  };
+}
+
+void vktut::scene::bounding_box::expand(const bounding_box& other)
+{
+  min = glm::min(min, other.min);
+  max = glm::max(max, other.max);
+}
+
+void vktut::scene::bounding_box::expand(const glm::vec3& point)
+{
+  min = glm::min(min, point);
+  max = glm::max(max, point);
+}
+
+glm::vec3 vktut::scene::bounding_box::center() const
+{
+  return (min + max) * 0.5F;
+}
+
+float vktut::scene::bounding_box::half_area() const
+{
+  glm::vec3 size = glm::max(max - min, glm::vec3 {0.0F});
+  return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+vktut::scene::bounding_box vktut::scene::bounding_box::transformed(
+    const glm::mat4& transform) const
+{
+  // every output axis takes the smaller and the larger product per input
+  // axis, which gives the tight box without transforming all eight corners
+  glm::vec3 translation {transform[3]};
+  bounding_box result = {
+      .min = translation,
+      .max = translation,
+  };
+  for (glm::length_t column = 0; column < 3; ++column) {
+    glm::vec3 axis {transform[column]};
+    glm::vec3 low = axis * min[column];
+    glm::vec3 high = axis * max[column];
+    result.min += glm::min(low, high);
+    result.max += glm::max(low, high);
+  }
+  return result;
+}
@@ -0,0 +1,411 @@
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <utility>
+
+#include "vktut/scene/bvh.hpp"
+
+vktut::scene::bvh vktut::scene::bvh::build(std::vector<bounding_box> bounds)
+{
+  bvh tree;
+  tree.m_bounds = std::move(bounds);
+  auto object_count = static_cast<std::uint32_t>(tree.m_bounds.size());
+  tree.m_objects.resize(object_count);
+  std::iota(tree.m_objects.begin(), tree.m_objects.end(), 0);
+  tree.m_leaves.assign(object_count, 0);
+  if (object_count == 0) {
+    return tree;
+  }
+
+  std::vector<glm::vec3> centers(object_count);
+  std::transform(tree.m_bounds.begin(),
+                 tree.m_bounds.end(),
+                 centers.begin(),
+                 [](const auto& box) { return box.center(); });
+
+  // split in the order they were created, which is breadth first. children
+  // are appended, so they always come after their parent
+  tree.m_nodes.reserve(2 * static_cast<std::size_t>(object_count));
+  tree.m_nodes.push_back(node {
+      .bounds = bounding_box::empty(),
+      .first = 0,
+      .count = object_count,
+  });
+  for (std::uint32_t i = 0; i < tree.m_nodes.size(); ++i) {
+    tree.split(i, centers);
+  }
+
+  tree.m_dirty.assign(tree.m_nodes.size(), 0);
+  tree.m_build_cost = tree.compute_cost();
+  tree.m_cost = tree.m_build_cost;
+  return tree;
+}
+
+std::future<vktut::scene::bvh> vktut::scene::bvh::build_async(
+    utilities::thread_pool& pool, std::vector<bounding_box> bounds)
+{
+  // the pool takes copyable jobs, so the promise is shared
+  auto promise = std::make_shared<std::promise<bvh>>();
+  auto result = promise->get_future();
+  pool.submit(
+      [promise, bounds = std::move(bounds)]() mutable
+      {
+        try {
+          promise->set_value(build(std::move(bounds)));
+        } catch (...) {
+          promise->set_exception(std::current_exception());
+        }
+      });
+  return result;
+}
+
+std::size_t vktut::scene::bvh::size() const
+{
+  return m_bounds.size();
+}
+
+const vktut::scene::bounding_box& vktut::scene::bvh::bounds(
+    object target) const
+{
+  return m_bounds[target];
+}
+
+void vktut::scene::bvh::set_bounds(object target, const bounding_box& bounds)
+{
+  m_bounds[target] = bounds;
+  m_dirty[m_leaves[target]] = 1;
+  m_any_dirty = true;
+}
+
+void vktut::scene::bvh::refit()
+{
+  if (!m_any_dirty) {
+    return;
+  }
+  // back to front visits every child before its parent
+  for (auto i = m_nodes.size(); i-- > 0;) {
+    auto& current = m_nodes[i];
+    if (current.count != 0) {
+      if (m_dirty[i] == 0) {
+        continue;
+      }
+      current.bounds = bounding_box::empty();
+      for (std::uint32_t k = 0; k < current.count; ++k) {
+        current.bounds.expand(m_bounds[m_objects[current.first + k]]);
+      }
+    } else if (m_dirty[current.first] != 0 || m_dirty[current.first + 1] != 0)
+    {
+      current.bounds = m_nodes[current.first].bounds;
+      current.bounds.expand(m_nodes[current.first + 1].bounds);
+      m_dirty[i] = 1;
+    }
+  }
+  std::fill(m_dirty.begin(), m_dirty.end(), 0);
+  m_any_dirty = false;
+  m_cost = compute_cost();
+}
+
+float vktut::scene::bvh::cost() const
+{
+  return m_cost;
+}
+
+bool vktut::scene::bvh::degraded() const
+{
+  return m_cost > m_build_cost * rebuild_threshold;
+}
+
+void vktut::scene::bvh::query_frustum(std::span<const glm::vec4, 6> planes,
+                                      std::vector<object>& objects) const
+{
+  if (m_nodes.empty()) {
+    return;
+  }
+  std::vector<std::uint32_t> stack {0};
+  while (!stack.empty()) {
+    const auto& current = m_nodes[stack.back()];
+    auto current_index = stack.back();
+    stack.pop_back();
+
+    auto result = classify(current.bounds, planes);
+    if (result == containment::outside) {
+      continue;
+    }
+    // nothing below a node that is completely visible needs testing
+    if (result == containment::inside) {
+      collect(current_index, objects);
+    } else if (current.count != 0) {
+      for (std::uint32_t k = 0; k < current.count; ++k) {
+        object candidate = m_objects[current.first + k];
+        if (classify(m_bounds[candidate], planes) != containment::outside) {
+          objects.push_back(candidate);
+        }
+      }
+    } else {
+      stack.push_back(current.first);
+      stack.push_back(current.first + 1);
+    }
+  }
+}
+
+void vktut::scene::bvh::query_sphere(const glm::vec3& center,
+                                     float radius,
+                                     std::vector<object>& objects) const
+{
+  if (m_nodes.empty()) {
+    return;
+  }
+  std::vector<std::uint32_t> stack {0};
+  while (!stack.empty()) {
+    const auto& current = m_nodes[stack.back()];
+    stack.pop_back();
+
+    if (!overlaps(current.bounds, center, radius)) {
+      continue;
+    }
+    if (current.count != 0) {
+      for (std::uint32_t k = 0; k < current.count; ++k) {
+        object candidate = m_objects[current.first + k];
+        if (overlaps(m_bounds[candidate], center, radius)) {
+          objects.push_back(candidate);
+        }
+      }
+    } else {
+      stack.push_back(current.first);
+      stack.push_back(current.first + 1);
+    }
+  }
+}
+
+void vktut::scene::bvh::query_ray(const ray& query,
+                                  std::vector<object>& objects) const
+{
+  if (m_nodes.empty()) {
+    return;
+  }
+  // zero components become infinities, which the slab test handles
+  glm::vec3 inverse_direction = 1.0F / query.direction;
+  constexpr float miss = std::numeric_limits<float>::infinity();
+  if (entry_distance(m_nodes[0].bounds, query, inverse_direction) == miss) {
+    return;
+  }
+
+  std::vector<std::uint32_t> stack {0};
+  while (!stack.empty()) {
+    const auto& current = m_nodes[stack.back()];
+    stack.pop_back();
+
+    if (current.count != 0) {
+      for (std::uint32_t k = 0; k < current.count; ++k) {
+        object candidate = m_objects[current.first + k];
+        if (entry_distance(m_bounds[candidate], query, inverse_direction)
+            != miss)
+        {
+          objects.push_back(candidate);
+        }
+      }
+      continue;
+    }
+
+    std::uint32_t near_child = current.first;
+    std::uint32_t far_child = current.first + 1;
+    float near_distance = entry_distance(
+        m_nodes[near_child].bounds, query, inverse_direction);
+    float far_distance =
+        entry_distance(m_nodes[far_child].bounds, query, inverse_direction);
+    if (far_distance < near_distance) {
+      std::swap(near_child, far_child);
+      std::swap(near_distance, far_distance);
+    }
+    // the stack pops the nearer child first
+    if (far_distance != miss) {
+      stack.push_back(far_child);
+    }
+    if (near_distance != miss) {
+      stack.push_back(near_child);
+    }
+  }
+}
+
+void vktut::scene::bvh::split(std::uint32_t node_index,
+                              std::span<const glm::vec3> centers)
+{
+  auto first = m_nodes[node_index].first;
+  auto count = m_nodes[node_index].count;
+  auto node_bounds = bounding_box::empty();
+  auto center_bounds = bounding_box::empty();
+  for (std::uint32_t k = first; k < first + count; ++k) {
+    node_bounds.expand(m_bounds[m_objects[k]]);
+    center_bounds.expand(centers[m_objects[k]]);
+  }
+  m_nodes[node_index].bounds = node_bounds;
+
+  if (count <= max_leaf_size) {
+    for (std::uint32_t k = first; k < first + count; ++k) {
+      m_leaves[m_objects[k]] = node_index;
+    }
+    return;
+  }
+
+  // objects go into equally wide bins along each axis by their centers, the
+  // boundaries between bins are the only split candidates
+  glm::vec3 extent = center_bounds.max - center_bounds.min;
+  auto bin_of = [&](object target, glm::length_t axis)
+  {
+    float offset = centers[target][axis] - center_bounds.min[axis];
+    auto bin = static_cast<std::size_t>(
+        offset * static_cast<float>(bin_count) / extent[axis]);
+    return std::min(bin, bin_count - 1);
+  };
+
+  float best_cost = std::numeric_limits<float>::max();
+  glm::length_t best_axis = -1;
+  std::size_t best_split = 0;
+  for (glm::length_t axis = 0; axis < 3; ++axis) {
+    if (extent[axis] <= 0.0F) {
+      continue;
+    }
+    std::array<bounding_box, bin_count> bin_bounds {};
+    std::array<std::uint32_t, bin_count> bin_counts {};
+    bin_bounds.fill(bounding_box::empty());
+    for (std::uint32_t k = first; k < first + count; ++k) {
+      auto bin = bin_of(m_objects[k], axis);
+      bin_bounds[bin].expand(m_bounds[m_objects[k]]);
+      ++bin_counts[bin];
+    }
+
+    // everything from a bin onwards, swept from the right
+    std::array<float, bin_count> right_areas {};
+    std::array<std::uint32_t, bin_count> right_counts {};
+    auto right = bounding_box::empty();
+    std::uint32_t right_count = 0;
+    for (std::size_t bin = bin_count - 1; bin > 0; --bin) {
+      right.expand(bin_bounds[bin]);
+      right_count += bin_counts[bin];
+      right_areas[bin] = right.half_area();
+      right_counts[bin] = right_count;
+    }
+
+    auto left = bounding_box::empty();
+    std::uint32_t left_count = 0;
+    for (std::size_t bin = 1; bin < bin_count; ++bin) {
+      left.expand(bin_bounds[bin - 1]);
+      left_count += bin_counts[bin - 1];
+      if (left_count == 0 || right_counts[bin] == 0) {
+        continue;
+      }
+      float split_cost = left.half_area() * static_cast<float>(left_count)
+          + right_areas[bin] * static_cast<float>(right_counts[bin]);
+      if (split_cost < best_cost) {
+        best_cost = split_cost;
+        best_axis = axis;
+        best_split = bin;
+      }
+    }
+  }
+
+  auto begin = m_objects.begin() + first;
+  auto end = begin + count;
+  auto middle = begin + count / 2;
+  // when every center coincides no split is better than any other
+  if (best_axis >= 0) {
+    middle = std::partition(begin,
+                            end,
+                            [&](object target)
+                            { return bin_of(target, best_axis) < best_split; });
+  }
+  auto left_count = static_cast<std::uint32_t>(middle - begin);
+
+  auto left_index = static_cast<std::uint32_t>(m_nodes.size());
+  m_nodes[node_index].first = left_index;
+  m_nodes[node_index].count = 0;
+  m_nodes.push_back(node {
+      .bounds = bounding_box::empty(),
+      .first = first,
+      .count = left_count,
+  });
+  m_nodes.push_back(node {
+      .bounds = bounding_box::empty(),
+      .first = first + left_count,
+      .count = count - left_count,
+  });
+}
+
+void vktut::scene::bvh::collect(std::uint32_t node_index,
+                                std::vector<object>& objects) const
+{
+  std::vector<std::uint32_t> stack {node_index};
+  while (!stack.empty()) {
+    const auto& current = m_nodes[stack.back()];
+    stack.pop_back();
+    if (current.count != 0) {
+      objects.insert(objects.end(),
+                     m_objects.begin() + current.first,
+                     m_objects.begin() + current.first + current.count);
+    } else {
+      stack.push_back(current.first);
+      stack.push_back(current.first + 1);
+    }
+  }
+}
+
+float vktut::scene::bvh::compute_cost() const
+{
+  if (m_nodes.empty()) {
+    return 0.0F;
+  }
+  // traversing a node and testing an object are taken to cost the same
+  float cost = 0.0F;
+  for (const auto& current : m_nodes) {
+    cost += current.bounds.half_area()
+        * static_cast<float>(current.count != 0 ? current.count : 1);
+  }
+  float root_area = m_nodes[0].bounds.half_area();
+  return root_area > 0.0F ? cost / root_area : 0.0F;
+}
+
+vktut::scene::bvh::containment vktut::scene::bvh::classify(
+    const bounding_box& box, std::span<const glm::vec4, 6> planes)
+{
+  auto result = containment::inside;
+  for (const auto& plane : planes) {
+    glm::vec3 normal {plane};
+    // the corners furthest along and against the normal
+    glm::vec3 positive {normal.x >= 0.0F ? box.max.x : box.min.x,
+                        normal.y >= 0.0F ? box.max.y : box.min.y,
+                        normal.z >= 0.0F ? box.max.z : box.min.z};
+    glm::vec3 negative {normal.x >= 0.0F ? box.min.x : box.max.x,
+                        normal.y >= 0.0F ? box.min.y : box.max.y,
+                        normal.z >= 0.0F ? box.min.z : box.max.z};
+    if (glm::dot(normal, positive) + plane.w < 0.0F) {
+      return containment::outside;
+    }
+    if (glm::dot(normal, negative) + plane.w < 0.0F) {
+      result = containment::intersecting;
+    }
+  }
+  return result;
+}
+
+bool vktut::scene::bvh::overlaps(const bounding_box& box,
+                                 const glm::vec3& center,
+                                 float radius)
+{
+  glm::vec3 closest = glm::clamp(center, box.min, box.max);
+  glm::vec3 offset = closest - center;
+  return glm::dot(offset, offset) <= radius * radius;
+}
+
+float vktut::scene::bvh::entry_distance(const bounding_box& box,
+                                        const ray& query,
+                                        const glm::vec3& inverse_direction)
+{
+  glm::vec3 to_min = (box.min - query.origin) * inverse_direction;
+  glm::vec3 to_max = (box.max - query.origin) * inverse_direction;
+  glm::vec3 near = glm::min(to_min, to_max);
+  glm::vec3 far = glm::max(to_min, to_max);
+  float enter = std::max({near.x, near.y, near.z, 0.0F});
+  float exit = std::min({far.x, far.y, far.z, query.max_distance});
+  return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <bit>
+#include <latch>
+#include <limits>
+
+#include "vktut/scene/frustum_culler.hpp"
+
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
+
+vktut::scene::frustum_culler::object vktut::scene::frustum_culler::add(
+    const glm::vec3& center, float radius)
+{
+  auto added = static_cast<object>(m_count++);
+  if (m_count > m_radius.size()) {
+    std::size_t padded = m_radius.size() + batch_size;
+    m_center_x.resize(padded, 0.0F);
+    m_center_y.resize(padded, 0.0F);
+    m_center_z.resize(padded, 0.0F);
+    m_radius.resize(padded, std::numeric_limits<float>::lowest());
+  }
+  set(added, center, radius);
+  return added;
+}
+
+void vktut::scene::frustum_culler::set(object target,
+                                       const glm::vec3& center,
+                                       float radius)
+{
+  m_center_x[target] = center.x;
+  m_center_y[target] = center.y;
+  m_center_z[target] = center.z;
+  // lowest() fails the plane test even for a sphere right on the plane
+  m_radius[target] = radius < 0.0F ? std::numeric_limits<float>::lowest()
+                                   : radius;
+}
+
+std::size_t vktut::scene::frustum_culler::size() const
+{
+  return m_count;
+}
+
+void vktut::scene::frustum_culler::cull(const glm::mat4& view_projection,
+                                        std::vector<object>& visible,
+                                        utilities::thread_pool* pool)
+{
+  visible.clear();
+  auto frustum = planes(view_projection);
+  std::size_t job_count = (m_count + job_size - 1) / job_size;
+  if (pool == nullptr || job_count <= 1) {
+    cull_range(frustum, 0, m_count, visible);
+    return;
+  }
+
+  // every job fills its own list, appended in job order they stay sorted
+  m_job_results.resize(job_count);
+  std::latch done {static_cast<std::ptrdiff_t>(job_count)};
+  for (std::size_t job = 0; job < job_count; ++job) {
+    pool->submit(
+        [this, &frustum, &done, job]
+        {
+          auto& results = m_job_results[job];
+          results.clear();
+          cull_range(frustum,
+                     job * job_size,
+                     std::min(m_count, (job + 1) * job_size),
+                     results);
+          done.count_down();
+        });
+  }
+  done.wait();
+  for (std::size_t job = 0; job < job_count; ++job) {
+    visible.insert(visible.end(),
+                   m_job_results[job].begin(),
+                   m_job_results[job].end());
+  }
+}
+
+std::array<glm::vec4, 6> vktut::scene::frustum_culler::planes(
+    const glm::mat4& clip)
+{
+  // glm is column major, so row i is m[0][i], m[1][i], ...
+  glm::mat4 transposed = glm::transpose(clip);
+  std::array frustum = {
+      transposed[3] + transposed[0],
+      transposed[3] - transposed[0],
+      transposed[3] + transposed[1],
+      transposed[3] - transposed[1],
+      // depth runs from 0 to 1, so the near plane is just the z row
+      transposed[2],
+      transposed[3] - transposed[2],
+  };
+  for (auto& plane : frustum) {
+    plane /= glm::length(glm::vec3 {plane});
+  }
+  return frustum;
+}
+
+void vktut::scene::frustum_culler::cull_range(
+    const std::array<glm::vec4, 6>& frustum,
+    std::size_t first,
+    std::size_t last,
+    std::vector<object>& visible) const
+{
+  // first is always a whole batch in, and the padding past m_count never
+  // passes, so the last batch can be tested whole
+  for (std::size_t batch = first; batch < last; batch += batch_size) {
+#ifdef __AVX2__
+    __m256 center_x = _mm256_loadu_ps(&m_center_x[batch]);
+    __m256 center_y = _mm256_loadu_ps(&m_center_y[batch]);
+    __m256 center_z = _mm256_loadu_ps(&m_center_z[batch]);
+    __m256 negative_radius =
+        _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&m_radius[batch]));
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (const auto& plane : frustum) {
+      __m256 distance = _mm256_add_ps(
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), center_x),
+                        _mm256_mul_ps(_mm256_set1_ps(plane.y), center_y)),
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), center_z),
+                        _mm256_set1_ps(plane.w)));
+      inside = _mm256_and_ps(
+          inside, _mm256_cmp_ps(distance, negative_radius, _CMP_GE_OQ));
+    }
+    auto mask = static_cast<unsigned>(_mm256_movemask_ps(inside));
+#else
+    // the same batch as fixed width loops, which compilers vectorize with
+    // whatever the target has
+    std::array<float, batch_size> nearest {};
+    nearest.fill(std::numeric_limits<float>::max());
+    for (const auto& plane : frustum) {
+      for (std::size_t lane = 0; lane < batch_size; ++lane) {
+        float distance = plane.x * m_center_x[batch + lane]
+            + plane.y * m_center_y[batch + lane]
+            + plane.z * m_center_z[batch + lane] + plane.w
+            + m_radius[batch + lane];
+        nearest[lane] = std::min(nearest[lane], distance);
+      }
+    }
+    unsigned mask = 0;
+    for (std::size_t lane = 0; lane < batch_size; ++lane) {
+      mask |= nearest[lane] >= 0.0F ? 1U << lane : 0U;
+    }
+#endif
+    while (mask != 0) {
+      visible.push_back(static_cast<object>(batch + std::countr_zero(mask)));
+      mask &= mask - 1;
+    }
+  }
+}
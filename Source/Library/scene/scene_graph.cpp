@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "vktut/scene/scene_graph.hpp"
+
+vktut::scene::scene_graph::node vktut::scene::scene_graph::add_node(
+    node parent, glm::vec3 translation, glm::quat rotation, glm::vec3 scale)
+{
+  auto added = static_cast<node>(m_parents.size());
+  if (parent != no_parent && parent >= added) {
+    throw std::runtime_error {"scene node parent does not exist!"};
+  }
+  std::uint32_t depth = parent == no_parent ? 0 : m_depths[parent] + 1;
+  m_max_depth = std::max(m_max_depth, depth);
+
+  m_parents.push_back(parent);
+  m_depths.push_back(depth);
+  m_translation_x.push_back(translation.x);
+  m_translation_y.push_back(translation.y);
+  m_translation_z.push_back(translation.z);
+  rotation = glm::normalize(rotation);
+  m_rotation_x.push_back(rotation.x);
+  m_rotation_y.push_back(rotation.y);
+  m_rotation_z.push_back(rotation.z);
+  m_rotation_w.push_back(rotation.w);
+  m_scale_x.push_back(scale.x);
+  m_scale_y.push_back(scale.y);
+  m_scale_z.push_back(scale.z);
+  for (auto& element : m_world) {
+    element.push_back(0.0F);
+  }
+  m_dirty.push_back(0);
+  m_changed.push_back(0);
+  mark_dirty(added);
+  return added;
+}
+
+void vktut::scene::scene_graph::set_translation(node target,
+                                                glm::vec3 translation)
+{
+  m_translation_x[target] = translation.x;
+  m_translation_y[target] = translation.y;
+  m_translation_z[target] = translation.z;
+  mark_dirty(target);
+}
+
+void vktut::scene::scene_graph::set_rotation(node target, glm::quat rotation)
+{
+  rotation = glm::normalize(rotation);
+  m_rotation_x[target] = rotation.x;
+  m_rotation_y[target] = rotation.y;
+  m_rotation_z[target] = rotation.z;
+  m_rotation_w[target] = rotation.w;
+  mark_dirty(target);
+}
+
+void vktut::scene::scene_graph::set_scale(node target, glm::vec3 scale)
+{
+  m_scale_x[target] = scale.x;
+  m_scale_y[target] = scale.y;
+  m_scale_z[target] = scale.z;
+  mark_dirty(target);
+}
+
+std::size_t vktut::scene::scene_graph::size() const
+{
+  return m_parents.size();
+}
+
+vktut::scene::scene_graph::node vktut::scene::scene_graph::parent(
+    node target) const
+{
+  return m_parents[target];
+}
+
+glm::mat4 vktut::scene::scene_graph::world(node target) const
+{
+  glm::mat4 world {1.0F};
+  for (glm::length_t row = 0; row < 3; ++row) {
+    for (glm::length_t column = 0; column < 4; ++column) {
+      world[column][row] =
+          m_world[static_cast<std::size_t>(row * 4 + column)][target];
+    }
+  }
+  return world;
+}
+
+std::size_t vktut::scene::scene_graph::update()
+{
+  if (!m_any_dirty) {
+    return 0;
+  }
+  ++m_generation;
+
+  // parents come first, so a single forward pass carries every change down
+  // through its whole subtree
+  std::size_t node_count = m_parents.size();
+  for (std::size_t i = 0; i < node_count; ++i) {
+    node parent = m_parents[i];
+    if (parent != no_parent && m_dirty[parent] != 0) {
+      m_dirty[i] = 1;
+    }
+  }
+
+  // a counting sort by depth. nodes in one bucket never depend on each other,
+  // only on the finished buckets above them
+  m_depth_offsets.assign(m_max_depth + 2, 0);
+  for (std::size_t i = 0; i < node_count; ++i) {
+    if (m_dirty[i] != 0) {
+      ++m_depth_offsets[m_depths[i] + 1];
+    }
+  }
+  for (std::size_t depth = 1; depth < m_depth_offsets.size(); ++depth) {
+    m_depth_offsets[depth] += m_depth_offsets[depth - 1];
+  }
+  std::size_t dirty_count = m_depth_offsets.back();
+  m_update_order.resize(dirty_count);
+  m_depth_cursors.assign(m_depth_offsets.begin(), m_depth_offsets.end() - 1);
+  for (std::size_t i = 0; i < node_count; ++i) {
+    if (m_dirty[i] != 0) {
+      m_update_order[m_depth_cursors[m_depths[i]]++] = static_cast<node>(i);
+    }
+  }
+
+  std::span<const node> order = m_update_order;
+  for (std::size_t depth = 0; depth + 1 < m_depth_offsets.size(); ++depth) {
+    std::size_t end = m_depth_offsets[depth + 1];
+    for (std::size_t first = m_depth_offsets[depth]; first < end;
+         first += batch_size)
+    {
+      update_batch(order.subspan(first, std::min(batch_size, end - first)));
+    }
+  }
+
+  std::fill(m_dirty.begin(), m_dirty.end(), 0);
+  m_any_dirty = false;
+  return dirty_count;
+}
+
+void vktut::scene::scene_graph::write_instances(
+    std::span<std::byte> instances, std::uint64_t& written_generation) const
+{
+  std::size_t node_count = m_parents.size();
+  if (instances.size() < node_count * instance_stride) {
+    throw std::runtime_error {"instance buffer is too small for the scene!"};
+  }
+  if (written_generation == m_generation) {
+    return;
+  }
+
+  std::array<float, 12> matrix {};
+  for (std::size_t i = 0; i < node_count; ++i) {
+    if (m_changed[i] <= written_generation) {
+      continue;
+    }
+    for (std::size_t element = 0; element < matrix.size(); ++element) {
+      matrix[element] = m_world[element][i];
+    }
+    std::memcpy(
+        &instances[i * instance_stride], matrix.data(), instance_stride);
+  }
+  written_generation = m_generation;
+}
+
+void vktut::scene::scene_graph::mark_dirty(node target)
+{
+  m_dirty[target] = 1;
+  m_any_dirty = true;
+}
+
+void vktut::scene::scene_graph::update_batch(std::span<const node> nodes)
+{
+  // lanes past nodes.size() stay zero and are never stored. every loop below
+  // runs a fixed batch_size times over contiguous lanes, which the compiler
+  // turns into straight simd code
+  using lanes = std::array<float, batch_size>;
+  lanes tx {}, ty {}, tz {};
+  lanes qx {}, qy {}, qz {}, qw {};
+  lanes sx {}, sy {}, sz {};
+  std::array<lanes, 12> parent {};
+  for (std::size_t lane = 0; lane < nodes.size(); ++lane) {
+    node current = nodes[lane];
+    tx[lane] = m_translation_x[current];
+    ty[lane] = m_translation_y[current];
+    tz[lane] = m_translation_z[current];
+    qx[lane] = m_rotation_x[current];
+    qy[lane] = m_rotation_y[current];
+    qz[lane] = m_rotation_z[current];
+    qw[lane] = m_rotation_w[current];
+    sx[lane] = m_scale_x[current];
+    sy[lane] = m_scale_y[current];
+    sz[lane] = m_scale_z[current];
+
+    node parent_node = m_parents[current];
+    for (std::size_t element = 0; element < parent.size(); ++element) {
+      // roots hang off the identity
+      parent[element][lane] = parent_node == no_parent
+          ? (element == 0 || element == 5 || element == 10 ? 1.0F : 0.0F)
+          : m_world[element][parent_node];
+    }
+  }
+
+  // translation * rotation * scale
+  std::array<lanes, 12> local {};
+  for (std::size_t lane = 0; lane < batch_size; ++lane) {
+    float xx = qx[lane] * qx[lane];
+    float yy = qy[lane] * qy[lane];
+    float zz = qz[lane] * qz[lane];
+    float xy = qx[lane] * qy[lane];
+    float xz = qx[lane] * qz[lane];
+    float yz = qy[lane] * qz[lane];
+    float wx = qw[lane] * qx[lane];
+    float wy = qw[lane] * qy[lane];
+    float wz = qw[lane] * qz[lane];
+
+    local[0][lane] = (1.0F - 2.0F * (yy + zz)) * sx[lane];
+    local[1][lane] = 2.0F * (xy - wz) * sy[lane];
+    local[2][lane] = 2.0F * (xz + wy) * sz[lane];
+    local[3][lane] = tx[lane];
+    local[4][lane] = 2.0F * (xy + wz) * sx[lane];
+    local[5][lane] = (1.0F - 2.0F * (xx + zz)) * sy[lane];
+    local[6][lane] = 2.0F * (yz - wx) * sz[lane];
+    local[7][lane] = ty[lane];
+    local[8][lane] = 2.0F * (xz - wy) * sx[lane];
+    local[9][lane] = 2.0F * (yz + wx) * sy[lane];
+    local[10][lane] = (1.0F - 2.0F * (xx + yy)) * sz[lane];
+    local[11][lane] = tz[lane];
+  }
+
+  // parent * local, both affine so the implicit bottom row is 0 0 0 1
+  std::array<lanes, 12> world {};
+  for (std::size_t row = 0; row < 3; ++row) {
+    for (std::size_t column = 0; column < 4; ++column) {
+      const auto& p0 = parent[row * 4];
+      const auto& p1 = parent[row * 4 + 1];
+      const auto& p2 = parent[row * 4 + 2];
+      const auto& p3 = parent[row * 4 + 3];
+      const auto& l0 = local[column];
+      const auto& l1 = local[4 + column];
+      const auto& l2 = local[8 + column];
+      auto& result = world[row * 4 + column];
+      for (std::size_t lane = 0; lane < batch_size; ++lane) {
+        result[lane] = p0[lane] * l0[lane] + p1[lane] * l1[lane]
+            + p2[lane] * l2[lane] + (column == 3 ? p3[lane] : 0.0F);
+      }
+    }
+  }
+
+  for (std::size_t lane = 0; lane < nodes.size(); ++lane) {
+    node current = nodes[lane];
+    for (std::size_t element = 0; element < world.size(); ++element) {
+      m_world[element][current] = world[element][lane];
+    }
+    m_changed[current] = m_generation;
+  }
+}
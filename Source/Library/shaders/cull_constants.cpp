@@ -0,0 +1,19 @@
+#include <cstddef>
+
+#include "vktut/shaders/cull_constants.hpp"
+
+static_assert(offsetof(vktut::shaders::cull_constants, meshlet_count) == 0,
+              "cull_meshlets.comp reads the meshlet count at offset 0");
+static_assert(offsetof(vktut::shaders::cull_constants, render_extent) == 8,
+              "cull_meshlets.comp reads the render extent at offset 8");
+static_assert(sizeof(vktut::shaders::cull_constants) == 16,
+              "cull_meshlets.comp expects 16 bytes of push constants");
+
+vktut::shaders::cull_constants vktut::shaders::cull_constants::from(
+    std::uint32_t meshlet_count, glm::uvec2 render_extent)
+{
+  return cull_constants {
+      .meshlet_count = meshlet_count,
+      .render_extent = render_extent,
+  };
+}
@@ -0,0 +1,60 @@
+#include <cstddef>
+
+#include "vktut/shaders/cull_descriptors.hpp"
+
+std::array<VkDescriptorSetLayoutBinding, 5>
+vktut::shaders::cull_descriptors::layout_bindings()
+{
+  std::array types = {
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+      VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+  };
+
+  std::array<VkDescriptorSetLayoutBinding, 5> bindings {};
+  for (std::uint32_t i = 0; i < bindings.size(); ++i) {
+    bindings[i] = VkDescriptorSetLayoutBinding {
+        .binding = i,
+        .descriptorType = types[i],
+        .descriptorCount = 1,
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .pImmutableSamplers = nullptr,
+    };
+  }
+  return bindings;
+}
+
+std::array<VkDescriptorUpdateTemplateEntry, 5>
+vktut::shaders::cull_descriptors::template_entries()
+{
+  auto bindings = layout_bindings();
+  std::array offsets = {
+      offsetof(cull_descriptors, meshlets),
+      offsetof(cull_descriptors, draw_commands),
+      offsetof(cull_descriptors, draw_count),
+      offsetof(cull_descriptors, uniform_buffer),
+      offsetof(cull_descriptors, depth_pyramid),
+  };
+  std::array strides = {
+      sizeof(VkDescriptorBufferInfo),
+      sizeof(VkDescriptorBufferInfo),
+      sizeof(VkDescriptorBufferInfo),
+      sizeof(VkDescriptorBufferInfo),
+      sizeof(VkDescriptorImageInfo),
+  };
+
+  std::array<VkDescriptorUpdateTemplateEntry, 5> entries {};
+  for (std::uint32_t i = 0; i < entries.size(); ++i) {
+    entries[i] = VkDescriptorUpdateTemplateEntry {
+        .dstBinding = i,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = bindings[i].descriptorType,
+        .offset = offsets[i],
+        .stride = strides[i],
+    };
+  }
+  return entries;
+}
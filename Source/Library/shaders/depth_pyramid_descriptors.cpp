@@ -0,0 +1,47 @@
+#include <cstddef>
+
+#include "vktut/shaders/depth_pyramid_descriptors.hpp"
+
+std::array<VkDescriptorSetLayoutBinding, 2>
+vktut::shaders::depth_pyramid_descriptors::layout_bindings()
+{
+  return {
+      VkDescriptorSetLayoutBinding {
+          .binding = 0,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+          .pImmutableSamplers = nullptr,
+      },
+      VkDescriptorSetLayoutBinding {
+          .binding = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+          .pImmutableSamplers = nullptr,
+      },
+  };
+}
+
+std::array<VkDescriptorUpdateTemplateEntry, 2>
+vktut::shaders::depth_pyramid_descriptors::template_entries()
+{
+  return {
+      VkDescriptorUpdateTemplateEntry {
+          .dstBinding = 0,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .offset = offsetof(depth_pyramid_descriptors, source),
+          .stride = sizeof(VkDescriptorImageInfo),
+      },
+      VkDescriptorUpdateTemplateEntry {
+          .dstBinding = 1,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+          .offset = offsetof(depth_pyramid_descriptors, destination),
+          .stride = sizeof(VkDescriptorImageInfo),
+      },
+  };
+}
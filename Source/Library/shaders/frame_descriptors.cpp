@@ -0,0 +1,34 @@
+#include <cstddef>
+
+#include "vktut/shaders/frame_descriptors.hpp"
+
+std::array<VkDescriptorUpdateTemplateEntry, 3>
+vktut::shaders::frame_descriptors::template_entries()
+{
+  return {
+      VkDescriptorUpdateTemplateEntry {
+          .dstBinding = 0,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+          .offset = offsetof(frame_descriptors, uniform_buffer),
+          .stride = sizeof(VkDescriptorBufferInfo),
+      },
+      VkDescriptorUpdateTemplateEntry {
+          .dstBinding = 1,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .offset = offsetof(frame_descriptors, texture_sampler),
+          .stride = sizeof(VkDescriptorImageInfo),
+      },
+      VkDescriptorUpdateTemplateEntry {
+          .dstBinding = 2,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .offset = offsetof(frame_descriptors, instances),
+          .stride = sizeof(VkDescriptorBufferInfo),
+      },
+  };
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+#include "vktut/shaders/material.hpp"
+
+#include <embedded_spirv.hpp>
+#include <vktut/shaders/vertex.hpp>
+
+std::array<VkSpecializationMapEntry, 3>
+vktut::shaders::fragment_constants::map_entries()
+{
+  std::array map_entries = {
+      VkSpecializationMapEntry {
+          .constantID = 0,
+          .offset = offsetof(fragment_constants, base_color_r),
+          .size = sizeof(float),
+      },
+      VkSpecializationMapEntry {
+          .constantID = 1,
+          .offset = offsetof(fragment_constants, base_color_g),
+          .size = sizeof(float),
+      },
+      VkSpecializationMapEntry {
+          .constantID = 2,
+          .offset = offsetof(fragment_constants, base_color_b),
+          .size = sizeof(float),
+      },
+  };
+
+  return map_entries;
+}
+
+std::span<const std::uint32_t> vktut::shaders::material::vertex_spirv() const
+{
+  if (textured && vertex_colors) {
+    return embedded_spirv::basic_vert_textured_colored;
+  }
+  if (textured) {
+    return embedded_spirv::basic_vert_textured;
+  }
+  if (vertex_colors) {
+    return embedded_spirv::basic_vert_colored;
+  }
+  return embedded_spirv::basic_vert;
+}
+
+std::span<const std::uint32_t> vktut::shaders::material::fragment_spirv() const
+{
+  if (textured && vertex_colors && bindless_textures) {
+    return embedded_spirv::basic_frag_textured_colored_bindless;
+  }
+  if (textured && bindless_textures) {
+    return embedded_spirv::basic_frag_textured_bindless;
+  }
+  if (textured && vertex_colors) {
+    return embedded_spirv::basic_frag_textured_colored;
+  }
+  if (textured) {
+    return embedded_spirv::basic_frag_textured;
+  }
+  if (vertex_colors) {
+    return embedded_spirv::basic_frag_colored;
+  }
+  return embedded_spirv::basic_frag;
+}
+
+vktut::shaders::fragment_constants
+vktut::shaders::material::specialization() const
+{
+  return fragment_constants {
+      .base_color_r = base_color.r,
+      .base_color_g = base_color.g,
+      .base_color_b = base_color.b,
+  };
+}
+
+std::vector<VkVertexInputAttributeDescription>
+vktut::shaders::material::attribute_descriptions() const
+{
+  auto all_descriptions = vertex::attribute_descriptions();
+
+  std::vector<VkVertexInputAttributeDescription> descriptions;
+  descriptions.reserve(all_descriptions.size());
+  std::copy_if(all_descriptions.begin(),
+               all_descriptions.end(),
+               std::back_inserter(descriptions),
+               [this](const auto& description)
+               {
+                 // locations as declared in basic.vert
+                 switch (description.location) {
+                   case 1:
+                     return vertex_colors;
+                   case 2:
+                     return textured;
+                   default:
+                     return true;
+                 }
+               });
+
+  return descriptions;
+}
@@ -0,0 +1,16 @@
+#include <cstddef>
+
+#include "vktut/shaders/push_constants.hpp"
+
+static_assert(offsetof(vktut::shaders::push_constants, texture_index) == 0,
+              "basic.frag reads the texture index at offset 0");
+static_assert(sizeof(vktut::shaders::push_constants) <= 128,
+              "push constants must fit the guaranteed minimum size");
+
+vktut::shaders::push_constants vktut::shaders::push_constants::from(
+    std::uint32_t texture_index)
+{
+  return push_constants {
+      .texture_index = texture_index,
+  };
+}
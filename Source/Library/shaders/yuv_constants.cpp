@@ -0,0 +1,27 @@
+#include <cstddef>
+
+#include "vktut/shaders/yuv_constants.hpp"
+
+static_assert(offsetof(vktut::shaders::yuv_constants, texel_to_uv) == 8,
+              "rgb_to_yuv.comp reads the uv scale at offset 8");
+static_assert(offsetof(vktut::shaders::yuv_constants, interleaved_chroma)
+                  == 16,
+              "rgb_to_yuv.comp reads the chroma layout at offset 16");
+static_assert(sizeof(vktut::shaders::yuv_constants) == 24,
+              "rgb_to_yuv.comp expects 24 bytes of push constants");
+
+vktut::shaders::yuv_constants vktut::shaders::yuv_constants::from(
+    glm::uvec2 output_extent,
+    glm::uvec2 render_extent,
+    glm::uvec2 source_extent,
+    bool interleaved_chroma,
+    bool srgb_source)
+{
+  return yuv_constants {
+      .output_extent = output_extent,
+      .texel_to_uv = glm::vec2 {render_extent}
+          / (glm::vec2 {output_extent} * glm::vec2 {source_extent}),
+      .interleaved_chroma = interleaved_chroma ? 1U : 0U,
+      .srgb_source = srgb_source ? 1U : 0U,
+  };
+}
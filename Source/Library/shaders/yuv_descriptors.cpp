@@ -0,0 +1,47 @@
+#include <cstddef>
+
+#include "vktut/shaders/yuv_descriptors.hpp"
+
+std::array<VkDescriptorSetLayoutBinding, 2>
+vktut::shaders::yuv_descriptors::layout_bindings()
+{
+  return {
+      VkDescriptorSetLayoutBinding {
+          .binding = 0,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+          .pImmutableSamplers = nullptr,
+      },
+      VkDescriptorSetLayoutBinding {
+          .binding = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+          .pImmutableSamplers = nullptr,
+      },
+  };
+}
+
+std::array<VkDescriptorUpdateTemplateEntry, 2>
+vktut::shaders::yuv_descriptors::template_entries()
+{
+  return {
+      VkDescriptorUpdateTemplateEntry {
+          .dstBinding = 0,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .offset = offsetof(yuv_descriptors, source),
+          .stride = sizeof(VkDescriptorImageInfo),
+      },
+      VkDescriptorUpdateTemplateEntry {
+          .dstBinding = 1,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .offset = offsetof(yuv_descriptors, frame),
+          .stride = sizeof(VkDescriptorBufferInfo),
+      },
+  };
+}
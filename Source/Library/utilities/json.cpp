@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+#include "vktut/utilities/json.hpp"
+
+vktut::utilities::json vktut::utilities::json::parse(std::string_view text)
+{
+  const auto* first = text.data();
+  const auto* last = text.data() + text.size();
+  auto parsed = parse_value(first, last, 0);
+  skip_whitespace(first, last);
+  if (first != last) {
+    throw std::runtime_error {"failed to parse json, trailing characters!"};
+  }
+  return parsed;
+}
+
+const vktut::utilities::json* vktut::utilities::json::find(
+    std::string_view key) const
+{
+  const auto* members = std::get_if<object>(&value);
+  if (members == nullptr) {
+    return nullptr;
+  }
+  auto found = std::find_if(members->begin(),
+                            members->end(),
+                            [key](const auto& member)
+                            { return member.first == key; });
+  return found != members->end() ? &found->second : nullptr;
+}
+
+const vktut::utilities::json& vktut::utilities::json::at(
+    std::string_view key) const
+{
+  const auto* member = find(key);
+  if (member == nullptr) {
+    throw std::runtime_error {"failed to find json member!"};
+  }
+  return *member;
+}
+
+const vktut::utilities::json& vktut::utilities::json::at(
+    std::size_t index) const
+{
+  const auto* elements = std::get_if<array>(&value);
+  if (elements == nullptr || index >= elements->size()) {
+    throw std::runtime_error {"failed to find json element!"};
+  }
+  return (*elements)[index];
+}
+
+std::size_t vktut::utilities::json::size() const
+{
+  if (const auto* elements = std::get_if<array>(&value)) {
+    return elements->size();
+  }
+  if (const auto* members = std::get_if<object>(&value)) {
+    return members->size();
+  }
+  return 0;
+}
+
+double vktut::utilities::json::number() const
+{
+  const auto* result = std::get_if<double>(&value);
+  if (result == nullptr) {
+    throw std::runtime_error {"failed to read json number!"};
+  }
+  return *result;
+}
+
+std::uint32_t vktut::utilities::json::index() const
+{
+  double result = number();
+  if (result < 0 || result > 4294967295.0 || std::floor(result) != result) {
+    throw std::runtime_error {"failed to read json index!"};
+  }
+  return static_cast<std::uint32_t>(result);
+}
+
+const std::string& vktut::utilities::json::string() const
+{
+  const auto* result = std::get_if<std::string>(&value);
+  if (result == nullptr) {
+    throw std::runtime_error {"failed to read json string!"};
+  }
+  return *result;
+}
+
+double vktut::utilities::json::number_or(std::string_view key,
+                                         double fallback) const
+{
+  const auto* member = find(key);
+  return member != nullptr ? member->number() : fallback;
+}
+
+std::uint32_t vktut::utilities::json::index_or(std::string_view key,
+                                               std::uint32_t fallback) const
+{
+  const auto* member = find(key);
+  return member != nullptr ? member->index() : fallback;
+}
+
+vktut::utilities::json vktut::utilities::json::parse_value(const char*& first,
+                                                           const char* last,
+                                                           std::size_t depth)
+{
+  skip_whitespace(first, last);
+  if (first == last) {
+    throw std::runtime_error {"failed to parse json, unexpected end!"};
+  }
+  if (depth >= max_depth) {
+    throw std::runtime_error {"failed to parse json, nested too deeply!"};
+  }
+
+  auto keyword = [&](std::string_view word)
+  {
+    if (static_cast<std::size_t>(last - first) < word.size()
+        || std::string_view {first, word.size()} != word)
+    {
+      throw std::runtime_error {"failed to parse json, unknown literal!"};
+    }
+    first += word.size();
+  };
+
+  switch (*first) {
+    case '{': {
+      ++first;
+      object members;
+      skip_whitespace(first, last);
+      if (first != last && *first == '}') {
+        ++first;
+        return json {std::move(members)};
+      }
+      while (true) {
+        skip_whitespace(first, last);
+        auto key = parse_string(first, last);
+        skip_whitespace(first, last);
+        expect(first, last, ':');
+        members.emplace_back(std::move(key),
+                             parse_value(first, last, depth + 1));
+        skip_whitespace(first, last);
+        if (first != last && *first == ',') {
+          ++first;
+          continue;
+        }
+        expect(first, last, '}');
+        return json {std::move(members)};
+      }
+    }
+    case '[': {
+      ++first;
+      array elements;
+      skip_whitespace(first, last);
+      if (first != last && *first == ']') {
+        ++first;
+        return json {std::move(elements)};
+      }
+      while (true) {
+        elements.push_back(parse_value(first, last, depth + 1));
+        skip_whitespace(first, last);
+        if (first != last && *first == ',') {
+          ++first;
+          continue;
+        }
+        expect(first, last, ']');
+        return json {std::move(elements)};
+      }
+    }
+    case '"':
+      return json {parse_string(first, last)};
+    case 't':
+      keyword("true");
+      return json {true};
+    case 'f':
+      keyword("false");
+      return json {false};
+    case 'n':
+      keyword("null");
+      return json {nullptr};
+    default: {
+      double number = 0;
+      auto [end, error] = std::from_chars(first, last, number);
+      if (error != std::errc {}) {
+        throw std::runtime_error {"failed to parse json number!"};
+      }
+      first = end;
+      return json {number};
+    }
+  }
+}
+
+std::string vktut::utilities::json::parse_string(const char*& first,
+                                                 const char* last)
+{
+  expect(first, last, '"');
+  std::string result;
+  while (first != last && *first != '"') {
+    if (*first != '\\') {
+      result.push_back(*first++);
+      continue;
+    }
+    if (++first == last) {
+      break;
+    }
+    switch (*first++) {
+      case '"':
+        result.push_back('"');
+        break;
+      case '\\':
+        result.push_back('\\');
+        break;
+      case '/':
+        result.push_back('/');
+        break;
+      case 'b':
+        result.push_back('\b');
+        break;
+      case 'f':
+        result.push_back('\f');
+        break;
+      case 'n':
+        result.push_back('\n');
+        break;
+      case 'r':
+        result.push_back('\r');
+        break;
+      case 't':
+        result.push_back('\t');
+        break;
+      case 'u': {
+        auto code_point = parse_hex(first, last);
+        // characters past the basic plane come as a surrogate pair
+        if (code_point >= 0xD800 && code_point < 0xDC00 && last - first >= 2
+            && first[0] == '\\' && first[1] == 'u')
+        {
+          first += 2;
+          auto low = parse_hex(first, last);
+          code_point = 0x10000 + ((code_point - 0xD800) << 10)
+              + (low - 0xDC00);
+        }
+        append_utf8(result, code_point);
+        break;
+      }
+      default:
+        throw std::runtime_error {"failed to parse json string escape!"};
+    }
+  }
+  expect(first, last, '"');
+  return result;
+}
+
+void vktut::utilities::json::append_utf8(std::string& out,
+                                         std::uint32_t code_point)
+{
+  if (code_point < 0x80) {
+    out.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+std::uint32_t vktut::utilities::json::parse_hex(const char*& first,
+                                                const char* last)
+{
+  std::uint32_t result = 0;
+  if (last - first < 4) {
+    throw std::runtime_error {"failed to parse json string escape!"};
+  }
+  auto [end, error] = std::from_chars(first, first + 4, result, 16);
+  if (error != std::errc {} || end != first + 4) {
+    throw std::runtime_error {"failed to parse json string escape!"};
+  }
+  first = end;
+  return result;
+}
+
+void vktut::utilities::json::skip_whitespace(const char*& first,
+                                             const char* last)
+{
+  while (first != last
+         && (*first == ' ' || *first == '\t' || *first == '\n'
+             || *first == '\r'))
+  {
+    ++first;
+  }
+}
+
+void vktut::utilities::json::expect(const char*& first,
+                                    const char* last,
+                                    char c)
+{
+  if (first == last || *first != c) {
+    throw std::runtime_error {"failed to parse json, unexpected character!"};
+  }
+  ++first;
+}
@@ -0,0 +1,197 @@
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "vktut/utilities/mapped_file.hpp"
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#ifdef _WIN32
+vktut::utilities::mapped_file::mapped_file(std::string_view file_name,
+                                           access_pattern pattern)
+    : m_data(nullptr)
+    , m_size(0)
+    , m_file_handle(INVALID_HANDLE_VALUE)
+    , m_mapping_handle(nullptr)
+{
+  DWORD flags = FILE_ATTRIBUTE_NORMAL;
+  if (pattern == access_pattern::sequential) {
+    flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+  } else if (pattern == access_pattern::random) {
+    flags |= FILE_FLAG_RANDOM_ACCESS;
+  }
+
+  m_file_handle = CreateFileA(std::string {file_name}.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              flags,
+                              nullptr);
+  if (m_file_handle == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error {"failed to open file!"};
+  }
+
+  LARGE_INTEGER file_size;
+  if (GetFileSizeEx(m_file_handle, &file_size) == 0) {
+    unmap();
+    throw std::runtime_error {"failed to query file size!"};
+  }
+  m_size = static_cast<std::size_t>(file_size.QuadPart);
+  // zero-length files cannot be mapped, they are exposed as an empty span
+  if (m_size == 0) {
+    return;
+  }
+
+  m_mapping_handle = CreateFileMappingA(
+      m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_mapping_handle == nullptr) {
+    unmap();
+    throw std::runtime_error {"failed to map file!"};
+  }
+
+  m_data = static_cast<const std::byte*>(
+      MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+  if (m_data == nullptr) {
+    unmap();
+    throw std::runtime_error {"failed to map file!"};
+  }
+}
+#else
+vktut::utilities::mapped_file::mapped_file(std::string_view file_name,
+                                           access_pattern pattern)
+    : m_data(nullptr)
+    , m_size(0)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+  int descriptor = open(std::string {file_name}.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    throw std::runtime_error {"failed to open file!"};
+  }
+
+  struct stat status = {};
+  if (fstat(descriptor, &status) != 0) {
+    close(descriptor);
+    throw std::runtime_error {"failed to query file size!"};
+  }
+  m_size = static_cast<std::size_t>(status.st_size);
+  // zero-length files cannot be mapped, they are exposed as an empty span
+  if (m_size == 0) {
+    close(descriptor);
+    return;
+  }
+
+  void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  // the mapping keeps its own reference to the file
+  close(descriptor);
+  if (data == MAP_FAILED) {
+    m_size = 0;
+    throw std::runtime_error {"failed to map file!"};
+  }
+  m_data = static_cast<const std::byte*>(data);
+
+  advise(pattern);
+}
+#endif
+
+vktut::utilities::mapped_file::~mapped_file()
+{
+  unmap();
+}
+
+vktut::utilities::mapped_file::mapped_file(mapped_file&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+#ifdef _WIN32
+    , m_file_handle(std::exchange(other.m_file_handle, INVALID_HANDLE_VALUE))
+    , m_mapping_handle(std::exchange(other.m_mapping_handle, nullptr))
+#endif
+{
+}
+
+vktut::utilities::mapped_file& vktut::utilities::mapped_file::operator=(
+    mapped_file&& other) noexcept
+{
+  if (this != &other) {
+    unmap();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+    m_file_handle = std::exchange(other.m_file_handle, INVALID_HANDLE_VALUE);
+    m_mapping_handle = std::exchange(other.m_mapping_handle, nullptr);
+#endif
+  }
+  return *this;
+}
+
+std::span<const std::byte> vktut::utilities::mapped_file::bytes() const
+{
+  return {m_data, m_data == nullptr ? 0 : m_size};
+}
+
+std::size_t vktut::utilities::mapped_file::size() const
+{
+  return m_size;
+}
+
+void vktut::utilities::mapped_file::advise(access_pattern pattern)
+{
+#ifdef _WIN32
+  // windows only takes access hints when the file is opened
+  (void)pattern;
+#else
+  if (m_data == nullptr) {
+    return;
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  auto* data = const_cast<std::byte*>(m_data);
+  // the hints are best-effort, a failure here doesn't affect correctness
+  switch (pattern) {
+    case access_pattern::normal:
+      madvise(data, m_size, MADV_NORMAL);
+      break;
+    case access_pattern::sequential:
+      madvise(data, m_size, MADV_SEQUENTIAL);
+      // sequential readers touch every page, so start reading ahead right away
+      madvise(data, m_size, MADV_WILLNEED);
+      break;
+    case access_pattern::random:
+      madvise(data, m_size, MADV_RANDOM);
+      break;
+  }
+#endif
+}
+
+void vktut::utilities::mapped_file::unmap()
+{
+#ifdef _WIN32
+  if (m_data != nullptr) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping_handle != nullptr) {
+    CloseHandle(m_mapping_handle);
+  }
+  if (m_file_handle != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_file_handle);
+  }
+  m_mapping_handle = nullptr;
+  m_file_handle = INVALID_HANDLE_VALUE;
+#else
+  if (m_data != nullptr) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    munmap(const_cast<std::byte*>(m_data), m_size);
+  }
+#endif
+  m_data = nullptr;
+  m_size = 0;
+}
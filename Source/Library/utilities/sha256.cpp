@@ -0,0 +1,107 @@
+#include <bit>
+#include <cstring>
+
+#include "vktut/utilities/sha256.hpp"
+
+vktut::utilities::sha256::digest vktut::utilities::sha256::hash(
+    std::span<const std::byte> bytes)
+{
+  std::array<std::uint32_t, 8> state = {
+      0x6a09e667,
+      0xbb67ae85,
+      0x3c6ef372,
+      0xa54ff53a,
+      0x510e527f,
+      0x9b05688c,
+      0x1f83d9ab,
+      0x5be0cd19,
+  };
+
+  constexpr std::size_t block_size = 64;
+  std::size_t full_blocks = bytes.size() / block_size;
+  for (std::size_t i = 0; i < full_blocks; ++i) {
+    compress(state, bytes.data() + i * block_size);
+  }
+
+  // the rest, a one bit, zeros and the length in bits fill one or two more
+  // blocks
+  std::array<std::byte, 2 * block_size> tail {};
+  std::size_t rest = bytes.size() - full_blocks * block_size;
+  if (rest != 0) {
+    std::memcpy(tail.data(), bytes.data() + full_blocks * block_size, rest);
+  }
+  tail[rest] = std::byte {0x80};
+  std::size_t tail_size = rest + 9 <= block_size ? block_size : 2 * block_size;
+  std::uint64_t bit_count = static_cast<std::uint64_t>(bytes.size()) * 8;
+  for (std::size_t i = 0; i < 8; ++i) {
+    tail[tail_size - 1 - i] = static_cast<std::byte>(bit_count >> (8 * i));
+  }
+  for (std::size_t offset = 0; offset < tail_size; offset += block_size) {
+    compress(state, tail.data() + offset);
+  }
+
+  digest result {};
+  for (std::size_t i = 0; i < state.size(); ++i) {
+    for (std::size_t j = 0; j < 4; ++j) {
+      result[4 * i + j] = static_cast<std::uint8_t>(state[i] >> (24 - 8 * j));
+    }
+  }
+  return result;
+}
+
+void vktut::utilities::sha256::compress(std::array<std::uint32_t, 8>& state,
+                                        const std::byte* block)
+{
+  static constexpr std::array<std::uint32_t, 64> round_constants = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+      0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+      0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+      0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+      0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+      0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+      0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+  };
+
+  std::array<std::uint32_t, 64> schedule {};
+  for (std::size_t i = 0; i < 16; ++i) {
+    // big endian words
+    schedule[i] = std::to_integer<std::uint32_t>(block[4 * i]) << 24U
+        | std::to_integer<std::uint32_t>(block[4 * i + 1]) << 16U
+        | std::to_integer<std::uint32_t>(block[4 * i + 2]) << 8U
+        | std::to_integer<std::uint32_t>(block[4 * i + 3]);
+  }
+  for (std::size_t i = 16; i < 64; ++i) {
+    auto s0 = std::rotr(schedule[i - 15], 7) ^ std::rotr(schedule[i - 15], 18)
+        ^ (schedule[i - 15] >> 3U);
+    auto s1 = std::rotr(schedule[i - 2], 17) ^ std::rotr(schedule[i - 2], 19)
+        ^ (schedule[i - 2] >> 10U);
+    schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+  }
+
+  auto [a, b, c, d, e, f, g, h] = state;
+  for (std::size_t i = 0; i < 64; ++i) {
+    auto s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+    auto choice = (e & f) ^ (~e & g);
+    auto t1 = h + s1 + choice + round_constants[i] + schedule[i];
+    auto s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+    auto majority = (a & b) ^ (a & c) ^ (b & c);
+    auto t2 = s0 + majority;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  std::array<std::uint32_t, 8> working = {a, b, c, d, e, f, g, h};
+  for (std::size_t i = 0; i < state.size(); ++i) {
+    state[i] += working[i];
+  }
+}
@@ -0,0 +1,44 @@
+#include "vktut/utilities/span_streambuf.hpp"
+
+vktut::utilities::span_streambuf::span_streambuf(
+    std::span<const std::byte> bytes)
+{
+  // the get area is never written through, std::streambuf just wants char*
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-type-const-cast)
+  auto* begin = const_cast<char*>(reinterpret_cast<const char*>(bytes.data()));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  setg(begin, begin, begin + bytes.size());
+}
+
+std::streambuf::pos_type vktut::utilities::span_streambuf::seekoff(
+    off_type offset,
+    std::ios_base::seekdir direction,
+    std::ios_base::openmode which)
+{
+  if ((which & std::ios_base::in) == 0) {
+    return pos_type {off_type {-1}};
+  }
+
+  char* base = nullptr;
+  if (direction == std::ios_base::beg) {
+    base = eback();
+  } else if (direction == std::ios_base::cur) {
+    base = gptr();
+  } else {
+    base = egptr();
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  char* target = base + offset;
+  if (target < eback() || target > egptr()) {
+    return pos_type {off_type {-1}};
+  }
+  setg(eback(), target, egptr());
+  return pos_type {target - eback()};
+}
+
+std::streambuf::pos_type vktut::utilities::span_streambuf::seekpos(
+    pos_type position, std::ios_base::openmode which)
+{
+  return seekoff(off_type {position}, std::ios_base::beg, which);
+}
@@ -0,0 +1,50 @@
+#include <utility>
+
+#include "vktut/utilities/thread_pool.hpp"
+
+vktut::utilities::thread_pool::thread_pool(std::size_t thread_count)
+{
+  m_workers.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    m_workers.emplace_back([this] { work(); });
+  }
+}
+
+vktut::utilities::thread_pool::~thread_pool()
+{
+  {
+    std::lock_guard lock {m_mutex};
+    m_stopping = true;
+  }
+  m_job_available.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void vktut::utilities::thread_pool::submit(std::function<void()> job)
+{
+  {
+    std::lock_guard lock {m_mutex};
+    m_jobs.push_back(std::move(job));
+  }
+  m_job_available.notify_one();
+}
+
+void vktut::utilities::thread_pool::work()
+{
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock lock {m_mutex};
+      m_job_available.wait(lock,
+                           [this] { return m_stopping || !m_jobs.empty(); });
+      if (m_jobs.empty()) {
+        return;
+      }
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    job();
+  }
+}
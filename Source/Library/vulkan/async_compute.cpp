@@ -0,0 +1,191 @@
+#include <stdexcept>
+
+#include "vktut/vulkan/async_compute.hpp"
+
+vktut::vulkan::async_compute::async_compute(VkDevice device,
+                                            std::uint32_t family,
+                                            std::uint32_t queue_index,
+                                            std::uint32_t graphics_family,
+                                            std::size_t frames_in_flight,
+                                            std::size_t pass_count)
+    : m_device(device)
+    , m_queue(nullptr)
+    , m_family(family)
+    , m_graphics_family(graphics_family)
+    , m_command_pool(nullptr)
+    , m_pass_count(pass_count)
+    , m_slots(frames_in_flight * pass_count)
+{
+  vkGetDeviceQueue(m_device, m_family, queue_index, &m_queue);
+
+  VkCommandPoolCreateInfo pool_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = m_family,
+  };
+  if (vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create compute command pool!"};
+  }
+
+  VkCommandBufferAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = m_command_pool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+  VkSemaphoreCreateInfo semaphore_info = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+  };
+  for (auto& slot : m_slots) {
+    slot = {};
+    if (vkAllocateCommandBuffers(m_device, &allocate_info, &slot.command_buffer)
+            != VK_SUCCESS
+        || vkCreateSemaphore(m_device, &semaphore_info, nullptr, &slot.ready)
+            != VK_SUCCESS
+        || vkCreateSemaphore(m_device, &semaphore_info, nullptr, &slot.done)
+            != VK_SUCCESS)
+    {
+      throw std::runtime_error {"failed to create compute pass objects!"};
+    }
+  }
+}
+
+vktut::vulkan::async_compute::~async_compute()
+{
+  // the device has to be idle, destroying the pool frees the command buffers
+  for (const auto& slot : m_slots) {
+    vkDestroySemaphore(m_device, slot.ready, nullptr);
+    vkDestroySemaphore(m_device, slot.done, nullptr);
+  }
+  vkDestroyCommandPool(m_device, m_command_pool, nullptr);
+}
+
+std::uint32_t vktut::vulkan::async_compute::family() const
+{
+  return m_family;
+}
+
+VkCommandBuffer vktut::vulkan::async_compute::begin(std::size_t frame_index,
+                                                    std::size_t pass)
+{
+  VkCommandBuffer command_buffer = slot(frame_index, pass).command_buffer;
+  vkResetCommandBuffer(command_buffer, 0);
+  VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to begin recording compute pass!"};
+  }
+  return command_buffer;
+}
+
+VkSemaphore vktut::vulkan::async_compute::ready(std::size_t frame_index,
+                                                std::size_t pass) const
+{
+  return slot(frame_index, pass).ready;
+}
+
+VkSemaphore vktut::vulkan::async_compute::done(std::size_t frame_index,
+                                               std::size_t pass) const
+{
+  return slot(frame_index, pass).done;
+}
+
+void vktut::vulkan::async_compute::submit(std::size_t frame_index,
+                                          std::size_t pass,
+                                          VkPipelineStageFlags wait_stage,
+                                          bool signal_done,
+                                          VkFence fence)
+{
+  const auto& pass_slot = slot(frame_index, pass);
+  if (vkEndCommandBuffer(pass_slot.command_buffer) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to record compute pass!"};
+  }
+
+  VkSubmitInfo submit_info = {
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .waitSemaphoreCount = 1,
+      .pWaitSemaphores = &pass_slot.ready,
+      .pWaitDstStageMask = &wait_stage,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &pass_slot.command_buffer,
+      .signalSemaphoreCount = signal_done ? 1U : 0U,
+      .pSignalSemaphores = &pass_slot.done,
+  };
+  if (vkQueueSubmit(m_queue, 1, &submit_info, fence) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to submit compute pass!"};
+  }
+}
+
+VkImageMemoryBarrier vktut::vulkan::async_compute::release(
+    VkImage image,
+    VkImageAspectFlags aspect,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout,
+    VkAccessFlags src_access,
+    bool to_compute) const
+{
+  auto barrier = transfer(image, aspect, old_layout, new_layout, to_compute);
+  barrier.srcAccessMask = src_access;
+  return barrier;
+}
+
+VkImageMemoryBarrier vktut::vulkan::async_compute::acquire(
+    VkImage image,
+    VkImageAspectFlags aspect,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout,
+    VkAccessFlags dst_access,
+    bool to_compute) const
+{
+  // within one family the release was an ordinary barrier that already
+  // changed the layout
+  if (m_family == m_graphics_family) {
+    old_layout = new_layout;
+  }
+  auto barrier = transfer(image, aspect, old_layout, new_layout, to_compute);
+  barrier.dstAccessMask = dst_access;
+  return barrier;
+}
+
+VkImageMemoryBarrier vktut::vulkan::async_compute::transfer(
+    VkImage image,
+    VkImageAspectFlags aspect,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout,
+    bool to_compute) const
+{
+  // a second queue of the graphics family needs no ownership transfer
+  bool shared_family = m_family == m_graphics_family;
+  std::uint32_t source = to_compute ? m_graphics_family : m_family;
+  std::uint32_t destination = to_compute ? m_family : m_graphics_family;
+  return VkImageMemoryBarrier {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = 0,
+      .dstAccessMask = 0,
+      .oldLayout = old_layout,
+      .newLayout = new_layout,
+      .srcQueueFamilyIndex = shared_family ? VK_QUEUE_FAMILY_IGNORED : source,
+      .dstQueueFamilyIndex =
+          shared_family ? VK_QUEUE_FAMILY_IGNORED : destination,
+      .image = image,
+      .subresourceRange =
+          {
+              .aspectMask = aspect,
+              .baseMipLevel = 0,
+              .levelCount = 1,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+  };
+}
+
+const vktut::vulkan::async_compute::pass_slot&
+vktut::vulkan::async_compute::slot(std::size_t frame_index,
+                                   std::size_t pass) const
+{
+  return m_slots[frame_index * m_pass_count + pass];
+}
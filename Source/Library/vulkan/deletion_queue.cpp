@@ -0,0 +1,48 @@
+#include <utility>
+
+#include "vktut/vulkan/deletion_queue.hpp"
+
+vktut::vulkan::deletion_queue::deletion_queue(std::uint64_t frames_in_flight)
+    : m_frames_in_flight(frames_in_flight)
+{
+}
+
+vktut::vulkan::deletion_queue::~deletion_queue()
+{
+  flush();
+}
+
+void vktut::vulkan::deletion_queue::push(std::function<void()> destroy)
+{
+  m_entries.push_back(entry {
+      .frame = m_frame,
+      .destroy = std::move(destroy),
+  });
+}
+
+void vktut::vulkan::deletion_queue::collect()
+{
+  // the fence waited on belongs to the frame `frames_in_flight` back, fences
+  // are waited on in submission order so every frame before it is done too
+  while (!m_entries.empty()
+         && m_entries.front().frame + m_frames_in_flight <= m_frame)
+  {
+    auto destroy = std::move(m_entries.front().destroy);
+    m_entries.pop_front();
+    destroy();
+  }
+}
+
+void vktut::vulkan::deletion_queue::next_frame()
+{
+  ++m_frame;
+}
+
+void vktut::vulkan::deletion_queue::flush()
+{
+  while (!m_entries.empty()) {
+    auto destroy = std::move(m_entries.front().destroy);
+    m_entries.pop_front();
+    destroy();
+  }
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "vktut/vulkan/descriptor_allocator.hpp"
+
+vktut::vulkan::descriptor_allocator::descriptor_allocator(VkDevice device)
+    : m_device(device)
+    , m_current_pool(nullptr)
+{
+}
+
+vktut::vulkan::descriptor_allocator::~descriptor_allocator()
+{
+  destroy();
+}
+
+vktut::vulkan::descriptor_allocator::descriptor_allocator(
+    descriptor_allocator&& other) noexcept
+    : m_device(std::exchange(other.m_device, nullptr))
+    , m_current_pool(std::exchange(other.m_current_pool, nullptr))
+    , m_used_pools(std::move(other.m_used_pools))
+    , m_free_pools(std::move(other.m_free_pools))
+{
+}
+
+vktut::vulkan::descriptor_allocator&
+vktut::vulkan::descriptor_allocator::operator=(
+    descriptor_allocator&& other) noexcept
+{
+  if (this != &other) {
+    destroy();
+    m_device = std::exchange(other.m_device, nullptr);
+    m_current_pool = std::exchange(other.m_current_pool, nullptr);
+    m_used_pools = std::move(other.m_used_pools);
+    m_free_pools = std::move(other.m_free_pools);
+  }
+  return *this;
+}
+
+VkDescriptorSet vktut::vulkan::descriptor_allocator::allocate(
+    VkDescriptorSetLayout layout)
+{
+  if (m_current_pool == nullptr) {
+    m_current_pool = grab_pool();
+  }
+
+  VkDescriptorSetAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool = m_current_pool,
+      .descriptorSetCount = 1,
+      .pSetLayouts = &layout,
+  };
+
+  VkDescriptorSet descriptor_set = nullptr;
+  VkResult result =
+      vkAllocateDescriptorSets(m_device, &allocate_info, &descriptor_set);
+  if (result == VK_ERROR_OUT_OF_POOL_MEMORY
+      || result == VK_ERROR_FRAGMENTED_POOL)
+  {
+    // the current pool is exhausted, chain a fresh one and retry once
+    m_current_pool = grab_pool();
+    allocate_info.descriptorPool = m_current_pool;
+    result =
+        vkAllocateDescriptorSets(m_device, &allocate_info, &descriptor_set);
+  }
+
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error {"failed to allocate descriptor set!"};
+  }
+  return descriptor_set;
+}
+
+void vktut::vulkan::descriptor_allocator::reset()
+{
+  for (auto* pool : m_used_pools) {
+    vkResetDescriptorPool(m_device, pool, 0);
+  }
+  std::move(m_used_pools.begin(),
+            m_used_pools.end(),
+            std::back_inserter(m_free_pools));
+  m_used_pools.clear();
+  m_current_pool = nullptr;
+}
+
+VkDescriptorPool vktut::vulkan::descriptor_allocator::grab_pool()
+{
+  VkDescriptorPool pool = nullptr;
+  if (m_free_pools.empty()) {
+    pool = create_pool();
+  } else {
+    pool = m_free_pools.back();
+    m_free_pools.pop_back();
+  }
+  m_used_pools.push_back(pool);
+  return pool;
+}
+
+VkDescriptorPool vktut::vulkan::descriptor_allocator::create_pool()
+{
+  std::array<VkDescriptorPoolSize, pool_size_ratios.size()> pool_sizes {};
+  std::transform(pool_size_ratios.begin(),
+                 pool_size_ratios.end(),
+                 pool_sizes.begin(),
+                 [](const auto& ratio)
+                 {
+                   return VkDescriptorPoolSize {
+                       .type = ratio.type,
+                       .descriptorCount = static_cast<std::uint32_t>(
+                           ratio.descriptors_per_set
+                           * static_cast<float>(sets_per_pool)),
+                   };
+                 });
+
+  VkDescriptorPoolCreateInfo pool_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .flags = 0,
+      .maxSets = sets_per_pool,
+      .poolSizeCount = pool_sizes.size(),
+      .pPoolSizes = pool_sizes.data(),
+  };
+
+  VkDescriptorPool pool = nullptr;
+  if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &pool)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create descriptor pool!"};
+  }
+  return pool;
+}
+
+void vktut::vulkan::descriptor_allocator::destroy()
+{
+  for (auto* pool : m_used_pools) {
+    vkDestroyDescriptorPool(m_device, pool, nullptr);
+  }
+  for (auto* pool : m_free_pools) {
+    vkDestroyDescriptorPool(m_device, pool, nullptr);
+  }
+  m_used_pools.clear();
+  m_free_pools.clear();
+  m_current_pool = nullptr;
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "vktut/vulkan/descriptor_layout_cache.hpp"
+
+bool vktut::vulkan::descriptor_layout_cache::layout_key::operator==(
+    const layout_key& other) const
+{
+  return flags == other.flags && immutable_samplers == other.immutable_samplers
+      && std::equal(bindings.begin(),
+                    bindings.end(),
+                    other.bindings.begin(),
+                    other.bindings.end(),
+                    [](const auto& a, const auto& b)
+                    {
+                      return a.binding == b.binding
+                          && a.descriptorType == b.descriptorType
+                          && a.descriptorCount == b.descriptorCount
+                          && a.stageFlags == b.stageFlags
+                          && (a.pImmutableSamplers == nullptr)
+                          == (b.pImmutableSamplers == nullptr);
+                    });
+}
+
+std::size_t vktut::vulkan::descriptor_layout_cache::layout_key_hash::operator()(
+    const layout_key& key) const
+{
+  std::size_t seed = 0;
+  combine(seed, key.flags);
+  combine(seed, key.bindings.size());
+  for (const auto& binding : key.bindings) {
+    combine(seed, binding.binding);
+    combine(seed, binding.descriptorType);
+    combine(seed, binding.descriptorCount);
+    combine(seed, binding.stageFlags);
+    combine(seed, binding.pImmutableSamplers != nullptr ? 1 : 0);
+  }
+  for (auto sampler : key.immutable_samplers) {
+    combine(seed, std::hash<VkSampler> {}(sampler));
+  }
+  return seed;
+}
+
+void vktut::vulkan::descriptor_layout_cache::layout_key_hash::combine(
+    std::size_t& seed, std::uint64_t value)
+{
+  seed ^= std::hash<std::uint64_t> {}(value) + 0x9e3779b9 + (seed << 6U)
+      + (seed >> 2U);
+}
+
+vktut::vulkan::descriptor_layout_cache::descriptor_layout_cache(
+    VkDevice device)
+    : m_device(device)
+{
+}
+
+vktut::vulkan::descriptor_layout_cache::~descriptor_layout_cache()
+{
+  for (const auto& [key, layout] : m_layouts) {
+    vkDestroyDescriptorSetLayout(m_device, layout, nullptr);
+  }
+}
+
+VkDescriptorSetLayout vktut::vulkan::descriptor_layout_cache::get(
+    std::vector<VkDescriptorSetLayoutBinding> bindings,
+    VkDescriptorSetLayoutCreateFlags flags)
+{
+  // the same set of bindings listed in a different order is the same layout
+  std::sort(bindings.begin(),
+            bindings.end(),
+            [](const auto& a, const auto& b) { return a.binding < b.binding; });
+
+  std::vector<VkSampler> immutable_samplers;
+  for (const auto& binding : bindings) {
+    if (binding.pImmutableSamplers != nullptr) {
+      immutable_samplers.insert(
+          immutable_samplers.end(),
+          binding.pImmutableSamplers,
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+          binding.pImmutableSamplers + binding.descriptorCount);
+    }
+  }
+  layout_key key {
+      .flags = flags,
+      .bindings = std::move(bindings),
+      .immutable_samplers = std::move(immutable_samplers),
+  };
+  if (auto it = m_layouts.find(key); it != m_layouts.end()) {
+    return it->second;
+  }
+
+  VkDescriptorSetLayoutCreateInfo layout_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .flags = flags,
+      .bindingCount = static_cast<std::uint32_t>(key.bindings.size()),
+      .pBindings = key.bindings.data(),
+  };
+
+  VkDescriptorSetLayout layout = nullptr;
+  if (vkCreateDescriptorSetLayout(m_device, &layout_info, nullptr, &layout)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create descriptor set layout!"};
+  }
+
+  m_layouts.emplace(std::move(key), layout);
+  return layout;
+}
@@ -0,0 +1,711 @@
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "vktut/vulkan/device_context.hpp"
+
+#include <stb_image.h>
+
+vktut::vulkan::device_context::device_context(
+    std::shared_ptr<instance> instance)
+    : m_instance(std::move(instance))
+    , m_physical_device(nullptr)
+    , m_device(nullptr)
+    , m_graphics_family(0)
+    , m_graphics_queues(nullptr)
+    , m_pipeline_cache(nullptr)
+    , m_layout_cache(nullptr)
+    , m_upload_command_pool(nullptr)
+{
+  pick_physical_device();
+  create_logical_device();
+
+  VkPipelineCacheCreateInfo cache_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+  };
+  if (vkCreatePipelineCache(m_device, &cache_info, nullptr, &m_pipeline_cache)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create pipeline cache!"};
+  }
+
+  m_layout_cache = std::make_unique<descriptor_layout_cache>(m_device);
+
+  VkCommandPoolCreateInfo pool_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+      .queueFamilyIndex = m_graphics_family,
+  };
+  if (vkCreateCommandPool(
+          m_device, &pool_info, nullptr, &m_upload_command_pool)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create command pool!"};
+  }
+}
+
+vktut::vulkan::device_context::~device_context()
+{
+  vkDeviceWaitIdle(m_device);
+
+  for (const auto& [key, sampler] : m_samplers) {
+    vkDestroySampler(m_device, sampler, nullptr);
+  }
+  m_layout_cache.reset();
+  vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
+  vkDestroyCommandPool(m_device, m_upload_command_pool, nullptr);
+  m_graphics_queues.reset();
+  vkDestroyDevice(m_device, nullptr);
+}
+
+VkPhysicalDevice vktut::vulkan::device_context::physical_device() const
+{
+  return m_physical_device;
+}
+
+VkDevice vktut::vulkan::device_context::device() const
+{
+  return m_device;
+}
+
+std::uint32_t vktut::vulkan::device_context::graphics_family() const
+{
+  return m_graphics_family;
+}
+
+VkPipelineCache vktut::vulkan::device_context::pipeline_cache() const
+{
+  return m_pipeline_cache;
+}
+
+vktut::vulkan::queue_pool& vktut::vulkan::device_context::graphics_queues()
+{
+  return *m_graphics_queues;
+}
+
+VkDescriptorSetLayout vktut::vulkan::device_context::descriptor_set_layout(
+    std::vector<VkDescriptorSetLayoutBinding> bindings)
+{
+  std::lock_guard lock {m_cache_mutex};
+  return m_layout_cache->get(std::move(bindings));
+}
+
+VkSampler vktut::vulkan::device_context::sampler(
+    VkFilter filter, VkSamplerAddressMode address_mode)
+{
+  std::lock_guard lock {m_cache_mutex};
+  auto key = std::pair {filter, address_mode};
+  if (auto found = m_samplers.find(key); found != m_samplers.end()) {
+    return found->second;
+  }
+
+  VkSamplerCreateInfo sampler_info = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = filter,
+      .minFilter = filter,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+      .addressModeU = address_mode,
+      .addressModeV = address_mode,
+      .addressModeW = address_mode,
+      .mipLodBias = 0,
+      .anisotropyEnable = VK_FALSE,
+      .maxAnisotropy = 1,
+      .compareEnable = VK_FALSE,
+      .compareOp = VK_COMPARE_OP_ALWAYS,
+      .minLod = 0,
+      .maxLod = VK_LOD_CLAMP_NONE,
+      .borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
+      .unnormalizedCoordinates = VK_FALSE,
+  };
+
+  VkSampler sampler = nullptr;
+  if (vkCreateSampler(m_device, &sampler_info, nullptr, &sampler)
+      != VK_SUCCESS) {
+    throw std::runtime_error {"failed to create texture sampler!"};
+  }
+  m_samplers.emplace(key, sampler);
+  return sampler;
+}
+
+vktut::vulkan::texture vktut::vulkan::device_context::create_texture(
+    std::span<const std::byte> file_bytes)
+{
+  int tex_width = 0;
+  int tex_height = 0;
+  int tex_channels = 0;
+  stbi_uc* pixels = stbi_load_from_memory(
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      reinterpret_cast<const stbi_uc*>(file_bytes.data()),
+      static_cast<int>(file_bytes.size()),
+      &tex_width,
+      &tex_height,
+      &tex_channels,
+      STBI_rgb_alpha);
+  if (pixels == nullptr) {
+    throw std::runtime_error {"failed to load texture image!"};
+  }
+  auto image_size = static_cast<VkDeviceSize>(tex_width)
+      * static_cast<VkDeviceSize>(tex_height) * 4;
+
+  auto staging = create_buffer(image_size,
+                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  void* data = nullptr;
+  vkMapMemory(m_device, staging.memory, 0, image_size, 0, &data);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  std::copy(pixels, &pixels[image_size], static_cast<stbi_uc*>(data));
+  vkUnmapMemory(m_device, staging.memory);
+  stbi_image_free(pixels);
+
+  VkExtent2D extent = {
+      .width = static_cast<std::uint32_t>(tex_width),
+      .height = static_cast<std::uint32_t>(tex_height),
+  };
+  // the same chain the windowed renderer builds, the material shaders sample
+  // both alike
+  auto mip_levels = static_cast<std::uint32_t>(
+      std::bit_width(std::max(extent.width, extent.height)));
+  auto image = create_image(extent,
+                            VK_FORMAT_R8G8B8A8_SRGB,
+                            VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                                | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+                                | VK_IMAGE_USAGE_SAMPLED_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            mip_levels);
+
+  std::lock_guard lock {m_cache_mutex};
+  VkCommandBuffer command_buffer = begin_upload();
+  VkImageMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = 0,
+      .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = image.image,
+      .subresourceRange =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .baseMipLevel = 0,
+              .levelCount = mip_levels,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+  };
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &barrier);
+
+  VkBufferImageCopy region = {
+      .bufferOffset = 0,
+      .bufferRowLength = 0,
+      .bufferImageHeight = 0,
+      .imageSubresource =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .mipLevel = 0,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+      .imageOffset = {0, 0, 0},
+      .imageExtent = {extent.width, extent.height, 1},
+  };
+  vkCmdCopyBufferToImage(command_buffer,
+                         staging.buffer,
+                         image.image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         1,
+                         &region);
+  record_mipmaps(command_buffer,
+                 image.image,
+                 VK_FORMAT_R8G8B8A8_SRGB,
+                 extent,
+                 mip_levels);
+  end_upload(command_buffer);
+  destroy_buffer(staging);
+
+  return texture {
+      .image = image.image,
+      .memory = image.memory,
+      .view = create_image_view(image.image,
+                                VK_FORMAT_R8G8B8A8_SRGB,
+                                VK_IMAGE_ASPECT_COLOR_BIT,
+                                mip_levels),
+      .mip_levels = mip_levels,
+  };
+}
+
+vktut::vulkan::buffer_and_memory vktut::vulkan::device_context::upload_buffer(
+    std::span<const std::byte> data, VkBufferUsageFlags usage)
+{
+  auto staging = create_buffer(data.size(),
+                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  void* mapped = nullptr;
+  vkMapMemory(m_device, staging.memory, 0, data.size(), 0, &mapped);
+  std::copy(data.begin(), data.end(), static_cast<std::byte*>(mapped));
+  vkUnmapMemory(m_device, staging.memory);
+
+  auto buffer = create_buffer(data.size(),
+                              VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+  std::lock_guard lock {m_cache_mutex};
+  VkCommandBuffer command_buffer = begin_upload();
+  VkBufferCopy copy_region = {
+      .srcOffset = 0,
+      .dstOffset = 0,
+      .size = data.size(),
+  };
+  vkCmdCopyBuffer(
+      command_buffer, staging.buffer, buffer.buffer, 1, &copy_region);
+  end_upload(command_buffer);
+  destroy_buffer(staging);
+  return buffer;
+}
+
+void vktut::vulkan::device_context::destroy_texture(
+    const texture& texture) const
+{
+  vkDestroyImageView(m_device, texture.view, nullptr);
+  vkDestroyImage(m_device, texture.image, nullptr);
+  vkFreeMemory(m_device, texture.memory, nullptr);
+}
+
+void vktut::vulkan::device_context::destroy_buffer(
+    const buffer_and_memory& buffer) const
+{
+  vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+  vkFreeMemory(m_device, buffer.memory, nullptr);
+}
+
+void vktut::vulkan::device_context::submit_and_wait(
+    VkCommandBuffer command_buffer, VkFence fence)
+{
+  VkSubmitInfo submit_info = {
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &command_buffer,
+  };
+
+  {
+    auto queue = m_graphics_queues->acquire();
+    if (vkQueueSubmit(queue.get(), 1, &submit_info, fence) != VK_SUCCESS) {
+      throw std::runtime_error {"failed to submit command buffer!"};
+    }
+    // without a fence there is nothing else to wait on, so the queue stays
+    // leased until it is idle
+    if (fence == VK_NULL_HANDLE) {
+      vkQueueWaitIdle(queue.get());
+      return;
+    }
+  }
+
+  // the queue is already free for other threads while this one waits
+  vkWaitForFences(
+      m_device, 1, &fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+  vkResetFences(m_device, 1, &fence);
+}
+
+std::uint32_t vktut::vulkan::device_context::find_memory_type(
+    std::uint32_t type_filter, VkMemoryPropertyFlags properties) const
+{
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
+
+  for (std::uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+    auto flags = memory_properties.memoryTypes[i].propertyFlags;
+    if ((type_filter & (1U << i)) != 0U && (flags & properties) == properties)
+    {
+      return i;
+    }
+  }
+
+  throw std::runtime_error {"failed to find suitable memory type!"};
+}
+
+vktut::vulkan::buffer_and_memory vktut::vulkan::device_context::create_buffer(
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags properties) const
+{
+  VkBufferCreateInfo buffer_info = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+      .size = size,
+      .usage = usage,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+  };
+
+  VkBuffer buffer = nullptr;
+  if (vkCreateBuffer(m_device, &buffer_info, nullptr, &buffer) != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create buffer!"};
+  }
+
+  VkMemoryRequirements memory_requirements;
+  vkGetBufferMemoryRequirements(m_device, buffer, &memory_requirements);
+
+  VkMemoryAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .allocationSize = memory_requirements.size,
+      .memoryTypeIndex =
+          find_memory_type(memory_requirements.memoryTypeBits, properties),
+  };
+
+  VkDeviceMemory memory = nullptr;
+  if (vkAllocateMemory(m_device, &allocate_info, nullptr, &memory)
+      != VK_SUCCESS) {
+    throw std::runtime_error {"failed to allocate buffer memory!"};
+  }
+
+  vkBindBufferMemory(m_device, buffer, memory, 0);
+  return buffer_and_memory {
+      .buffer = buffer,
+      .memory = memory,
+  };
+}
+
+vktut::vulkan::image_and_memory vktut::vulkan::device_context::create_image(
+    VkExtent2D extent,
+    VkFormat format,
+    VkImageUsageFlags usage,
+    VkMemoryPropertyFlags properties,
+    std::uint32_t mip_levels) const
+{
+  VkImageCreateInfo image_info = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+      .flags = 0,
+      .imageType = VK_IMAGE_TYPE_2D,
+      .format = format,
+      .extent =
+          {
+              .width = extent.width,
+              .height = extent.height,
+              .depth = 1,
+          },
+      .mipLevels = mip_levels,
+      .arrayLayers = 1,
+      .samples = VK_SAMPLE_COUNT_1_BIT,
+      .tiling = VK_IMAGE_TILING_OPTIMAL,
+      .usage = usage,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+  };
+
+  VkImage image = nullptr;
+  if (vkCreateImage(m_device, &image_info, nullptr, &image) != VK_SUCCESS) {
+    throw std::runtime_error {"failed to create image!"};
+  }
+
+  VkMemoryRequirements memory_requirements;
+  vkGetImageMemoryRequirements(m_device, image, &memory_requirements);
+
+  VkMemoryAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .allocationSize = memory_requirements.size,
+      .memoryTypeIndex =
+          find_memory_type(memory_requirements.memoryTypeBits, properties),
+  };
+
+  VkDeviceMemory memory = nullptr;
+  if (vkAllocateMemory(m_device, &allocate_info, nullptr, &memory)
+      != VK_SUCCESS) {
+    throw std::runtime_error {"failed to allocate image memory!"};
+  }
+
+  vkBindImageMemory(m_device, image, memory, 0);
+  return image_and_memory {
+      .image = image,
+      .memory = memory,
+      .size = memory_requirements.size,
+      .lazily_allocated = false,
+  };
+}
+
+VkImageView vktut::vulkan::device_context::create_image_view(
+    VkImage image,
+    VkFormat format,
+    VkImageAspectFlags aspect_flags,
+    std::uint32_t mip_levels) const
+{
+  VkImageViewCreateInfo view_info = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+      .image = image,
+      .viewType = VK_IMAGE_VIEW_TYPE_2D,
+      .format = format,
+      .components =
+          {
+              .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+              .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+              .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+              .a = VK_COMPONENT_SWIZZLE_IDENTITY,
+          },
+      .subresourceRange =
+          {
+              .aspectMask = aspect_flags,
+              .baseMipLevel = 0,
+              .levelCount = mip_levels,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+  };
+
+  VkImageView image_view = nullptr;
+  if (vkCreateImageView(m_device, &view_info, nullptr, &image_view)
+      != VK_SUCCESS) {
+    throw std::runtime_error {"failed to create texture image view!"};
+  }
+  return image_view;
+}
+
+void vktut::vulkan::device_context::pick_physical_device()
+{
+  std::uint32_t device_count = 0;
+  vkEnumeratePhysicalDevices(m_instance->get(), &device_count, nullptr);
+  if (device_count == 0) {
+    throw std::runtime_error {"no physical devices with Vulkan support found!"};
+  }
+  std::vector<VkPhysicalDevice> devices;
+  devices.resize(device_count);
+  vkEnumeratePhysicalDevices(m_instance->get(), &device_count, devices.data());
+
+  // nothing is presented, so any device with a graphics queue will do. a
+  // discrete gpu wins when there is one
+  int best_score = 0;
+  for (auto* device : devices) {
+    std::uint32_t family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> families;
+    families.resize(family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        device, &family_count, families.data());
+    auto graphics = std::find_if(
+        families.begin(),
+        families.end(),
+        [](const auto& family)
+        { return (family.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0U; });
+    if (graphics == families.end()) {
+      continue;
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+    int score =
+        properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU ? 2 : 1;
+    if (score > best_score) {
+      best_score = score;
+      m_physical_device = device;
+      m_graphics_family =
+          static_cast<std::uint32_t>(std::distance(families.begin(), graphics));
+    }
+  }
+
+  if (m_physical_device == nullptr) {
+    throw std::runtime_error {"no suitable devices found!"};
+  }
+}
+
+void vktut::vulkan::device_context::create_logical_device()
+{
+  std::uint32_t family_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      m_physical_device, &family_count, nullptr);
+  std::vector<VkQueueFamilyProperties> families;
+  families.resize(family_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      m_physical_device, &family_count, families.data());
+
+  // every queue the family has, so that many renderers can submit at once
+  std::uint32_t queue_count = families[m_graphics_family].queueCount;
+  std::vector<float> queue_priorities(queue_count, 1.0F);
+  VkDeviceQueueCreateInfo queue_create_info = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+      .queueFamilyIndex = m_graphics_family,
+      .queueCount = queue_count,
+      .pQueuePriorities = queue_priorities.data(),
+  };
+
+  VkPhysicalDeviceFeatures device_features = {};
+  VkDeviceCreateInfo create_info = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+      .queueCreateInfoCount = 1,
+      .pQueueCreateInfos = &queue_create_info,
+      .enabledExtensionCount = 0,
+      .pEnabledFeatures = &device_features,
+  };
+
+  if (vkCreateDevice(m_physical_device, &create_info, nullptr, &m_device)
+      != VK_SUCCESS)
+  {
+    throw std::runtime_error {"failed to create logical device!"};
+  }
+
+  m_graphics_queues =
+      std::make_unique<queue_pool>(m_device, m_graphics_family, queue_count);
+  std::cout << "[vktut::vulkan::device_context::create_logical_device()] "
+            << queue_count << " graphics queues\n";
+}
+
+VkCommandBuffer vktut::vulkan::device_context::begin_upload()
+{
+  VkCommandBufferAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = m_upload_command_pool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+  VkCommandBuffer command_buffer = nullptr;
+  vkAllocateCommandBuffers(m_device, &allocate_info, &command_buffer);
+  VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  vkBeginCommandBuffer(command_buffer, &begin_info);
+  return command_buffer;
+}
+
+void vktut::vulkan::device_context::end_upload(VkCommandBuffer command_buffer)
+{
+  vkEndCommandBuffer(command_buffer);
+  submit_and_wait(command_buffer, VK_NULL_HANDLE);
+  vkFreeCommandBuffers(m_device, m_upload_command_pool, 1, &command_buffer);
+}
+
+void vktut::vulkan::device_context::record_mipmaps(
+    VkCommandBuffer command_buffer,
+    VkImage image,
+    VkFormat format,
+    VkExtent2D extent,
+    std::uint32_t mip_levels) const
+{
+  VkFormatProperties format_properties;
+  vkGetPhysicalDeviceFormatProperties(
+      m_physical_device, format, &format_properties);
+  if ((format_properties.optimalTilingFeatures
+       & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+      == 0U)
+  {
+    throw std::runtime_error {
+        "texture image format does not support linear blitting!"};
+  }
+
+  VkImageMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = image,
+      .subresourceRange =
+          {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .levelCount = 1,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+  };
+
+  auto mip_width = static_cast<std::int32_t>(extent.width);
+  auto mip_height = static_cast<std::int32_t>(extent.height);
+  for (std::uint32_t i = 1; i < mip_levels; ++i) {
+    barrier.subresourceRange.baseMipLevel = i - 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &barrier);
+
+    std::int32_t next_width = mip_width > 1 ? mip_width / 2 : 1;
+    std::int32_t next_height = mip_height > 1 ? mip_height / 2 : 1;
+    VkImageBlit blit = {
+        .srcSubresource =
+            {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = i - 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        .srcOffsets =
+            {
+                {0, 0, 0},
+                {mip_width, mip_height, 1},
+            },
+        .dstSubresource =
+            {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = i,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        .dstOffsets =
+            {
+                {0, 0, 0},
+                {next_width, next_height, 1},
+            },
+    };
+    vkCmdBlitImage(command_buffer,
+                   image,
+                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   image,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   1,
+                   &blit,
+                   VK_FILTER_LINEAR);
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &barrier);
+
+    mip_width = next_width;
+    mip_height = next_height;
+  }
+
+  // the last level was only ever written
+  barrier.subresourceRange.baseMipLevel = mip_levels - 1;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &barrier);
+}
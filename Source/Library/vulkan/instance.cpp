@@ -24,10 +24,15 @@ std::vector<const char*> vktut::vulkan::instance::get_required_extensions(
   const char** glfw_extensions =
       glfwGetRequiredInstanceExtensions(&glfw_extension_count);
 
-  std::vector<const char*> extensions = {
-      glfw_extensions,
-      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-      &glfw_extensions[glfw_extension_count]};
+  // glfw reports nothing when it isn't initialized, as for headless
+  // renderers, which need no surface extensions anyway
+  std::vector<const char*> extensions;
+  if (glfw_extensions != nullptr) {
+    extensions.assign(
+        glfw_extensions,
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        &glfw_extensions[glfw_extension_count]);
+  }
 
   if (enable_validation_layers) {
     extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
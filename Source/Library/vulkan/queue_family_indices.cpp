@@ -47,6 +47,34 @@ vktut::vulkan::queue_family_indices vktut::vulkan::queue_family_indices::find(
         static_cast<std::uint32_t>(transfer_family - queue_families.begin());
   }
 
+  // a compute family of its own is best. the transfer family found above is
+  // often a compute family as well, it is only shared when it has a second
+  // queue, its first one stays with uploads
+  auto is_compute_only = [](const auto& queue_family)
+  {
+    return (queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT) != 0
+        && (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0;
+  };
+  for (std::uint32_t i = 0; i < queue_families.size(); ++i) {
+    if (is_compute_only(queue_families[i]) && i != indices.transfer_family) {
+      indices.compute_family = i;
+      break;
+    }
+  }
+  if (!indices.compute_family && indices.transfer_family
+      && is_compute_only(queue_families[*indices.transfer_family])
+      && queue_families[*indices.transfer_family].queueCount > 1)
+  {
+    indices.compute_family = indices.transfer_family;
+    indices.compute_queue_index = 1;
+  }
+  if (!indices.compute_family && indices.graphics_family
+      && queue_families[*indices.graphics_family].queueCount > 1)
+  {
+    indices.compute_family = indices.graphics_family;
+    indices.compute_queue_index = 1;
+  }
+
   return indices;
 }
 
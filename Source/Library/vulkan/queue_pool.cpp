@@ -0,0 +1,68 @@
+#include <utility>
+
+#include "vktut/vulkan/queue_pool.hpp"
+
+vktut::vulkan::queue_pool::lease::lease(queue_pool& pool, VkQueue queue)
+    : m_pool(&pool)
+    , m_queue(queue)
+{
+}
+
+vktut::vulkan::queue_pool::lease::~lease()
+{
+  if (m_pool != nullptr) {
+    m_pool->release(m_queue);
+  }
+}
+
+vktut::vulkan::queue_pool::lease::lease(lease&& other) noexcept
+    : m_pool(std::exchange(other.m_pool, nullptr))
+    , m_queue(std::exchange(other.m_queue, nullptr))
+{
+}
+
+vktut::vulkan::queue_pool::lease& vktut::vulkan::queue_pool::lease::operator=(
+    lease&& other) noexcept
+{
+  if (this != &other) {
+    if (m_pool != nullptr) {
+      m_pool->release(m_queue);
+    }
+    m_pool = std::exchange(other.m_pool, nullptr);
+    m_queue = std::exchange(other.m_queue, nullptr);
+  }
+  return *this;
+}
+
+VkQueue vktut::vulkan::queue_pool::lease::get() const
+{
+  return m_queue;
+}
+
+vktut::vulkan::queue_pool::queue_pool(VkDevice device,
+                                      std::uint32_t family_index,
+                                      std::uint32_t queue_count)
+{
+  m_free_queues.resize(queue_count);
+  for (std::uint32_t i = 0; i < queue_count; ++i) {
+    vkGetDeviceQueue(device, family_index, i, &m_free_queues[i]);
+  }
+}
+
+vktut::vulkan::queue_pool::lease vktut::vulkan::queue_pool::acquire()
+{
+  std::unique_lock lock {m_mutex};
+  m_released.wait(lock, [this] { return !m_free_queues.empty(); });
+  VkQueue queue = m_free_queues.back();
+  m_free_queues.pop_back();
+  return lease {*this, queue};
+}
+
+void vktut::vulkan::queue_pool::release(VkQueue queue)
+{
+  {
+    std::lock_guard lock {m_mutex};
+    m_free_queues.push_back(queue);
+  }
+  m_released.notify_one();
+}
@@ -0,0 +1,192 @@
+#include <stdexcept>
+
+#include "vktut/vulkan/readback_ring.hpp"
+
+vktut::vulkan::readback_ring::readback_ring(VkDevice device,
+                                            VkPhysicalDevice physical_device,
+                                            VkBufferUsageFlags usage,
+                                            std::size_t slot_count)
+    : m_device(device)
+    , m_physical_device(physical_device)
+    , m_usage(usage)
+    , m_slots(slot_count)
+{
+  m_free_slots.reserve(slot_count);
+  for (std::size_t i = 0; i < slot_count; ++i) {
+    m_free_slots.push_back(slot_count - 1 - i);
+  }
+}
+
+vktut::vulkan::readback_ring::~readback_ring()
+{
+  for (auto& slot : m_slots) {
+    destroy(slot);
+  }
+}
+
+std::optional<std::size_t> vktut::vulkan::readback_ring::acquire(
+    std::size_t frame_index, VkDeviceSize size)
+{
+  std::size_t slot_index = 0;
+  {
+    std::lock_guard lock {m_mutex};
+    if (m_free_slots.empty()) {
+      return std::nullopt;
+    }
+    slot_index = m_free_slots.back();
+    m_free_slots.pop_back();
+  }
+
+  auto& slot = m_slots[slot_index];
+  reserve(slot, size);
+  slot.frame_index = frame_index;
+  m_pending_slots.push_back(slot_index);
+  return slot_index;
+}
+
+VkBuffer vktut::vulkan::readback_ring::buffer(std::size_t slot_index) const
+{
+  return m_slots[slot_index].buffer;
+}
+
+const std::byte* vktut::vulkan::readback_ring::data(
+    std::size_t slot_index) const
+{
+  return m_slots[slot_index].mapped;
+}
+
+std::vector<std::size_t> vktut::vulkan::readback_ring::complete(
+    std::size_t frame_index)
+{
+  // frames complete in submission order, so only the front can be done
+  std::vector<std::size_t> completed;
+  while (!m_pending_slots.empty()
+         && m_slots[m_pending_slots.front()].frame_index == frame_index)
+  {
+    invalidate(m_slots[m_pending_slots.front()]);
+    completed.push_back(m_pending_slots.front());
+    m_pending_slots.pop_front();
+  }
+  return completed;
+}
+
+std::vector<std::size_t> vktut::vulkan::readback_ring::complete_all()
+{
+  std::vector<std::size_t> completed {m_pending_slots.begin(),
+                                      m_pending_slots.end()};
+  for (auto slot_index : completed) {
+    invalidate(m_slots[slot_index]);
+  }
+  m_pending_slots.clear();
+  return completed;
+}
+
+void vktut::vulkan::readback_ring::release(std::size_t slot_index)
+{
+  std::lock_guard lock {m_mutex};
+  m_free_slots.push_back(slot_index);
+}
+
+void vktut::vulkan::readback_ring::reserve(slot& slot, VkDeviceSize size)
+{
+  if (slot.capacity >= size) {
+    return;
+  }
+  destroy(slot);
+
+  VkBufferCreateInfo buffer_info = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+      .size = size,
+      .usage = m_usage,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+  };
+  if (vkCreateBuffer(m_device, &buffer_info, nullptr, &slot.buffer)
+      != VK_SUCCESS) {
+    throw std::runtime_error {"failed to create readback buffer!"};
+  }
+
+  VkMemoryRequirements memory_requirements;
+  vkGetBufferMemoryRequirements(m_device, slot.buffer, &memory_requirements);
+
+  // the host reads every byte, cached memory makes that much faster than the
+  // write-combined kind
+  auto memory_type =
+      find_memory_type(memory_requirements.memoryTypeBits,
+                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                           | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+  if (!memory_type) {
+    memory_type =
+        find_memory_type(memory_requirements.memoryTypeBits,
+                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                             | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  }
+  if (!memory_type) {
+    throw std::runtime_error {"failed to find suitable memory type!"};
+  }
+
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+  slot.coherent = (memory_properties.memoryTypes[*memory_type].propertyFlags
+                   & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+      != 0U;
+
+  VkMemoryAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .allocationSize = memory_requirements.size,
+      .memoryTypeIndex = *memory_type,
+  };
+  if (vkAllocateMemory(m_device, &allocate_info, nullptr, &slot.memory)
+      != VK_SUCCESS) {
+    throw std::runtime_error {"failed to allocate readback buffer memory!"};
+  }
+  vkBindBufferMemory(m_device, slot.buffer, slot.memory, 0);
+
+  // mapped for as long as the buffer lives
+  void* mapped = nullptr;
+  vkMapMemory(m_device, slot.memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+  slot.mapped = static_cast<const std::byte*>(mapped);
+  slot.capacity = size;
+}
+
+void vktut::vulkan::readback_ring::destroy(slot& slot)
+{
+  if (slot.buffer == nullptr) {
+    return;
+  }
+  vkUnmapMemory(m_device, slot.memory);
+  vkDestroyBuffer(m_device, slot.buffer, nullptr);
+  vkFreeMemory(m_device, slot.memory, nullptr);
+  slot = {};
+}
+
+void vktut::vulkan::readback_ring::invalidate(const slot& slot)
+{
+  if (slot.coherent) {
+    return;
+  }
+  VkMappedMemoryRange range = {
+      .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+      .memory = slot.memory,
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  };
+  vkInvalidateMappedMemoryRanges(m_device, 1, &range);
+}
+
+std::optional<std::uint32_t> vktut::vulkan::readback_ring::find_memory_type(
+    std::uint32_t type_filter, VkMemoryPropertyFlags properties) const
+{
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
+
+  for (std::uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+    auto flags = memory_properties.memoryTypes[i].propertyFlags;
+    if ((type_filter & (1U << i)) != 0U && (flags & properties) == properties)
+    {
+      return i;
+    }
+  }
+  return std::nullopt;
+}